@@ -139,7 +139,7 @@ HttpGet::~HttpGet ()
 }
 
 char*
-HttpGet::get (const char* url)
+HttpGet::get (const char* url, bool with_error_logging)
 {
 	_status = _result = -1;
 	if (!_curl || !url) {
@@ -162,11 +162,15 @@ HttpGet::get (const char* url)
 	curl_easy_getinfo (_curl, CURLINFO_RESPONSE_CODE, &_status);
 
 	if (_result) {
-		PBD::error << string_compose (_("HTTP request failed: (%1) %2"), _result, error_buffer);
+		if (with_error_logging) {
+			PBD::error << string_compose (_("HTTP request failed: (%1) %2"), _result, error_buffer);
+		}
 		return NULL;
 	}
 	if (_status != 200) {
-		PBD::error << string_compose (_("HTTP request status: %1"), _status);
+		if (with_error_logging) {
+			PBD::error << string_compose (_("HTTP request status: %1"), _status);
+		}
 		return NULL;
 	}
 
@@ -35,10 +35,13 @@ class HttpGet {
 		size_t size;
 	};
 
-	char* get (const char* url);
+	/** @param with_error_logging if false, failures are only reported via
+	 * status() and error(), e.g. for requests that are retried
+	 */
+	char* get (const char* url, bool with_error_logging = true);
 
-	std::string get (const std::string& url) {
-		char *rv = get (url.c_str ());
+	std::string get (const std::string& url, bool with_error_logging = true) {
+		char *rv = get (url.c_str (), with_error_logging);
 		return rv ? std::string (rv) : std::string ("");
 	}
 
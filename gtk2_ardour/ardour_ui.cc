@@ -1295,6 +1295,8 @@ If you still wish to quit, please use the\n\n\
 		_session = 0;
 	}
 
+	ProcessorEntry::stop_inline_display_thread ();
+
 	halt_connection.disconnect ();
 	AudioEngine::instance()->stop ();
 #ifdef WINDOWS_VST_SUPPORT
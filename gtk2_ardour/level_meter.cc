@@ -134,11 +134,16 @@ LevelMeterBase::update_meters ()
 		return 0.0f;
 	}
 
-	uint32_t nmidi = _meter->input_streams().n_midi();
+	/* one consistent copy of all channels, rather than a call per meter */
+	if (!_meter->snapshot (_snapshot)) {
+		return max_peak;
+	}
+
+	const uint32_t nmidi = _snapshot.n_midi;
 
 	for (n = 0, i = meters.begin(); i != meters.end(); ++i, ++n) {
 		if ((*i).packed) {
-			const float mpeak = _meter->meter_level(n, MeterMaxPeak);
+			const float mpeak = _snapshot.value (n, MeterMaxPeak);
 			if (mpeak > (*i).max_peak) {
 				(*i).max_peak = mpeak;
 				(*i).meter->set_highlight(mpeak >= UIConfiguration::instance().get_meter_peak());
@@ -148,9 +153,10 @@ LevelMeterBase::update_meters ()
 			}
 
 			if (n < nmidi) {
-				(*i).meter->set (_meter->meter_level (n, MeterPeak));
+				(*i).meter->set (_snapshot.value (n, MeterPeak));
 			} else {
-				const float peak = _meter->meter_level (n, meter_type);
+				const float peak = _snapshot.value (n, meter_type);
+				const float dpm = _snapshot.value (n, MeterPeak);
 				if (meter_type == MeterPeak) {
 					(*i).meter->set (log_meter (peak));
 				} else if (meter_type == MeterPeak0dB) {
@@ -164,13 +170,13 @@ LevelMeterBase::update_meters ()
 				} else if (meter_type == MeterVU) {
 					(*i).meter->set (meter_deflect_vu (peak + vu_standard() + meter_lineup(0)));
 				} else if (meter_type == MeterK12) {
-					(*i).meter->set (meter_deflect_k (peak, 12), meter_deflect_k(_meter->meter_level(n, MeterPeak), 12));
+					(*i).meter->set (meter_deflect_k (peak, 12), meter_deflect_k (dpm, 12));
 				} else if (meter_type == MeterK14) {
-					(*i).meter->set (meter_deflect_k (peak, 14), meter_deflect_k(_meter->meter_level(n, MeterPeak), 14));
+					(*i).meter->set (meter_deflect_k (peak, 14), meter_deflect_k (dpm, 14));
 				} else if (meter_type == MeterK20) {
-					(*i).meter->set (meter_deflect_k (peak, 20), meter_deflect_k(_meter->meter_level(n, MeterPeak), 20));
+					(*i).meter->set (meter_deflect_k (peak, 20), meter_deflect_k (dpm, 20));
 				} else { // RMS
-					(*i).meter->set (log_meter (peak), log_meter(_meter->meter_level(n, MeterPeak)));
+					(*i).meter->set (log_meter (peak), log_meter (dpm));
 				}
 			}
 		}
@@ -32,6 +32,7 @@
 
 #include "ardour/types.h"
 #include "ardour/chan_count.h"
+#include "ardour/meter.h"
 #include "ardour/session_handle.h"
 
 #include <gtkmm2ext/click_box.h>
@@ -43,7 +44,6 @@
 
 namespace ARDOUR {
 	class Session;
-	class PeakMeter;
 }
 namespace Gtk {
 	class Menu;
@@ -82,6 +82,7 @@ class LevelMeterBase : public ARDOUR::SessionHandlePtr, virtual public sigc::tra
   private:
 	PBD::EventLoop::InvalidationRecord* parent_invalidator;
 	ARDOUR::PeakMeter* _meter;
+	ARDOUR::PeakMeter::Snapshot _snapshot;
 	Gtkmm2ext::FastMeter::Orientation _meter_orientation;
 
 	Width _width;
@@ -28,6 +28,7 @@
 #include <sigc++/bind.h>
 
 #include "pbd/convert.h"
+#include "pbd/pthread_utils.h"
 #include "canvas/utils.h"
 
 #include <glibmm/miscutils.h>
@@ -84,6 +85,7 @@
 #include "send_ui.h"
 #include "timers.h"
 #include "tooltips.h"
+#include "ui_config.h"
 #include "new_plugin_preset_dialog.h"
 
 #include "pbd/i18n.h"
@@ -1508,6 +1510,43 @@ ProcessorEntry::RoutingIcon::expose_output_map (cairo_t* cr, const double width,
 	}
 }
 
+/** State shared between a PluginDisplay and the render thread */
+struct ProcessorEntry::PluginDisplay::RenderRequest {
+	RenderRequest (PluginDisplay* d)
+		: display (d)
+		, queued (false)
+		, width (0)
+		, surf (0)
+		, height (0)
+	{}
+
+	~RenderRequest () {
+		if (surf) {
+			cairo_surface_destroy (surf);
+		}
+	}
+
+	/** held by the render thread while rendering */
+	Glib::Threads::Mutex render_lock;
+	/** 0 once the display no longer wants to be rendered, protected by render_lock */
+	PluginDisplay* display;
+
+	/** protected by render_queue_lock */
+	bool queued;
+
+	/* protected by result_lock */
+	Glib::Threads::Mutex result_lock;
+	uint32_t width;
+	cairo_surface_t* surf;
+	uint32_t height;
+};
+
+Glib::Threads::Mutex   ProcessorEntry::PluginDisplay::render_queue_lock;
+Glib::Threads::Cond    ProcessorEntry::PluginDisplay::render_cond;
+Glib::Threads::Thread* ProcessorEntry::PluginDisplay::_render_thread = 0;
+bool                   ProcessorEntry::PluginDisplay::_render_thread_quit = false;
+std::list<boost::shared_ptr<ProcessorEntry::PluginDisplay::RenderRequest> > ProcessorEntry::PluginDisplay::render_queue;
+
 ProcessorEntry::PluginDisplay::PluginDisplay (ProcessorEntry& e, boost::shared_ptr<ARDOUR::Plugin> p, uint32_t max_height)
 	: _entry (e)
 	, _plug (p)
@@ -1515,12 +1554,19 @@ ProcessorEntry::PluginDisplay::PluginDisplay (ProcessorEntry& e, boost::shared_p
 	, _max_height (max_height)
 	, _cur_height (1)
 	, _scroll (false)
+	, _request (new RenderRequest (this))
+	, _display_surf (0)
+	, _display_height (0)
+	, _last_render (0)
+	, _render_on_map (false)
 {
 	set_name ("processor prefader");
 	add_events (Gdk::BUTTON_PRESS_MASK|Gdk::BUTTON_RELEASE_MASK);
 	_plug->DropReferences.connect (_death_connection, invalidator (*this), boost::bind (&PluginDisplay::plugin_going_away, this), gui_context());
 	_plug->QueueDraw.connect (_qdraw_connection, invalidator (*this),
-			boost::bind (&Gtk::Widget::queue_draw, this), gui_context ());
+			boost::bind (&PluginDisplay::queue_render, this), gui_context ());
+	RenderDone.connect (_render_done_connection, invalidator (*this),
+			boost::bind (&PluginDisplay::render_done, this), gui_context ());
 
 	std::string postfix = "";
 	if (_plug->has_editor()) {
@@ -1534,9 +1580,231 @@ ProcessorEntry::PluginDisplay::PluginDisplay (ProcessorEntry& e, boost::shared_p
 
 ProcessorEntry::PluginDisplay::~PluginDisplay ()
 {
+	cancel_render ();
+	_render_timeout.disconnect ();
+
 	if (_surf) {
 		cairo_surface_destroy (_surf);
 	}
+	if (_display_surf) {
+		cairo_surface_destroy (_display_surf);
+	}
+}
+
+void
+ProcessorEntry::PluginDisplay::cancel_render ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (render_queue_lock);
+		if (_request->queued) {
+			render_queue.remove (_request);
+			_request->queued = false;
+		}
+	}
+
+	/* wait for a render that is in progress */
+	Glib::Threads::Mutex::Lock lm (_request->render_lock);
+	_request->display = 0;
+}
+
+/** The plugin asked for a redraw: schedule a render, at most max-inline-display-fps per second */
+void
+ProcessorEntry::PluginDisplay::queue_render ()
+{
+	if (!is_mapped ()) {
+		/* nobody would see it */
+		_render_on_map = true;
+		return;
+	}
+
+	if (_render_timeout.connected ()) {
+		/* already scheduled */
+		return;
+	}
+
+	const gint64 interval = 1000000 / std::max (1u, UIConfiguration::instance().get_max_inline_display_fps ());
+	const gint64 wait = _last_render + interval - g_get_monotonic_time ();
+
+	if (wait > 0) {
+		_render_timeout = Glib::signal_timeout().connect (sigc::mem_fun (*this, &PluginDisplay::render_timeout), std::max ((gint64) 1, wait / 1000));
+		return;
+	}
+
+	render_timeout ();
+}
+
+bool
+ProcessorEntry::PluginDisplay::render_timeout ()
+{
+	const Gtk::Allocation a = get_allocation ();
+
+	if (a.get_width () <= 0) {
+		return false;
+	}
+
+	_last_render = g_get_monotonic_time ();
+
+	{
+		Glib::Threads::Mutex::Lock lm (_request->result_lock);
+		_request->width = a.get_width ();
+	}
+
+	start_render_thread ();
+
+	Glib::Threads::Mutex::Lock lm (render_queue_lock);
+	if (!_request->queued) {
+		_request->queued = true;
+		render_queue.push_back (_request);
+		render_cond.signal ();
+	}
+
+	return false;
+}
+
+void
+ProcessorEntry::PluginDisplay::on_map ()
+{
+	DrawingArea::on_map ();
+
+	if (_render_on_map) {
+		_render_on_map = false;
+		queue_render ();
+	}
+}
+
+/** Called in the render thread with the request's render_lock held */
+void
+ProcessorEntry::PluginDisplay::render (RenderRequest& req)
+{
+	uint32_t width;
+
+	{
+		Glib::Threads::Mutex::Lock lm (req.result_lock);
+		width = req.width;
+	}
+
+	cairo_surface_t* surf = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, _max_height);
+	cairo_t* cr = cairo_create (surf);
+	const uint32_t height = render_inline (cr, width);
+	cairo_destroy (cr);
+	cairo_surface_flush (surf);
+
+	{
+		Glib::Threads::Mutex::Lock lm (req.result_lock);
+		if (req.surf) {
+			cairo_surface_destroy (req.surf);
+		}
+		req.surf = surf;
+		req.height = height;
+	}
+
+	RenderDone (); /* EMIT SIGNAL */
+}
+
+/** Take the most recent image from the render thread */
+void
+ProcessorEntry::PluginDisplay::render_done ()
+{
+	uint32_t height;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_request->result_lock);
+		if (!_request->surf) {
+			/* already picked up */
+			return;
+		}
+		if (_display_surf) {
+			cairo_surface_destroy (_display_surf);
+		}
+		_display_surf = _request->surf;
+		_request->surf = 0;
+		height = _display_height = _request->height;
+	}
+
+	if (height == 0) {
+		hide ();
+		if (_cur_height != 1) {
+			_cur_height = 1;
+			queue_resize ();
+		}
+		return;
+	}
+
+	update_height_alloc (height);
+	queue_draw ();
+}
+
+void
+ProcessorEntry::PluginDisplay::start_render_thread ()
+{
+	if (!_render_thread) {
+		_render_thread = Glib::Threads::Thread::create (sigc::ptr_fun (&PluginDisplay::render_thread));
+	}
+}
+
+void
+ProcessorEntry::PluginDisplay::stop_render_thread ()
+{
+	if (!_render_thread) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (render_queue_lock);
+		_render_thread_quit = true;
+		render_cond.signal ();
+	}
+
+	_render_thread->join ();
+	_render_thread = 0;
+	_render_thread_quit = false;
+}
+
+void
+ProcessorEntry::PluginDisplay::render_thread ()
+{
+	pthread_set_name ("InlineDisplay");
+
+	Glib::Threads::Mutex::Lock lm (render_queue_lock);
+
+	while (!_render_thread_quit) {
+
+		if (render_queue.empty ()) {
+			render_cond.wait (render_queue_lock);
+			continue;
+		}
+
+		boost::shared_ptr<RenderRequest> req = render_queue.front ();
+		render_queue.pop_front ();
+		req->queued = false;
+
+		/* do not hold the queue lock while rendering, so that the GUI
+		 * can queue requests (and cancel them)
+		 */
+		lm.release ();
+
+		{
+			Glib::Threads::Mutex::Lock rl (req->render_lock);
+			if (req->display) {
+				req->display->render (*req);
+			}
+		}
+
+		req.reset ();
+		lm.acquire ();
+	}
+
+	/* whatever is left will not be rendered */
+	for (std::list<boost::shared_ptr<RenderRequest> >::iterator i = render_queue.begin(); i != render_queue.end(); ++i) {
+		(*i)->queued = false;
+	}
+	render_queue.clear ();
+}
+
+void
+ProcessorEntry::stop_inline_display_thread ()
+{
+	PluginDisplay::stop_render_thread ();
 }
 
 bool
@@ -1602,6 +1870,7 @@ ProcessorEntry::PluginDisplay::update_height_alloc (uint32_t inline_height)
 	_scroll = sc;
 }
 
+/** Called in the render thread */
 uint32_t
 ProcessorEntry::PluginDisplay::render_inline (cairo_t* cr, uint32_t width)
 {
@@ -1664,25 +1933,23 @@ ProcessorEntry::PluginDisplay::on_expose_event (GdkEventExpose* ev)
 	cairo_rectangle (cr, 0, 0, width, height);
 	cairo_fill (cr);
 
-	cairo_save (cr);
-	cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
-	Gtkmm2ext::rounded_rectangle (cr, .5, -1.5, width - 1, height + 1, 7);
-	cairo_clip (cr);
-	cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+	if (!_display_surf || cairo_image_surface_get_width (_display_surf) != width) {
+		/* first expose, or the width changed */
+		queue_render ();
+	}
 
-	uint32_t ht = render_inline (cr, width);
-	cairo_restore (cr);
+	if (_display_surf) {
+		cairo_save (cr);
+		cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+		Gtkmm2ext::rounded_rectangle (cr, .5, -1.5, width - 1, height + 1, 7);
+		cairo_clip (cr);
+		cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
 
-	if (ht == 0) {
-		hide ();
-		if (_cur_height != 1) {
-			_cur_height = 1;
-			queue_resize ();
-		}
-		cairo_destroy (cr);
-		return true;
-	} else {
-		update_height_alloc (ht);
+		cairo_rectangle (cr, 0, 0, width, _display_height);
+		cairo_clip (cr);
+		cairo_set_source_surface (cr, _display_surf, 0, 0);
+		cairo_paint (cr);
+		cairo_restore (cr);
 	}
 
 	bool failed = false;
@@ -1715,9 +1982,11 @@ ProcessorEntry::LuaPluginDisplay::LuaPluginDisplay (ProcessorEntry& e, boost::sh
 
 ProcessorEntry::LuaPluginDisplay::~LuaPluginDisplay ()
 {
+	cancel_render ();
 	delete (_lua_render_inline);
 }
 
+/** Called in the render thread */
 uint32_t
 ProcessorEntry::LuaPluginDisplay::render_inline (cairo_t *cr, uint32_t width)
 {
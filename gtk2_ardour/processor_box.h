@@ -25,6 +25,8 @@
 
 #include <boost/function.hpp>
 
+#include <glibmm/threads.h>
+
 #include <gtkmm/box.h>
 #include <gtkmm/eventbox.h>
 #include <gtkmm/menu.h>
@@ -166,6 +168,9 @@ public:
 	Gtk::Menu* build_controls_menu ();
 	Gtk::Menu* build_send_options_menu ();
 
+	/** stop the thread that renders inline plugin displays; call at exit */
+	static void stop_inline_display_thread ();
+
 protected:
 	ArdourButton _button;
 	Gtk::VBox _vbox;
@@ -240,23 +245,37 @@ private:
 	void toggle_control_visibility (Control *);
 	void toggle_panner_link ();
 
+	/* Inline displays are rendered by a shared background thread into an
+	 * image surface; the GUI thread only paints the most recent one.
+	 * Redraws requested by the plugin are rate-limited, and postponed
+	 * while the display is not mapped (e.g. the strip is hidden).
+	 */
 	class PluginDisplay : public Gtk::DrawingArea {
 	public:
 		PluginDisplay(ProcessorEntry&, boost::shared_ptr<ARDOUR::Plugin>, uint32_t max_height = 80);
 		virtual ~PluginDisplay();
+
+		/** stop the shared render thread, discarding queued requests */
+		static void stop_render_thread ();
 	protected:
 		bool on_expose_event (GdkEventExpose *);
 		void on_size_request (Gtk::Requisition* req);
+		void on_map ();
 		bool on_button_press_event (GdkEventButton *ev);
 		bool on_button_release_event (GdkEventButton *ev);
 
 		void plugin_going_away () {
 			_qdraw_connection.disconnect ();
+			cancel_render ();
 		}
 
 		void update_height_alloc (uint32_t inline_height);
+		/** called in the render thread, @return height of the image, 0 if there is none */
 		virtual uint32_t render_inline (cairo_t *, uint32_t width);
 
+		/** stop rendering; derived classes need to call this before their state goes away */
+		void cancel_render ();
+
 		ProcessorEntry& _entry;
 		boost::shared_ptr<ARDOUR::Plugin> _plug;
 		PBD::ScopedConnection _qdraw_connection;
@@ -265,11 +284,39 @@ private:
 		uint32_t _max_height;
 		uint32_t _cur_height;
 		bool _scroll;
+
+	private:
+		struct RenderRequest;
+
+		void queue_render ();
+		bool render_timeout ();
+		void render (RenderRequest&);
+		void render_done ();
+
+		boost::shared_ptr<RenderRequest> _request;
+		PBD::Signal0<void>    RenderDone;
+		PBD::ScopedConnection _render_done_connection;
+		sigc::connection      _render_timeout;
+		/** the last image received from the render thread, painted on expose */
+		cairo_surface_t*      _display_surf;
+		uint32_t              _display_height;
+		gint64                _last_render;
+		bool                  _render_on_map;
+
+		static void start_render_thread ();
+		static void render_thread ();
+
+		static Glib::Threads::Mutex   render_queue_lock;
+		static Glib::Threads::Cond    render_cond;
+		static Glib::Threads::Thread* _render_thread;
+		static bool                   _render_thread_quit;
+		static std::list<boost::shared_ptr<RenderRequest> > render_queue;
 	};
 
 	class LuaPluginDisplay : public PluginDisplay {
 	public:
 		LuaPluginDisplay(ProcessorEntry&, boost::shared_ptr<ARDOUR::LuaProc>, uint32_t max_height = 80);
+		/* lua_gui is only used by the render thread, once constructed */
 		~LuaPluginDisplay();
 	protected:
 		virtual uint32_t render_inline (cairo_t *, uint32_t width);
@@ -1888,6 +1888,18 @@ RCOptionEditor::RCOptionEditor ()
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
                 add_option (_("Misc"), procs);
+
+		bo = new BoolOption (
+			     "pipelined-processing",
+			     _("Process playback-only tracks one cycle ahead"),
+			     sigc::mem_fun (*_rc_config, &RCConfiguration::get_pipelined_processing),
+			     sigc::mem_fun (*_rc_config, &RCConfiguration::set_pipelined_processing)
+			     );
+		add_option (_("Misc"), bo);
+		Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("If enabled, tracks that are not record-armed and do not monitor their input, deliver their output one cycle late. "
+				  "Busses no longer wait for these tracks, which allows more tracks to be processed in parallel at small buffer sizes. "
+				  "Playback latency increases by one cycle, live inputs are not affected."));
         }
 
 	add_option (_("Misc"), new OptionEditorHeading (S_("Options|Undo")));
@@ -2396,6 +2408,16 @@ if (!Profile->get_mixbus()) {
 
 	add_option (_("Audio"), new BufferingOptions (_rc_config));
 
+	bo = new BoolOption (
+		     "adaptive-playback-buffering",
+		     _("Adapt playback buffer size per track"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_adaptive_playback_buffering),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_adaptive_playback_buffering)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, the memory of the playback buffers is redistributed between tracks when the transport stops: tracks that were not played recently, or have little material where they were played, use smaller buffers; tracks with dense material that are played at high speed or located often use larger ones. The total never exceeds the buffer size above times the number of track-channels."));
+	add_option (_("Audio"), bo);
+
 	add_option (_("Audio"), new OptionEditorHeading (_("Monitoring")));
 
 	ComboOption<MonitorModel>* mm = new ComboOption<MonitorModel> (
@@ -21,14 +21,13 @@
 #include "ardour/tempo.h"
 
 #include <gtkmm2ext/utils.h>
-#include <pthread.h>
 
 #include "canvas/container.h"
 
-#include "ardour_http.h"
 #include "public_editor.h"
 #include "utils_videotl.h"
 #include "video_image_frame.h"
+#include "video_thumbnail_fetcher.h"
 
 #include "pbd/i18n.h"
 
@@ -43,21 +42,18 @@ static void freedata_cb (uint8_t *d, void* /*arg*/) {
 	free (d);
 }
 
-VideoImageFrame::VideoImageFrame (PublicEditor& ed, ArdourCanvas::Container& parent, int w, int h, std::string vsurl, std::string vfn)
+VideoImageFrame::VideoImageFrame (PublicEditor& ed, ArdourCanvas::Container& parent, VideoThumbnailFetcher& vtf, int w, int h, std::string vsurl, std::string vfn)
 	: editor (ed)
 	, _parent(&parent)
+	, fetcher (vtf)
 	, clip_width(w)
 	, clip_height(h)
 	, video_server_url(vsurl)
 	, video_filename(vfn)
 {
-	pthread_mutex_init(&request_lock, NULL);
-	pthread_mutex_init(&queue_lock, NULL);
-	queued_request=false;
 	video_frame_number = -1;
 	rightend = -1;
 	sample_position = 0;
-	thread_active=false;
 
 	unit_position = editor.sample_to_pixel (sample_position);
 	image = new ArdourCanvas::Image (_parent, Cairo::FORMAT_ARGB32, clip_width, clip_height);
@@ -73,10 +69,9 @@ VideoImageFrame::VideoImageFrame (PublicEditor& ed, ArdourCanvas::Container& par
 
 VideoImageFrame::~VideoImageFrame ()
 {
-	if (thread_active) pthread_join(thread_id_tt, NULL);
+	/* wait for a fetch that is in progress, it calls back into this object */
+	fetcher.cancel (this, true);
 	delete image;
-	pthread_mutex_destroy(&request_lock);
-	pthread_mutex_destroy(&queue_lock);
 }
 
 void
@@ -119,6 +114,13 @@ VideoImageFrame::set_videoframe (framepos_t videoframenumber, int re)
 	http_get(video_frame_number);
 }
 
+void
+VideoImageFrame::cancel_request ()
+{
+	/* frame moved off-screen, don't bother the server */
+	fetcher.cancel (this);
+}
+
 void
 VideoImageFrame::draw_line ()
 {
@@ -195,39 +197,11 @@ VideoImageFrame::cut_rightend ()
 	}
 }
 
-static void *
-http_get_thread (void *arg) {
-	VideoImageFrame *vif = static_cast<VideoImageFrame *>(arg);
-	char url[2048];
-	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-	pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
-	snprintf(url, sizeof(url), "%s?frame=%li&w=%d&h=%d&file=%s&format=bgra",
-	  vif->get_video_server_url().c_str(),
-	  (long int) vif->get_req_frame(), vif->get_width(), vif->get_height(),
-	  vif->get_video_filename().c_str()
-	);
-	int status = 0;
-	int timeout = 1000; // * 5ms -> 5sec
-	char *res = NULL;
-	do {
-		res = ArdourCurl::http_get (url, &status);
-		if (status == 503) Glib::usleep(5000); // try-again
-	} while (status == 503 && --timeout > 0);
-
-	if (status != 200 || !res) {
-		printf("no-video frame: video-server returned http-status: %d\n", status);
-	}
-
-	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
-	vif->http_download_done(res);
-	pthread_exit(0);
-	return 0;
-}
-
 void
-VideoImageFrame::http_download_done (char *data){
-	if (queued_request) {
-		http_get_again(want_video_frame_number);
+VideoImageFrame::http_download_done (framepos_t fn, char *data){
+	if (fn != video_frame_number) {
+		/* stale, a request for the current frame is queued */
+		free (data);
 		return;
 	}
 
@@ -250,46 +224,9 @@ VideoImageFrame::http_download_done (char *data){
 	}
 
 	exposeimg();
-	/* don't request frames too quickly, wait after user has zoomed */
-	Glib::usleep(40000);
-
-	if (queued_request) {
-		http_get_again(want_video_frame_number);
-	}
-	pthread_mutex_unlock(&request_lock);
 }
 
-
 void
 VideoImageFrame::http_get(framepos_t fn) {
-	if (pthread_mutex_trylock(&request_lock)) {
-		pthread_mutex_lock(&queue_lock);
-		queued_request=true;
-		want_video_frame_number=fn;
-		pthread_mutex_unlock(&queue_lock);
-		return;
-	}
-	if (thread_active) pthread_join(thread_id_tt, NULL);
-	pthread_mutex_lock(&queue_lock);
-	queued_request=false;
-	req_video_frame_number=fn;
-	pthread_mutex_unlock(&queue_lock);
-	int rv = pthread_create(&thread_id_tt, NULL, http_get_thread, this);
-	thread_active=true;
-	if (rv) {
-		thread_active=false;
-		printf("thread creation failed. %i\n",rv);
-		http_download_done(NULL);
-	}
+	fetcher.request (this, video_server_url, video_filename, fn, clip_width, clip_height);
 }
-
-void
-VideoImageFrame::http_get_again(framepos_t /*fn*/) {
-	pthread_mutex_lock(&queue_lock);
-	queued_request=false;
-	req_video_frame_number=want_video_frame_number;
-	pthread_mutex_unlock(&queue_lock);
-
-	http_get_thread(this);
-}
-
@@ -24,7 +24,6 @@
 #include <glib.h>
 
 #include <sigc++/signal.h>
-#include <pthread.h>
 
 #include "ardour/ardour.h"
 #include "pbd/signals.h"
@@ -39,6 +38,7 @@ namespace ARDOUR {
 }
 
 class PublicEditor;
+class VideoThumbnailFetcher;
 
 /** @class VideoImageFrame
  *  @brief a single video-frame to be displayed in the video timeline
@@ -46,7 +46,7 @@ class PublicEditor;
 class VideoImageFrame : public sigc::trackable
 {
 	public:
-	VideoImageFrame (PublicEditor&, ArdourCanvas::Container&, int, int, std::string, std::string);
+	VideoImageFrame (PublicEditor&, ArdourCanvas::Container&, VideoThumbnailFetcher&, int, int, std::string, std::string);
 	virtual ~VideoImageFrame ();
 
 	void set_position (framepos_t);
@@ -56,17 +56,19 @@ class VideoImageFrame : public sigc::trackable
 	int get_height () {return clip_height;}
 	int get_width ()  {return clip_width;}
 	int get_rightend() { return rightend;}
-	framepos_t get_req_frame () {return req_video_frame_number;}
 	std::string get_video_server_url () {return video_server_url;}
 	std::string get_video_filename ()   {return video_filename;}
 
-	void http_download_done (char *);
+	void cancel_request ();
+
+	void http_download_done (framepos_t, char *);
 	PBD::Signal0<void> ImgChanged;
 
 	protected:
 
 	PublicEditor& editor;
 	ArdourCanvas::Container *_parent;
+	VideoThumbnailFetcher& fetcher;
 	ArdourCanvas::Image *image;
 	boost::shared_ptr<ArdourCanvas::Image::Data> img;
 
@@ -89,20 +91,7 @@ class VideoImageFrame : public sigc::trackable
 	void draw_x ();
 	void cut_rightend ();
 
-
 	void http_get(framepos_t fn);
-	void http_get_again(framepos_t fn);
-
-	framepos_t req_video_frame_number;
-	framepos_t want_video_frame_number;
-	bool        queued_request;
-
-	pthread_mutex_t request_lock;
-	pthread_mutex_t queue_lock;
-
-	pthread_t      thread_id_tt;
-	bool           thread_active;
-
 };
 
 #endif /* __ardour_video_image_frame_h__ */
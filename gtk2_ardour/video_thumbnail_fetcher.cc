@@ -0,0 +1,362 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include <glibmm/miscutils.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/timer.h>
+
+#include "pbd/compose.h"
+#include "pbd/file_utils.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/md5.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/filesystem_paths.h"
+
+#include "ardour_http.h"
+#include "video_image_frame.h"
+#include "video_thumbnail_fetcher.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* the disk cache is trimmed to this size, every trim_interval stores */
+static const off_t max_disk_cache_size = 128 * 1048576;
+static const gint trim_interval = 64;
+/* a .tmp file that was not modified for this long is left over (e.g. from a crash) */
+static const time_t stale_tmp_age = 60;
+
+VideoThumbnailFetcher::VideoThumbnailFetcher (unsigned int n_workers)
+	: _quit (false)
+	, _use_disk_cache (true)
+	, _stores_since_trim (trim_interval) // trim the cache of previous sessions early
+{
+	_cache_dir = Glib::build_filename (user_cache_directory (), X_("vtl-thumbnails"));
+	if (g_mkdir_with_parents (_cache_dir.c_str (), 0755)) {
+		_use_disk_cache = false;
+	}
+
+	for (unsigned int i = 0; i < std::max (1u, n_workers); ++i) {
+		pthread_t t;
+		if (pthread_create_and_store (X_("VTL thumbnails"), &t, _worker, this)) {
+			printf ("video-timeline: thread creation failed.\n");
+			continue;
+		}
+		_workers.push_back (t);
+	}
+}
+
+VideoThumbnailFetcher::~VideoThumbnailFetcher ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+		_quit = true;
+		_queue.clear ();
+		_queue_cond.broadcast ();
+	}
+	for (std::vector<pthread_t>::iterator i = _workers.begin (); i != _workers.end (); ++i) {
+		pthread_join (*i, NULL);
+	}
+}
+
+void
+VideoThumbnailFetcher::request (VideoImageFrame* vif, std::string const& server_url, std::string const& filename, framepos_t frame, int width, int height)
+{
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+	/* coalesce: only the most recent request of any given image-frame is relevant */
+	for (RequestQueue::iterator i = _queue.begin (); i != _queue.end (); ++i) {
+		if (i->frame == vif) {
+			_queue.erase (i);
+			break;
+		}
+	}
+
+	Request r;
+	r.frame        = vif;
+	r.server_url   = server_url;
+	r.filename     = filename;
+	r.stamp        = _file_stamp;
+	r.frame_number = frame;
+	r.width        = width;
+	r.height       = height;
+	_queue.push_back (r);
+
+	_queue_cond.signal ();
+}
+
+void
+VideoThumbnailFetcher::cancel (VideoImageFrame* vif, bool block)
+{
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	for (RequestQueue::iterator i = _queue.begin (); i != _queue.end (); ++i) {
+		if (i->frame == vif) {
+			_queue.erase (i);
+			break;
+		}
+	}
+	while (block && _in_flight.find (vif) != _in_flight.end ()) {
+		_done_cond.wait (_queue_lock);
+	}
+}
+
+void
+VideoThumbnailFetcher::cancel_all ()
+{
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	_queue.clear ();
+}
+
+void
+VideoThumbnailFetcher::set_file_stamp (std::string const& stamp)
+{
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	_file_stamp = stamp;
+}
+
+void
+VideoThumbnailFetcher::flush_disk_cache ()
+{
+	if (_cache_dir.empty () || !Glib::file_test (_cache_dir, Glib::FILE_TEST_IS_DIR)) {
+		return;
+	}
+	PBD::clear_directory (_cache_dir);
+}
+
+std::string
+VideoThumbnailFetcher::cache_key (std::string const& server_url, std::string const& filename, std::string const& stamp, framepos_t frame, int width, int height)
+{
+	MD5 md5;
+	std::string const id = string_compose ("%1|%2|%3|%4|%5x%6", server_url, filename, stamp, frame, width, height);
+	md5.digestString (id.c_str ());
+	return std::string (md5.digestChars) + X_(".bgra");
+}
+
+void*
+VideoThumbnailFetcher::_worker (void* arg)
+{
+	pthread_set_name ("VTLThumbnails");
+	static_cast<VideoThumbnailFetcher*> (arg)->worker ();
+	return 0;
+}
+
+void
+VideoThumbnailFetcher::worker ()
+{
+	/* one persistent handle per worker: libcurl keeps the
+	 * connection to the video-server alive between requests.
+	 */
+	ArdourCurl::HttpGet http (true, false);
+
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+	while (!_quit) {
+
+		/* find the oldest request of a frame which is not currently being fetched */
+		RequestQueue::iterator i;
+		for (i = _queue.begin (); i != _queue.end (); ++i) {
+			if (_in_flight.find (i->frame) == _in_flight.end ()) {
+				break;
+			}
+		}
+
+		if (i == _queue.end ()) {
+			_queue_cond.wait (_queue_lock);
+			continue;
+		}
+
+		Request const r (*i);
+		_queue.erase (i);
+		_in_flight.insert (r.frame);
+
+		lm.release ();
+
+		const bool use_disk_cache = _use_disk_cache && !r.stamp.empty ();
+
+		char* data = NULL;
+		if (use_disk_cache) {
+			data = cache_lookup (r);
+		}
+		if (!data) {
+			data = fetch (r, &http);
+			if (data && use_disk_cache) {
+				cache_store (r, data);
+			}
+		}
+
+		/* the frame is guaranteed to exist while it is in-flight, see cancel() */
+		r.frame->http_download_done (r.frame_number, data);
+
+		lm.acquire ();
+		_in_flight.erase (r.frame);
+		_done_cond.broadcast ();
+	}
+}
+
+char*
+VideoThumbnailFetcher::fetch (Request const& r, void* h)
+{
+	ArdourCurl::HttpGet* http = static_cast<ArdourCurl::HttpGet*> (h);
+	const size_t expected = r.width * r.height * 4;
+
+	char url[2048];
+	snprintf (url, sizeof(url), "%s?frame=%li&w=%d&h=%d&file=%s&format=bgra",
+			r.server_url.c_str (), (long int) r.frame_number, r.width, r.height, r.filename.c_str ());
+
+	int timeout = 1000; // * 5ms -> 5sec
+	char* res = NULL;
+	do {
+		/* a busy server answers 503: retry quietly, only the final outcome is reported */
+		res = http->get (url, false);
+		if (!res) {
+			/* persistent handle: caller owns the (error) body */
+			free (http->data ());
+		}
+		if (http->status () == 503) {
+			Glib::usleep (5000); // try-again
+		}
+	} while (http->status () == 503 && --timeout > 0 && !_quit);
+
+	if (!res || http->status () != 200) {
+		printf ("no-video frame: %s\n", http->error ().c_str ());
+		return NULL;
+	}
+
+	if (http->data_size () < expected) {
+		printf ("no-video frame: short image data: %lu of %lu bytes\n", (unsigned long) http->data_size (), (unsigned long) expected);
+		free (res);
+		return NULL;
+	}
+
+	return res;
+}
+
+char*
+VideoThumbnailFetcher::cache_lookup (Request const& r)
+{
+	const size_t expected = r.width * r.height * 4;
+	std::string const path = Glib::build_filename (_cache_dir, cache_key (r.server_url, r.filename, r.stamp, r.frame_number, r.width, r.height));
+
+	FILE* f = g_fopen (path.c_str (), "rb");
+	if (!f) {
+		return NULL;
+	}
+
+	char* data = (char*) malloc (expected);
+	if (data && fread (data, 1, expected, f) != expected) {
+		free (data);
+		data = NULL;
+	}
+	fclose (f);
+	return data;
+}
+
+void
+VideoThumbnailFetcher::cache_store (Request const& r, char const* data)
+{
+	const size_t expected = r.width * r.height * 4;
+	std::string const path = Glib::build_filename (_cache_dir, cache_key (r.server_url, r.filename, r.stamp, r.frame_number, r.width, r.height));
+	std::string const tmp = path + X_(".tmp");
+
+	FILE* f = g_fopen (tmp.c_str (), "wb");
+	if (!f) {
+		return;
+	}
+	const bool ok = fwrite (data, 1, expected, f) == expected;
+	fclose (f);
+
+	/* rename is atomic: concurrent readers never see a partial image */
+	if (!ok || ::g_rename (tmp.c_str (), path.c_str ())) {
+		::g_unlink (tmp.c_str ());
+		return;
+	}
+
+	if (g_atomic_int_add (&_stores_since_trim, 1) + 1 >= trim_interval) {
+		trim_disk_cache ();
+	}
+}
+
+static bool
+is_tmp_file (std::string const& name)
+{
+	return name.size () > 4 && name.compare (name.size () - 4, 4, X_(".tmp")) == 0;
+}
+
+static bool
+older (std::pair<time_t, std::string> const& a, std::pair<time_t, std::string> const& b)
+{
+	return a.first < b.first;
+}
+
+/** remove the least recently stored images until the cache is below max_disk_cache_size */
+void
+VideoThumbnailFetcher::trim_disk_cache ()
+{
+	Glib::Threads::Mutex::Lock lm (_trim_lock, Glib::Threads::TRY_LOCK);
+	if (!lm.locked ()) {
+		/* another worker is at it */
+		return;
+	}
+
+	g_atomic_int_set (&_stores_since_trim, 0);
+
+	std::vector<std::pair<time_t, std::string> > files;
+	off_t total = 0;
+	const time_t now = time (NULL);
+
+	try {
+		Glib::Dir dir (_cache_dir);
+		for (Glib::DirIterator i = dir.begin (); i != dir.end (); ++i) {
+			std::string const path = Glib::build_filename (_cache_dir, *i);
+			GStatBuf sb;
+			if (g_stat (path.c_str (), &sb) || !S_ISREG (sb.st_mode)) {
+				continue;
+			}
+			if (is_tmp_file (*i) && now - sb.st_mtime < stale_tmp_age) {
+				/* a worker may still be writing it, see cache_store() */
+				continue;
+			}
+			files.push_back (make_pair (sb.st_mtime, path));
+			total += sb.st_size;
+		}
+	} catch (Glib::FileError const&) {
+		return;
+	}
+
+	if (total <= max_disk_cache_size) {
+		return;
+	}
+
+	std::sort (files.begin (), files.end (), older);
+
+	for (std::vector<std::pair<time_t, std::string> >::const_iterator f = files.begin (); f != files.end () && total > max_disk_cache_size; ++f) {
+		GStatBuf sb;
+		if (g_stat (f->second.c_str (), &sb) == 0 && ::g_unlink (f->second.c_str ()) == 0) {
+			total -= sb.st_size;
+		}
+	}
+}
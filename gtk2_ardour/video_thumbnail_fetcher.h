@@ -0,0 +1,110 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+#ifndef __ardour_video_thumbnail_fetcher_h__
+#define __ardour_video_thumbnail_fetcher_h__
+
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <glibmm/threads.h>
+
+#include "ardour/types.h"
+
+class VideoImageFrame;
+
+/** @class VideoThumbnailFetcher
+ *  @brief fixed pool of worker threads retrieving video-frames for the video timeline
+ *
+ *  Every worker owns a persistent curl handle, so consecutive requests
+ *  to the video-server re-use the same (keep-alive) connection.
+ *
+ *  Requests are queued per \ref VideoImageFrame: a new request for a frame
+ *  that is still pending replaces the previous one (only the most recent
+ *  frame-number is fetched), and requests of frames that scrolled off-screen
+ *  can be cancelled before they hit the server.
+ *
+ *  Successfully retrieved images are stored in an on-disk cache below
+ *  the user's cache-directory, keyed by server-url, video-file, the file's
+ *  stamp (see \ref set_file_stamp), frame-number and image size. The
+ *  oldest images are removed when the cache grows beyond a fixed size.
+ */
+class VideoThumbnailFetcher
+{
+	public:
+	VideoThumbnailFetcher (unsigned int n_workers = 4);
+	~VideoThumbnailFetcher ();
+
+	void request (VideoImageFrame*, std::string const& server_url, std::string const& filename, ARDOUR::framepos_t frame, int width, int height);
+
+	/** drop any pending request for the given frame. If block is true,
+	 * also wait for an in-flight request to complete (the frame may be deleted afterwards)
+	 */
+	void cancel (VideoImageFrame*, bool block = false);
+	void cancel_all ();
+
+	/** set the stamp (size and modification time) of the video-file that
+	 * subsequent requests refer to, so that images of a file which has
+	 * since been replaced are not taken from the disk cache.
+	 * An empty stamp (the file is not local) bypasses the disk cache.
+	 */
+	void set_file_stamp (std::string const&);
+	void flush_disk_cache ();
+
+	static std::string cache_key (std::string const& server_url, std::string const& filename, std::string const& stamp, ARDOUR::framepos_t frame, int width, int height);
+
+	private:
+	struct Request {
+		VideoImageFrame*   frame;
+		std::string        server_url;
+		std::string        filename;
+		std::string        stamp;
+		ARDOUR::framepos_t frame_number;
+		int                width;
+		int                height;
+	};
+
+	typedef std::list<Request> RequestQueue;
+
+	RequestQueue                _queue;
+	std::set<VideoImageFrame*>  _in_flight;
+	Glib::Threads::Mutex        _queue_lock;
+	Glib::Threads::Cond         _queue_cond;
+	Glib::Threads::Cond         _done_cond;
+
+	std::vector<pthread_t>      _workers;
+	bool                        _quit;
+	bool                        _use_disk_cache;
+	std::string                 _cache_dir;
+	std::string                 _file_stamp;
+	gint                        _stores_since_trim;
+	Glib::Threads::Mutex        _trim_lock;
+
+	static void* _worker (void*);
+	void worker ();
+
+	char* fetch (Request const&, void* http);
+	char* cache_lookup (Request const&);
+	void  cache_store (Request const&, char const* data);
+	void  trim_disk_cache ();
+};
+
+#endif /* __ardour_video_thumbnail_fetcher_h__ */
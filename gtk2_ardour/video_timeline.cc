@@ -22,6 +22,7 @@
 #include "ardour/tempo.h"
 
 #include "pbd/file_utils.h"
+#include "pbd/gstdio_compat.h"
 #include "pbd/convert.h"
 #include "ardour/session_directory.h"
 
@@ -67,6 +68,7 @@ VideoTimeLine::VideoTimeLine (PublicEditor *ed, ArdourCanvas::Container *vbg, in
 	flush_frames = false;
 	vmonitor=0;
 	reopen_vmonitor=false;
+	thumbnail_fetcher = new VideoThumbnailFetcher ();
 	find_xjadeo();
 
 	VtlUpdate.connect (*this, invalidator (*this), boost::bind (&PublicEditor::queue_visual_videotimeline_update, editor), gui_context());
@@ -76,6 +78,8 @@ VideoTimeLine::VideoTimeLine (PublicEditor *ed, ArdourCanvas::Container *vbg, in
 VideoTimeLine::~VideoTimeLine ()
 {
 	close_session();
+	remove_frames();
+	delete thumbnail_fetcher;
 }
 
 /* close and save settings */
@@ -246,6 +250,7 @@ VideoTimeLine::get_state ()
 void
 VideoTimeLine::remove_frames ()
 {
+	thumbnail_fetcher->cancel_all ();
 	for (VideoFrames::iterator i = video_frames.begin(); i != video_frames.end(); ++i ) {
 		VideoImageFrame *frame = (*i);
 		delete frame;
@@ -382,7 +387,7 @@ VideoTimeLine::update_video_timeline()
 
 	while (video_frames.size() < visible_video_frames) {
 		VideoImageFrame *frame;
-		frame = new VideoImageFrame(*editor, *videotl_group, display_vframe_width, bar_height, video_server_url, translated_filename());
+		frame = new VideoImageFrame(*editor, *videotl_group, *thumbnail_fetcher, display_vframe_width, bar_height, video_server_url, translated_filename());
 		frame->ImgChanged.connect (*this, invalidator (*this), boost::bind (&PublicEditor::queue_visual_videotimeline_update, editor), gui_context());
 		video_frames.push_back(frame);
 	}
@@ -426,6 +431,7 @@ VideoTimeLine::update_video_timeline()
 		VideoImageFrame *frame = (*i);
 		if (remaining.empty()) {
 		  frame->set_position(-2 * vtl_dist + leftmost_sample); /* move off screen */
+		  frame->cancel_request();
 		} else {
 			int vfcount=remaining.front();
 			remaining.pop_front();
@@ -464,6 +470,16 @@ VideoTimeLine::video_file_info (std::string filename, bool local)
 		video_filename = Glib::build_filename (_session->session_directory().video_path(), filename);
 	}
 
+	/* cached thumbnails of a file that has been replaced must not be used;
+	 * remote files cannot be checked, and are not cached on disk.
+	 */
+	std::string stamp;
+	GStatBuf sb;
+	if (local_file && g_stat (video_filename.c_str(), &sb) == 0) {
+		stamp = string_compose ("%1-%2", (int64_t) sb.st_size, (int64_t) sb.st_mtime);
+	}
+	thumbnail_fetcher->set_file_stamp (stamp);
+
 	long long int _duration;
 	double _start_offset;
 
@@ -679,6 +695,7 @@ VideoTimeLine::flush_cache () {
 	if (res) {
 		free (res);
 	}
+	thumbnail_fetcher->flush_disk_cache ();
 	if (vmonitor && vmonitor->is_started()) {
 		reopen_vmonitor=true;
 		vmonitor->quit();
@@ -28,6 +28,7 @@
 #include "ardour/session_handle.h"
 #include "video_image_frame.h"
 #include "video_monitor.h"
+#include "video_thumbnail_fetcher.h"
 #include "pbd/signals.h"
 #include "canvas/container.h"
 
@@ -128,6 +129,7 @@ class VideoTimeLine : public sigc::trackable, public ARDOUR::SessionHandlePtr, p
 
 	typedef std::list<VideoImageFrame*> VideoFrames;
 	VideoFrames video_frames;
+	VideoThumbnailFetcher *thumbnail_fetcher;
 	VideoImageFrame *get_video_frame (framepos_t vfn, int cut=0, int rightend = -1);
 	bool        flush_frames;
 	void        remove_frames ();
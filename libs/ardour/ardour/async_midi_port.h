@@ -19,6 +19,8 @@
 #ifndef  __libardour_async_midiport_h__
 #define  __libardour_async_midiport_h__
 
+#include <algorithm>
+#include <cstdlib>
 #include <string>
 #include <iostream>
 
@@ -26,8 +28,8 @@
 
 #include "pbd/xml++.h"
 #include "pbd/crossthread.h"
+#include "pbd/mpsc_queue.h"
 #include "pbd/signals.h"
-#include "pbd/ringbuffer.h"
 
 #include "evoral/Event.hpp"
 
@@ -73,19 +75,54 @@ class LIBARDOUR_API AsyncMIDIPort : public ARDOUR::MidiPort, public MIDI::Port {
 	int selectable() const { return -1; }
 	void set_timer (boost::function<framecnt_t (void)>&);
 
+	/** @return the number of events written from non-process threads
+	 * that were dropped because they were invalid or too large
+	 */
+	guint output_events_dropped () const {
+		return g_atomic_int_get (&_output_events_dropped);
+	}
+
 	static void set_process_thread (pthread_t);
 	static pthread_t get_process_thread () { return _process_thread; }
 	static bool is_process_thread();
 
+	/** an event written by a non-process thread. The writer fills in a
+	 * per-thread staging event and only swaps it with a queue slot, so
+	 * nothing that may allocate happens while the slot is reserved.
+	 * Buffers (and their capacity) travel back and forth between the
+	 * queue and the writers' staging events.
+	 */
+	struct OutputEvent {
+		OutputEvent () : time (0), size (0), capacity (0), buf (0) {}
+		~OutputEvent () { free (buf); }
+
+		void swap (OutputEvent& other) {
+			std::swap (time, other.time);
+			std::swap (size, other.size);
+			std::swap (capacity, other.capacity);
+			std::swap (buf, other.buf);
+		}
+
+		MIDI::timestamp_t time;
+		uint32_t          size;
+		uint32_t          capacity;
+		MIDI::byte*       buf;
+
+	  private:
+		OutputEvent (OutputEvent const&);
+		OutputEvent& operator= (OutputEvent const&);
+	};
+
   private:
 	bool                    _currently_in_cycle;
         MIDI::timestamp_t       _last_write_timestamp;
 	bool                    have_timer;
 	boost::function<framecnt_t (void)> timer;
-	RingBuffer< Evoral::Event<double> > output_fifo;
+	/** events written by non-process threads; any number of them may write concurrently */
+	PBD::MPSCQueue<OutputEvent> output_fifo;
         EventRingBuffer<MIDI::timestamp_t> input_fifo;
-        Glib::Threads::Mutex output_fifo_lock;
 	CrossThreadChannel _xthread;
+	mutable gint _output_events_dropped;
 
 	int create_port ();
 
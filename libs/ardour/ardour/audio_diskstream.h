@@ -30,6 +30,8 @@
 
 #include <boost/utility.hpp>
 
+#include <glibmm/threads.h>
+
 #include "pbd/fastlog.h"
 #include "pbd/ringbufferNPT.h"
 #include "pbd/stateful.h"
@@ -63,6 +65,66 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 	float playback_buffer_load() const;
 	float capture_buffer_load() const;
 
+	framecnt_t playback_buffer_size () const;
+	framecnt_t capture_buffer_size () const;
+	framecnt_t playback_frames_buffered () const;
+
+	/** Copy up to @param cnt samples of channel @param n, starting at the read
+	 *  pointer of its playback buffer, to @param dst without consuming them.
+	 *  @return number of samples copied.
+	 */
+	framecnt_t peek_playback_buffer (Sample* dst, framecnt_t cnt, uint32_t n = 0) const;
+
+	/** size the playback buffer relative to the session's default,
+	 * effective with the next adjust_playback_buffering().
+	 * See Session::adapt_playback_buffering()
+	 */
+	void   set_playback_buffer_scale (double s) { _playback_buffer_scale = s; }
+	double playback_buffer_scale () const { return _playback_buffer_scale; }
+
+	/** Disk reads during the last few transport runs, for
+	 * Session::adapt_playback_buffering()
+	 */
+	class LIBARDOUR_API ReadWindow {
+	  public:
+		ReadWindow ();
+
+		/** @param read frames read from disk during the run
+		 *  @param rolled frames that the engine processed during the run
+		 *  @param density the part of the range read that is covered by regions
+		 */
+		void add (framecnt_t read, framecnt_t rolled, double density);
+		void clear ();
+
+		/** @return frames read in the window */
+		framecnt_t read () const;
+		/** @return frames read per frame rolled: about the transport speed
+		 *  while playing, more after many locates
+		 */
+		double rate () const;
+		/** @return density, weighted by the time spent rolling */
+		double density () const;
+
+		static const uint32_t size = 4;
+
+	  private:
+		struct Run {
+			Run () : read (0), rolled (0), density (0) {}
+			framecnt_t read;
+			framecnt_t rolled;
+			double     density;
+		};
+
+		Run      _runs[size];
+		uint32_t _next;
+	};
+
+	/** Add the reads since the last call to the read window. The density is
+	 *  computed from the playlist (butler thread, transport stopped).
+	 */
+	void close_read_run ();
+	ReadWindow const & read_window () const { return _read_window; }
+
 	std::string input_source (uint32_t n=0) const {
 		boost::shared_ptr<ChannelList> c = channels.reader();
 		if (n < c->size()) {
@@ -118,6 +180,39 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 
 	void request_input_monitoring (bool);
 
+	/** write statistics of all audio diskstreams' capture flushes */
+	struct CaptureStats {
+		CaptureStats () : samples (0), bytes (0), flushes (0), usecs (0), max_flush_usecs (0) {}
+
+		uint64_t samples;
+		uint64_t bytes;
+		uint64_t flushes;
+		int64_t  usecs;           ///< total time spent writing
+		int64_t  max_flush_usecs; ///< worst-case duration of a single do_flush()
+
+		/** @return average write throughput in bytes/sec */
+		double throughput () const { return usecs > 0 ? bytes * 1e6 / usecs : 0; }
+	};
+
+	static CaptureStats capture_stats ();
+	static void reset_capture_stats ();
+
+	/** statistics of all audio diskstreams' seek()s: how many could re-use
+	 * data that was already in the playback buffers instead of refilling
+	 * them from disk, and how long they took
+	 */
+	struct SeekStats {
+		SeekStats () : seeks (0), buffered (0), usecs (0), max_usecs (0) {}
+
+		uint64_t seeks;
+		uint64_t buffered;  ///< seeks that kept the playback buffers
+		int64_t  usecs;     ///< total time spent in seek()
+		int64_t  max_usecs;
+	};
+
+	static SeekStats seek_stats ();
+	static void reset_seek_stats ();
+
 	static void swap_by_ptr (Sample *first, Sample *last) {
 		while (first < last) {
 			Sample tmp = *first;
@@ -252,6 +347,43 @@ class LIBARDOUR_API AudioDiskstream : public Diskstream
 	static Sample* _mixdown_buffer;
 	static gain_t* _gain_buffer;
 
+	/* staging buffer for do_flush (butler thread) */
+	Sample*    _flush_buffer;
+	framecnt_t _flush_buffer_size;
+
+	double     _playback_buffer_scale;
+
+	/* statistics of the current run, see ::close_read_run() */
+	framecnt_t _frames_read;
+	framecnt_t _frames_rolled;
+	framepos_t _read_start;
+	framepos_t _read_end;
+	ReadWindow _read_window;
+
+	framecnt_t scaled_playback_buffer_size () const;
+
+	static const framecnt_t capture_flush_chunks;
+	static const framecnt_t capture_write_alignment;
+
+	static CaptureStats         _capture_stats;
+	static Glib::Threads::Mutex _capture_stats_lock;
+	static void add_capture_stats (framecnt_t samples, gint64 usecs);
+
+	static SeekStats            _seek_stats;
+	static Glib::Threads::Mutex _seek_stats_lock;
+	static void add_seek_stats (bool buffered, gint64 usecs);
+
+	/** first frame of the data in the playback buffers that is contiguous
+	 * up to file_frame, or max_framepos if the buffers were filled backwards,
+	 * wrapped around a loop or overwritten.
+	 */
+	framepos_t _buffer_start;
+	/** how much already played data to keep behind the read pointer */
+	framecnt_t _history_frames;
+
+	framecnt_t retained_history () const;
+	bool seek_in_buffers (framepos_t frame);
+
 	std::vector<boost::shared_ptr<AudioFileSource> > capturing_sources;
 
 	SerializedRCUManager<ChannelList> channels;
@@ -25,6 +25,7 @@
 
 #include "ardour/ardour.h"
 #include "ardour/playlist.h"
+#include "ardour/playlist_render_cache.h"
 
 namespace ARDOUR  {
 
@@ -45,6 +46,9 @@ public:
 
 	bool destroy_region (boost::shared_ptr<Region>);
 
+	/** statistics of the render cache, which is used if the "playlist-render-cache" option is set */
+	PlaylistRenderCache::Stats render_cache_stats () const { return _render_cache.stats (); }
+
 protected:
 
 	void pre_combine (std::vector<boost::shared_ptr<Region> >&);
@@ -57,6 +61,12 @@ private:
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 	void source_offset_changed (boost::shared_ptr<AudioRegion>);
         void load_legacy_crossfades (const XMLNode&, int version);
+
+	void rendered_range_changed (Evoral::Range<framepos_t> const &);
+
+	PlaylistRenderCache _render_cache;
+	/** configuration that read() depends on, when the render cache was last used */
+	uint32_t            _render_cache_settings;
 };
 
 } /* namespace ARDOUR */
@@ -23,6 +23,8 @@
 #include <vector>
 #include <list>
 
+#include <glibmm/threads.h>
+
 #include "pbd/fastlog.h"
 #include "pbd/undo.h"
 
@@ -239,6 +241,48 @@ class LIBARDOUR_API AudioRegion : public Region
 	uint32_t               _fade_in_suspended;
 	uint32_t               _fade_out_suspended;
 
+	/* Fades, evaluated once for every frame they cover, so that read_at()
+	 * does not need to evaluate them on every read. Tables are (re)built
+	 * by the reading thread when first needed, and dropped when their
+	 * curve changes. The envelope covers the whole region and is
+	 * evaluated for each read instead.
+	 */
+
+	enum GainCurve {
+		FadeInGain = 0,
+		/** the inverse fade in curve, or 1 - fade in */
+		InverseFadeInGain,
+		FadeOutGain,
+		/** the inverse fade out curve, or 1 - fade out */
+		InverseFadeOutGain,
+		/** curves from here on are never kept as tables */
+		NumGainTables,
+		EnvelopeGain = NumGainTables
+	};
+
+	typedef boost::shared_ptr<std::vector<gain_t> const> GainTable;
+
+	struct GainTableSlot {
+		GainTableSlot () : version (0) {}
+
+		GainTable table;
+		uint32_t  version; ///< incremented whenever the table is dropped
+	};
+
+	/** curves longer than this (in frames) are not kept as tables */
+	static const framecnt_t max_gain_table_length;
+
+	mutable Glib::Threads::Mutex _gain_table_lock;
+	mutable GainTableSlot        _gain_tables[NumGainTables];
+
+	framecnt_t gain_curve_length (GainCurve) const;
+	void compute_gain (GainCurve, framecnt_t offset, framecnt_t cnt, gain_t* vec) const;
+	GainTable gain_table (GainCurve) const;
+	gain_t const* gain_vector (GainCurve, GainTable const&, framecnt_t offset, framecnt_t cnt, gain_t* scratch) const;
+	void drop_gain_tables (GainCurve first, GainCurve last);
+	void mix_with_fade (Sample* buf, Sample const* mixdown_buffer, GainCurve fade, framecnt_t fade_offset, bool lower,
+	                    framecnt_t envelope_offset, framecnt_t cnt) const;
+
 	boost::shared_ptr<ARDOUR::Region> get_single_other_xfade_region (bool start) const;
 
   protected:
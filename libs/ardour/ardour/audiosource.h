@@ -24,6 +24,7 @@
 #include <boost/shared_array.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
+#include <list>
 #include <time.h>
 
 #include <glibmm/threads.h>
@@ -33,6 +34,7 @@
 #include "ardour/source.h"
 #include "ardour/ardour.h"
 #include "ardour/readable.h"
+#include "pbd/ringbufferNPT.h"
 #include "pbd/stateful.h"
 #include "pbd/xml++.h"
 
@@ -106,6 +108,16 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	static void allocate_working_buffers (framecnt_t framerate);
 
+	/** start the thread that computes peaks for data being recorded,
+	 * see compute_and_write_live_peaks()
+	 */
+	static void init_live_peaks ();
+
+	/** allocate what compute_and_write_live_peaks() needs, before
+	 * anything is written to a new capture source
+	 */
+	void prepare_for_live_peaks ();
+
   protected:
 	static bool _build_missing_peakfiles;
 	static bool _build_peakfiles;
@@ -131,6 +143,7 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	int build_peaks_from_scratch ();
 	int compute_and_write_peaks (Sample* buf, framecnt_t first_frame, framecnt_t cnt,
 	bool force, bool intermediate_peaks_ready_signal);
+	void compute_and_write_live_peaks (Sample* buf, framepos_t first_frame, framecnt_t cnt);
 	void truncate_peakfile();
 
 	mutable off_t _peak_byte_max; // modified in compute_and_write_peak()
@@ -169,6 +182,26 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 	mutable off_t _last_map_off;
 	mutable size_t  _last_raw_map_length;
 	mutable boost::scoped_array<PeakData> peak_cache;
+
+	/* data passed to compute_and_write_live_peaks() that the live peak
+	   thread has not yet dealt with, starting at _live_peak_frame.
+	   Protected by _live_peak_lock, which is only held briefly: the
+	   peaks are computed with _peak_compute_lock held instead, so that
+	   the writer need not wait for the live peak thread.
+	*/
+	PBD::RingBufferNPT<Sample>* _live_peak_data;
+	framepos_t                  _live_peak_frame;
+	bool                        _live_peak_queued;
+	Glib::Threads::Mutex        _live_peak_lock;
+	Glib::Threads::Mutex        _peak_compute_lock;
+
+	void flush_live_peaks (framecnt_t max_frames);
+
+	static void live_peak_work ();
+
+	static Glib::Threads::Mutex _live_peak_queue_lock;
+	static Glib::Threads::Cond  _live_peaks_to_compute;
+	static std::list<boost::weak_ptr<AudioSource> > _live_peak_queue;
 };
 
 }
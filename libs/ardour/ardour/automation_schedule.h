@@ -0,0 +1,133 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_automation_schedule_h__
+#define __ardour_automation_schedule_h__
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <glib.h>
+
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace Evoral {
+class ControlList;
+}
+
+namespace ARDOUR {
+
+class AutomationControl;
+
+/** Automation playback for the controls of a processor.
+ *
+ * For each control, the schedule remembers the segment of its automation
+ * list (the stretch between two control points) that the playhead was last
+ * in. While the playhead stays in a segment over which the value does not
+ * change, the list is not evaluated and the control is not set again. The
+ * end of each segment is the list's next control point, so the time of the
+ * next automation event can be found without searching all lists.
+ *
+ * Edits to a list cause it to be looked at again, see the list's Dirty
+ * and InterpolationChanged signals. Frozen lists are evaluated every time.
+ */
+class LIBARDOUR_API AutomationSchedule : public boost::noncopyable
+{
+  public:
+	AutomationSchedule ();
+
+	/** Set the controls to play back; only those with an automation
+	 * list are kept. Must not be called concurrently with run() or
+	 * next_event().
+	 */
+	void set_controls (std::vector<boost::shared_ptr<AutomationControl> > const&);
+
+	/** Forget what is known about all lists, so that all controls in
+	 * automation playback are set again by the next run(). May be called
+	 * from any thread.
+	 */
+	void invalidate ();
+
+	/** Set all controls that are in automation playback to their value at
+	 * @param now. Realtime safe.
+	 */
+	void run (double now);
+
+	/** Find the first control point of any control in automation playback
+	 * in (@param now, @param end). Realtime safe.
+	 * @param when set to the time of the control point
+	 * @return true if there is one
+	 */
+	bool next_event (double now, double end, double& when);
+
+	struct Segment {
+		Segment () : from (0), to (0), constant (false), value (0) {}
+
+		double from;     ///< the segment is [from, to)
+		double to;       ///< time of the next control point
+		bool   constant; ///< true if the value does not change in the segment
+		double value;    ///< the value throughout the segment, if constant
+	};
+
+	/** Find the segment of @param list that @param when falls into.
+	 * The list's lock must be held.
+	 */
+	static void find_segment (Evoral::ControlList const& list, double when, Segment&);
+
+	struct Stats {
+		Stats () : evaluations (0), skipped (0), lookups (0) {}
+
+		uint64_t evaluations; ///< controls that were set by run()
+		uint64_t skipped;     ///< controls that run() knew to be unchanged
+		uint64_t lookups;     ///< searches for a list's current segment
+	};
+
+	/** @return counters since the schedule was created; updated without
+	 * synchronization by the process thread, so only approximate.
+	 */
+	Stats stats () const { return _stats; }
+
+  private:
+	struct Entry {
+		Entry () : have_segment (false), value_set (false), dirty (0) {}
+
+		boost::shared_ptr<AutomationControl> control;
+		Segment      segment;
+		bool         have_segment;
+		bool         value_set; ///< control has been set to the (constant) segment value
+		mutable gint dirty;     ///< the list has changed since segment was found
+	};
+
+	typedef std::vector<Entry> Entries;
+
+	Entries _entries;
+	Stats   _stats;
+
+	PBD::ScopedConnectionList _list_connections;
+
+	void list_changed (size_t);
+	bool locate (Entry&, double now);
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_automation_schedule_h__ */
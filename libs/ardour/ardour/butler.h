@@ -21,7 +21,9 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
+#include <boost/shared_ptr.hpp>
 #include <glibmm/threads.h>
 
 #include "pbd/crossthread.h"
@@ -31,10 +33,13 @@
 #include "ardour/types.h"
 #include "ardour/session_handle.h"
 
+class ButlerTest;
 
 
 namespace ARDOUR {
 
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -88,10 +93,35 @@ class LIBARDOUR_API Butler : public SessionHandleRef
 	RingBuffer<CrossThreadPool*> pool_trash;
 
 private:
+	friend class ::ButlerTest;
+
 	void empty_pool_trash ();
 	void config_changed (std::string);
 
-	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
+	/** Disk I/O of a track, ordered by urgency: the frames that
+	 * remain until its playback buffer runs dry (refill) or its
+	 * capture buffer overflows (flush).
+	 */
+	struct DiskWork {
+		enum Type {
+			Refill,
+			Flush
+		};
+
+		DiskWork (boost::shared_ptr<Track> t, Type ty, framecnt_t d)
+			: track (t), type (ty), deadline (d) {}
+
+		bool operator< (DiskWork const& other) const { return deadline < other.deadline; }
+
+		boost::shared_ptr<Track> track;
+		Type                     type;
+		framecnt_t               deadline;
+	};
+
+	std::vector<DiskWork> _disk_work;
+
+	void queue_disk_work (boost::shared_ptr<RouteList>);
+	bool do_disk_work (uint32_t& errors);
 
 	/**
 	 * Add request to butler thread request queue
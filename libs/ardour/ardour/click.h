@@ -20,34 +20,37 @@
 #ifndef __ardour_click_h__
 #define __ardour_click_h__
 
-#include <list>
-
-#include "pbd/pool.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/io.h"
 
 namespace ARDOUR {
 
+/** A click sound that is being played */
 class LIBARDOUR_API Click {
 public:
 	framepos_t start;
 	framecnt_t duration;
 	framecnt_t offset;
 	const Sample *data;
+	gain_t gain;
 
-	Click (framepos_t s, framecnt_t d, const Sample *b) : start (s), duration (d), offset (0), data (b) {}
-
-	void *operator new (size_t) {
-		return pool.alloc ();
-    };
-
-	void operator delete(void *ptr, size_t /*size*/) {
-		pool.release (ptr);
-	}
+	Click () : start (0), duration (0), offset (0), data (0), gain (1.0) {}
+	Click (framepos_t s, framecnt_t d, const Sample *b, gain_t g = 1.0) : start (s), duration (d), offset (0), data (b), gain (g) {}
+};
 
-private:
-	static Pool pool;
+/** The position of a click, computed ahead of the playhead by the butler */
+struct LIBARDOUR_API ClickPoint {
+	enum Kind {
+		Emphasis,
+		Beat,
+		Subdivision
+	};
+
+	framepos_t frame;
+	guint      generation; ///< value of Session::_click_generation when this was queued
+	guint      lap;        ///< value of Session::_click_lap when the transport gets here
+	Kind       kind;
 };
 
 class LIBARDOUR_API ClickIO : public IO
@@ -0,0 +1,145 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_delay_locked_loop_h__
+#define __ardour_delay_locked_loop_h__
+
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** 2nd order delay locked loop, shared by the transport slaves.
+ *
+ * see http://www.kokkinizita.net/papers/usingdll.pdf
+ *
+ * The loop is unit-agnostic: t0, t1 and the period are in whatever
+ * unit the caller measures the error in (samples, seconds, ...).
+ *
+ * The bandwidth is given as omega = 2 * PI * B * tper, with B the loop
+ * bandwidth in Hz and tper the nominal update interval in seconds.
+ * Optionally the loop starts with a wider bandwidth which is narrowed
+ * down to the nominal one during the first updates: this locks faster
+ * and still has the noise rejection of the narrow loop once settled.
+ *
+ * While running, statistics of the loop error are collected, which
+ * give an estimate of the jitter of the source.
+ */
+class LIBARDOUR_API DelayLockedLoop
+{
+public:
+	DelayLockedLoop ();
+
+	/** @return the normalized bandwidth for a loop bandwidth of @param bandwidth Hz,
+	 * updated every @param interval seconds
+	 */
+	static double omega (double bandwidth, double interval);
+
+	/** set the bandwidth, the loop-state is retained */
+	void set_omega (double omega);
+
+	/** start with a bandwidth @param factor times the nominal one,
+	 * which approaches the nominal bandwidth during the first @param n_updates.
+	 * A factor of 1 (the default) disables this.
+	 */
+	void set_acquisition (double factor, uint32_t n_updates);
+
+	/** (re)start the loop.
+	 * @param t the current time
+	 * @param period the nominal duration until the next update
+	 */
+	void init (double t, double period);
+
+	/** advance the loop by one period
+	 * @param e loop error: measured minus expected time
+	 */
+	void update (double e)
+	{
+		if (_acquire_left > 0) {
+			update_acquisition ();
+		}
+		_t0 = _t1;
+		_t1 += _b * e + _e2;
+		_e2 += _c * e;
+		add_stats (e);
+	}
+
+	/** apply the loop-error (measured time minus t1), and advance by one period */
+	void update_at (double t) { update (t - _t1); }
+
+	bool   initialized () const { return _initialized; }
+
+	double t0 () const { return _t0; } ///< time at the beginning of the current period
+	double t1 () const { return _t1; } ///< expected time at the end of the current period
+	double e2 () const { return _e2; } ///< second order loop error: filtered period
+
+	/** @return filtered duration of the current period */
+	double period () const { return _t1 - _t0; }
+
+	/** @return the ratio of the filtered period to a given nominal period
+	 * (e.g. the speed of the source) */
+	double ratio (double nominal_period) const { return (_t1 - _t0) / nominal_period; }
+
+	/* statistics of the loop error, since init() or reset_stats() */
+	uint64_t n_updates () const { return _n_updates; }
+	double error_mean () const { return _err_mean; }
+	double error_max () const { return _err_max; }
+	double jitter () const; ///< standard deviation of the loop error
+
+	void reset_stats ();
+
+private:
+	void set_coefficients (double omega);
+	void update_acquisition ();
+
+	void add_stats (double e)
+	{
+		/* Welford's online mean and variance */
+		++_n_updates;
+		const double d = e - _err_mean;
+		_err_mean += d / (double) _n_updates;
+		_err_m2 += d * (e - _err_mean);
+		if (e > _err_max) {
+			_err_max = e;
+		} else if (-e > _err_max) {
+			_err_max = -e;
+		}
+	}
+
+	double _t0;
+	double _t1;
+	double _e2;
+	double _b, _c;  ///< filter coefficients
+	double _omega;
+
+	double   _acquire_factor;
+	uint32_t _acquire_updates;
+	uint32_t _acquire_left;
+	bool     _initialized;
+
+	uint64_t _n_updates;
+	double   _err_mean;
+	double   _err_m2;
+	double   _err_max;
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_delay_locked_loop_h__ */
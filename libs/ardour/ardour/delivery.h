@@ -20,6 +20,9 @@
 #define __ardour_delivery_h__
 
 #include <string>
+#include <vector>
+
+#include <glibmm/threads.h>
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
@@ -82,6 +85,23 @@ public:
 
 	BufferSet& output_buffers() { return *_output_buffers; }
 
+	/* Pipelined processing: ::run() writes to a private buffer, which is
+	 * delivered to the output ports one cycle later by ::deliver_pipelined().
+	 * Routes that read from our ports then need not wait for us to run.
+	 * See Session::resort_routes_using().
+	 *
+	 * ::prepare_pipeline() is called first, from a non-realtime thread,
+	 * then the process thread calls ::set_pipelined() when it picks up
+	 * the process graph that matches (see Graph::swap_chain()).
+	 */
+	bool prepare_pipeline (bool);
+	void set_pipelined (bool);
+	bool pipelined () const { return _pipelined; }
+	void deliver_pipelined (pframes_t nframes);
+
+	framecnt_t signal_latency () const;
+	int set_block_size (pframes_t);
+
 	PBD::Signal0<void> MuteChange;
 
 	XMLNode& state (bool full);
@@ -123,6 +143,19 @@ public:
 	void output_changed (IOChange, void*);
 
 	bool _no_panner_reset;
+
+	bool                  _pipelined;
+	bool                  _pipeline_wanted;
+	bool                  _pipeline_clear;
+	framecnt_t            _pipeline_delay;
+	framecnt_t            _pipeline_pos;
+	framecnt_t            _pipeline_advance;
+	std::vector<Sample*>  _pipeline_buffers;
+	Glib::Threads::Mutex  _pipeline_lock;
+
+	void reset_pipeline ();
+	void drop_pipeline ();
+	void write_pipeline (BufferSet&, pframes_t nframes);
 };
 
 
@@ -92,6 +92,15 @@ class LIBARDOUR_API Diskstream : public SessionObject, public PublicDiskstream
 	virtual float playback_buffer_load() const = 0;
 	virtual float capture_buffer_load() const = 0;
 
+	/** @return the size of each channel's playback and capture buffer, in frames */
+	virtual framecnt_t playback_buffer_size () const { return 0; }
+	virtual framecnt_t capture_buffer_size () const { return 0; }
+
+	/** @return how many frames of playback data are buffered ahead of the
+	 *  playback position, or max_framecnt if there is nothing left to read.
+	 */
+	virtual framecnt_t playback_frames_buffered () const = 0;
+
 	void set_flag (Flag f)   { _flags = Flag (_flags | f); }
 	void unset_flag (Flag f) { _flags = Flag (_flags & ~f); }
 
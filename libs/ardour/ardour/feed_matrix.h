@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_feed_matrix_h__
+#define __ardour_feed_matrix_h__
+
+#include <vector>
+#include <stdint.h>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** Transitive closure of the "feeds" relation of a set of nodes (routes),
+ *  addressed by index.
+ *
+ *  Direct edges are added with add(), close() then computes reachability,
+ *  after which feeds(), downstream() and upstream() are simple bit lookups.
+ *  A node feeds another "via sends only" if every path between the two
+ *  involves at least one send.
+ *
+ *  The session keeps one of these, rebuilt whenever the route graph is
+ *  resorted, so that solo propagation only has to visit the routes that
+ *  are actually in the signal flow of the soloed route.
+ */
+class LIBARDOUR_API FeedMatrix
+{
+public:
+	typedef boost::dynamic_bitset<uint64_t> Set;
+
+	FeedMatrix () {}
+
+	/** remove all edges and resize to @param n nodes */
+	void reset (uint32_t n);
+	uint32_t size () const { return _downstream.size (); }
+	void swap (FeedMatrix&);
+
+	/** add a direct edge; an edge not via sends wins over a sends-only one */
+	void add (uint32_t from, uint32_t to, bool via_sends_only);
+
+	/** compute the transitive closure of all edges added since reset() */
+	void close ();
+
+	/** @return true if @param from (directly or indirectly) feeds @param to.
+	 *  Only valid after close().
+	 */
+	bool feeds (uint32_t from, uint32_t to, bool* via_sends_only = 0) const;
+
+	/** nodes fed by @param n */
+	Set const& downstream (uint32_t n) const { return _downstream[n]; }
+	/** nodes fed by @param n via at least one path without sends */
+	Set const& downstream_audible (uint32_t n) const { return _audible[n]; }
+	/** nodes feeding @param n */
+	Set const& upstream (uint32_t n) const { return _upstream[n]; }
+	/** nodes feeding @param n via at least one path without sends */
+	Set const& upstream_audible (uint32_t n) const { return _upstream_audible[n]; }
+
+private:
+	std::vector<Set> _downstream;
+	std::vector<Set> _audible;
+	std::vector<Set> _upstream;
+	std::vector<Set> _upstream_audible;
+
+	static void transitive_closure (std::vector<Set>&);
+	static void transpose (std::vector<Set> const&, std::vector<Set>&);
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_feed_matrix_h__ */
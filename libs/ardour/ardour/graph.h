@@ -43,6 +43,7 @@ namespace ARDOUR
 class GraphNode;
 class Graph;
 
+class Delivery;
 class Route;
 class Session;
 class GraphEdges;
@@ -59,7 +60,8 @@ public:
 
 	void prep();
 	void trigger (GraphNode * n);
-	void rechain (boost::shared_ptr<RouteList>, GraphEdges const &);
+	void rechain (boost::shared_ptr<RouteList>, GraphEdges const &, std::set<boost::shared_ptr<Route> > const & pipelined);
+	void swap_chain ();
 
 	void dump (int chain);
 	void process();
@@ -85,6 +87,12 @@ public:
 
 	bool in_process_thread () const;
 
+	/** @return true if the graph's threads are running, so that
+	 *  process_routes(), silent_process_routes() and routes_no_roll()
+	 *  will actually run the routes.
+	 */
+	bool threads_in_use () const { return _threads_active; }
+
 protected:
 	virtual void session_going_away ();
 
@@ -124,6 +132,11 @@ private:
 	volatile int _pending_chain;
 	volatile int _setup_chain;
 
+	/** The pipelined state of each route's main outs that goes with
+	 *  the chain (see Delivery::set_pipelined)
+	 */
+	std::vector<std::pair<boost::shared_ptr<Delivery>, bool> > _pipeline_states[2];
+
 	// parameter caches.
 	pframes_t  _process_nframes;
 	framepos_t _process_start_frame;
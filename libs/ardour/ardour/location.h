@@ -24,6 +24,7 @@
 #include <list>
 #include <iostream>
 #include <map>
+#include <vector>
 
 #include <sys/types.h>
 
@@ -233,9 +234,48 @@ class LIBARDOUR_API Locations : public SessionHandleRef, public PBD::StatefulDes
 	Location            *current_location;
 	mutable Glib::Threads::Mutex  lock;
 
+	/** Position and name index of all locations, used for navigation
+	 *  and name lookups. It is marked out of date whenever a location is
+	 *  added, removed or modified, and rebuilt by the next query. The
+	 *  index refers to the locations themselves, so it must only be used
+	 *  with the lock held.
+	 */
+	struct Index {
+		struct Mark {
+			Mark (framepos_t p, Location* l, bool e)
+				: pos (p), end (l->end ()), location (l), flags (l->flags ()), is_end (e) {}
+
+			framepos_t      pos;
+			framepos_t      end;      ///< end of the location
+			Location*       location;
+			Location::Flags flags;
+			bool            is_end;   ///< pos is the end of a range
+
+			bool operator< (Mark const& other) const { return pos < other.pos; }
+			static bool before (Mark const& m, framepos_t p) { return m.pos < p; }
+			static bool after (framepos_t p, Mark const& m) { return p < m.pos; }
+		};
+
+		typedef std::vector<Mark> Marks;
+
+		Marks                    marks; ///< start (and end of ranges), sorted by position
+		std::vector<std::string> names; ///< sorted
+	};
+
+	mutable Index _index;
+	mutable gint  _index_dirty;
+
+	typedef std::map<Location*, boost::shared_ptr<PBD::ScopedConnectionList> > LocationConnections;
+	LocationConnections _location_connections;
+
+	Index const & index () const;
+	void rebuild_index () const;
+	void invalidate_index ();
+
 	int set_current_unlocked (Location *);
 	void location_changed (Location*);
 	void listen_to (Location*);
+	void stop_listening (Location*);
 };
 
 } // namespace ARDOUR
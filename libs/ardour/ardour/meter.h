@@ -19,11 +19,14 @@
 #ifndef __ardour_meter_h__
 #define __ardour_meter_h__
 
+#include <limits>
 #include <vector>
+#include <glib.h>
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/processor.h"
 #include "pbd/fastlog.h"
+#include "pbd/rcu.h"
 
 #include "ardour/kmeterdsp.h"
 #include "ardour/iec1ppmdsp.h"
@@ -63,6 +66,11 @@ public:
 	void reflect_inputs (const ChanCount& in);
 	void emit_configuration_changed ();
 
+	/** Release snapshot buffers retired by set_max_channels().
+	 * Must not be called from the process thread.
+	 */
+	void flush_snapshots () { _snapshots.flush (); }
+
 	/** Compute peaks */
 	void run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame, double speed, pframes_t nframes, bool);
 
@@ -72,6 +80,36 @@ public:
 	ChanCount input_streams () const { return current_meters; }
 	ChanCount output_streams () const { return current_meters; }
 
+	/** A consistent copy of all meter values of all channels.
+	 *
+	 * A snapshot is published by the process thread at the end of every
+	 * cycle and can be retrieved from any thread with snapshot(),
+	 * without locks and without tearing between channels.
+	 * All values are in dB, except for the peak of MIDI channels (0..1).
+	 * K, IEC and VU levels are the highest reading since the last
+	 * snapshot() or meter_level() call, as with the meters' read().
+	 */
+	struct LIBARDOUR_API Snapshot {
+		Snapshot () : seq (0), type (MeterPeak), n_midi (0), combined_peak (-std::numeric_limits<float>::infinity ()) {}
+
+		uint32_t           seq;  ///< incremented with every published snapshot
+		MeterType          type; ///< meter-type of the processor, determines @ref level
+		uint32_t           n_midi;
+		float              combined_peak; ///< highest peak of all channels (MeterMCP)
+		std::vector<float> peak;     ///< peak with falloff (MeterPeak)
+		std::vector<float> max_peak; ///< max. peak since reset_max() (MeterMaxPeak)
+		std::vector<float> level;    ///< K, IEC or VU meter reading, same as peak for other types
+
+		uint32_t n_channels () const { return peak.size (); }
+		float value (uint32_t n, MeterType t) const;
+	};
+
+	/** copy the most recent snapshot into @a s (this may allocate).
+	 * @return false if no snapshot was published yet
+	 */
+	bool snapshot (Snapshot& s) const;
+
+	/** @return the value of a single meter, from the most recent snapshot */
 	float meter_level (uint32_t n, MeterType type);
 
 	void set_type(MeterType t);
@@ -105,6 +143,21 @@ private:
 	std::vector<Vumeterdsp *> _vumeter;
 
 	MeterType _meter_type;
+
+	/* double buffer: the process thread writes the slot which is not
+	 * currently published, _snapshot_seq & 1 is the published one.
+	 * Resized copies are swapped in by set_max_channels(), readers keep
+	 * the one they are copying from alive.
+	 */
+	struct SnapshotSlots {
+		Snapshot slot[2];
+	};
+
+	SerializedRCUManager<SnapshotSlots> _snapshots;
+	gint                                _snapshot_seq;
+	mutable gint                        _level_read; ///< a reader has seen the K/IEC/VU levels, start over
+
+	void publish_snapshot ();
 };
 
 } // namespace ARDOUR
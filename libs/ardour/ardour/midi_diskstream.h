@@ -65,6 +65,7 @@ class LIBARDOUR_API MidiDiskstream : public Diskstream
 
 	float playback_buffer_load() const;
 	float capture_buffer_load() const;
+	framecnt_t playback_frames_buffered () const;
 
 	void flush_playback (framepos_t, framepos_t);
 
@@ -123,6 +124,7 @@ class LIBARDOUR_API MidiDiskstream : public Diskstream
 	void non_realtime_locate (framepos_t location);
 
 	static void set_readahead_frames (framecnt_t frames_ahead) { midi_readahead = frames_ahead; }
+	static framecnt_t readahead_frames () { return midi_readahead; }
 
   protected:
 	friend class MidiTrack;
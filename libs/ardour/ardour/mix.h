@@ -45,6 +45,9 @@ extern "C" {
 LIBARDOUR_API void  x86_sse_find_peaks                 (const float * buf, uint32_t nsamples, float *min, float *max);
 LIBARDOUR_API void  x86_sse_avx_find_peaks             (const float * buf, uint32_t nsamples, float *min, float *max);
 
+LIBARDOUR_API void  x86_sse_mix_buffers_with_fade      (float * dst, const float * src, const float * fade, const float * lower, const float * envelope, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_sse_avx_mix_buffers_with_fade  (float * dst, const float * src, const float * fade, const float * lower, const float * envelope, uint32_t nframes, float gain);
+
 /* debug wrappers for SSE functions */
 
 LIBARDOUR_API float debug_compute_peak               (const ARDOUR::Sample * buf, ARDOUR::pframes_t nsamples, float current);
@@ -73,5 +76,6 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample * buf, ARD
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector				  (ARDOUR::Sample * dst, const ARDOUR::Sample * src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_mix_buffers_with_fade     (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * fade, const ARDOUR::gain_t * lower, const ARDOUR::gain_t * envelope, ARDOUR::pframes_t nframes, float gain);
 
 #endif /* __ardour_mix_h__ */
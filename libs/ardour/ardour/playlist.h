@@ -169,6 +169,7 @@ public:
 	boost::shared_ptr<RegionList> regions_at (framepos_t frame);
 	uint32_t                   count_regions_at (framepos_t) const;
 	boost::shared_ptr<RegionList> regions_touched (framepos_t start, framepos_t end);
+	framecnt_t                 covered_length (framepos_t start, framepos_t end);
 	boost::shared_ptr<RegionList> regions_with_start_within (Evoral::Range<framepos_t>);
 	boost::shared_ptr<RegionList> regions_with_end_within (Evoral::Range<framepos_t>);
 	uint32_t                   region_use_count (boost::shared_ptr<Region>) const;
@@ -360,6 +361,9 @@ public:
 
 	virtual void remove_dependents (boost::shared_ptr<Region> /*region*/) {}
 
+	/** called when what a read() of (part of) @param range returns may have changed */
+	virtual void rendered_range_changed (Evoral::Range<framepos_t> const &) {}
+
 	virtual XMLNode& state (bool);
 
 	bool add_region_internal (boost::shared_ptr<Region>, framepos_t position, const int32_t sub_num = 0);
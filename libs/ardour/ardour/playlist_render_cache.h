@@ -0,0 +1,175 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __ardour_playlist_render_cache_h__
+#define __ardour_playlist_render_cache_h__
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/utility.hpp>
+#include <glibmm/threads.h>
+
+#include "evoral/Range.hpp"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** On-disk cache of what AudioPlaylist::read() returned.
+ *
+ * The timeline of every channel is divided into blocks of block_frames.
+ * For each block, one contiguous part of mixed-down playlist output can be
+ * kept, in a slot of a temporary file below the user's cache directory.
+ * A read() is only served from the cache if all of it is there.
+ *
+ * The playlist invalidate()s ranges whose content may have changed, as
+ * its regions are added, removed, moved, relayered or edited. This may
+ * happen in any thread and does not wait for disk i/o in progress: the
+ * ranges are noted, and the affected blocks dropped by the next read() or
+ * write(). Data that was rendered while an invalidation happened is not
+ * stored, see generation().
+ *
+ * write() only queues the data. A thread shared by all caches writes it
+ * to disk, so that the butler does not wait for disk i/o on behalf of
+ * the cache, and without holding the lock that read() takes. The size of
+ * all cache files together is limited.
+ */
+class LIBARDOUR_API PlaylistRenderCache : public boost::noncopyable
+{
+  public:
+	PlaylistRenderCache ();
+	~PlaylistRenderCache ();
+
+	static const framecnt_t block_frames;
+
+	/** @return true if all of [start, start + cnt) of channel @param chan
+	 * was in the cache and has been copied to @param dst
+	 */
+	bool read (Sample* dst, framepos_t start, framecnt_t cnt, uint32_t chan);
+
+	/** keep [start, start + cnt) of channel @param chan, unless anything was
+	 * invalidated after @param generation was taken. The data is copied
+	 * and stored later; it is dropped if too much is waiting to be stored.
+	 */
+	void write (Sample const* src, framepos_t start, framecnt_t cnt, uint32_t chan, uint32_t generation);
+
+	/** wait until all data passed to write() has been stored (or dropped) */
+	void flush ();
+
+	/** @return a token to take before rendering data that is to be write()n */
+	uint32_t generation () const;
+
+	void invalidate (Evoral::Range<framepos_t> const&);
+	void clear ();
+
+	/** limit the size of the cache files of all playlists together;
+	 * blocks that do not fit are not kept
+	 */
+	static void set_max_frames (framecnt_t);
+
+	/** write what is still queued and stop the thread that writes the
+	 * cache files; it is started again by the next write()
+	 */
+	static void stop_writer_thread ();
+
+	struct Stats {
+		Stats () : hits (0), misses (0), blocks (0), invalidated (0) {}
+
+		uint64_t hits;
+		uint64_t misses;
+		uint32_t blocks;      ///< blocks currently in the cache
+		uint64_t invalidated; ///< blocks dropped due to invalidation
+	};
+
+	Stats stats () const;
+
+  private:
+	struct Block {
+		Block () : slot (0), from (0), to (0) {}
+
+		uint32_t   slot; ///< position of the block in the cache file
+		framecnt_t from; ///< the cached part of the block is [from, to)
+		framecnt_t to;
+	};
+
+	/* block index, channel */
+	typedef std::pair<framepos_t, uint32_t> BlockKey;
+	typedef std::map<BlockKey, Block> Blocks;
+
+	mutable Glib::Threads::Mutex _lock;
+	Blocks                       _blocks;
+	std::vector<uint32_t>        _free_slots;
+	uint32_t                     _n_slots;
+	bool                         _failed; ///< the cache file could not be created
+	int                          _fd;
+	uint32_t                     _slot_epoch; ///< incremented by release_slots()
+	std::string                  _path;
+#ifdef PLATFORM_WINDOWS
+	Glib::Threads::Mutex         _io_lock;
+#endif
+	Stats                        _stats;
+
+	/* invalidations not yet applied to _blocks */
+	Glib::Threads::Mutex          _pending_lock;
+	Evoral::RangeList<framepos_t> _pending;
+	bool                          _pending_clear;
+	mutable gint                  _generation;
+
+	void apply_pending ();
+	void drop (Blocks::iterator);
+	bool open_file ();
+	bool io (Block const&, Sample*, framecnt_t offset, framecnt_t cnt, bool write);
+	void release_slots ();
+
+	struct WriteJob {
+		PlaylistRenderCache* cache;
+		framepos_t           start;
+		uint32_t             chan;
+		uint32_t             generation;
+		std::vector<Sample>  data;
+	};
+
+	void store (WriteJob&);
+	bool queued () const;
+
+	/* slots of all cache files together */
+	static gint _total_slots;
+	static gint _max_total_slots;
+
+	static bool reserve_slot ();
+
+	/* data waiting to be written to disk, by writer_thread() */
+	static Glib::Threads::Mutex    _queue_lock;
+	static Glib::Threads::Cond     _queue_cond;
+	static std::list<WriteJob*>    _queue;
+	static framecnt_t              _queued_frames;
+	static PlaylistRenderCache*    _storing; ///< the cache writer_thread() is busy with
+	static Glib::Threads::Thread*  _writer;
+	static bool                    _writer_quit;
+
+	static void writer_thread ();
+};
+
+} /* namespace ARDOUR */
+
+#endif /* __ardour_playlist_render_cache_h__ */
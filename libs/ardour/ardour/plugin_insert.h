@@ -36,6 +36,7 @@
 #include "ardour/processor.h"
 #include "ardour/sidechain.h"
 #include "ardour/automation_control.h"
+#include "ardour/automation_schedule.h"
 
 class XMLNode;
 
@@ -249,6 +250,10 @@ class LIBARDOUR_API PluginInsert : public Processor
 
 	void collect_signal_for_analysis (framecnt_t nframes);
 
+	AutomationSchedule::Stats automation_stats () const {
+		return _automation_schedule.stats ();
+	}
+
 	bool strict_io_configured () const {
 		return _match.strict_io;
 	}
@@ -350,6 +355,9 @@ class LIBARDOUR_API PluginInsert : public Processor
 	PinMappings _out_map;
 	ChanMapping _thru_map; // out-idx <=  in-idx
 
+	/** plays back the automation of our controls, see connect_and_run() */
+	AutomationSchedule _automation_schedule;
+
 	void automation_run (BufferSet& bufs, framepos_t start, framepos_t end, double speed, pframes_t nframes);
 	void connect_and_run (BufferSet& bufs, framepos_t start, framecnt_t end, double speed, pframes_t nframes, framecnt_t offset, bool with_auto);
 	void bypass (BufferSet& bufs, pframes_t nframes);
@@ -29,6 +29,8 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <glibmm/threads.h>
+
 #include "pbd/rcu.h"
 
 #include "ardour/chan_count.h"
@@ -61,6 +63,43 @@ class LIBARDOUR_API PortManager
 	boost::shared_ptr<Port> register_output_port (DataType, const std::string& portname, bool async = false);
 	int unregister_port (boost::shared_ptr<Port>);
 
+	/** Between begin_registration_batch() and end_registration_batch()
+	 * newly registered ports are kept aside and added to the port-map in
+	 * one go. Without this every registration copies the complete
+	 * port-map, which is quadratic when creating many routes at once.
+	 *
+	 * Batches nest. Ports of a batch are not processed by cycle_start()
+	 * or cycle_end() until the outermost batch is complete, so they must
+	 * not be used by any route that is already being processed.
+	 * Other than that they are treated like registered ports.
+	 *
+	 * Use a RegistrationBatch rather than calling these directly.
+	 */
+	void begin_registration_batch ();
+	void end_registration_batch ();
+
+	/** Keeps a registration batch open until end() is called or
+	 * it goes out of scope, whichever is first.
+	 */
+	class RegistrationBatch {
+	  public:
+		RegistrationBatch (PortManager& pm) : _pm (pm), _open (true) {
+			_pm.begin_registration_batch ();
+		}
+		~RegistrationBatch () {
+			end ();
+		}
+		void end () {
+			if (_open) {
+				_open = false;
+				_pm.end_registration_batch ();
+			}
+		}
+	  private:
+		PortManager& _pm;
+		bool         _open;
+	};
+
 	/* Port connectivity */
 
 	int  connect (const std::string& source, const std::string& destination);
@@ -140,6 +179,14 @@ class LIBARDOUR_API PortManager
 	SerializedRCUManager<Ports> ports;
 	bool _port_remove_in_progress;
 
+	/* ports registered during a RegistrationBatch */
+	Ports                _pending_ports;
+	uint32_t             _registration_batch_depth;
+	Glib::Threads::Mutex _pending_ports_lock;
+
+	boost::shared_ptr<Port> find_pending_port (const std::string& relative_name);
+	boost::shared_ptr<Ports> all_ports ();
+
 	boost::shared_ptr<Port> register_port (DataType type, const std::string& portname, bool input, bool async = false);
 	void port_registration_failure (const std::string& portname);
 
@@ -94,6 +94,11 @@ CONFIG_VARIABLE (float, midi_readahead,  "midi-readahead", 1.0)
 CONFIG_VARIABLE (BufferingPreset, buffering_preset, "buffering-preset", Medium)
 CONFIG_VARIABLE (float, audio_capture_buffer_seconds, "capture-buffer-seconds", 5.0)
 CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds", 5.0)
+CONFIG_VARIABLE (bool, adaptive_playback_buffering, "adaptive-playback-buffering", true)
+CONFIG_VARIABLE (float, audio_playback_history_seconds, "playback-history-seconds", 1.0)
+CONFIG_VARIABLE (bool, playlist_render_cache, "playlist-render-cache", false)
+CONFIG_VARIABLE (uint32_t, playlist_render_cache_mb, "playlist-render-cache-mb", 256)
+CONFIG_VARIABLE (bool, live_peaks_in_own_thread, "live-peaks-in-own-thread", true)
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
 CONFIG_VARIABLE (uint32_t, disk_choice_space_threshold,  "disk-choice-space-threshold", 57600000)
 CONFIG_VARIABLE (bool, auto_analyse_audio, "auto-analyse-audio", false)
@@ -150,6 +155,7 @@ CONFIG_VARIABLE (std::string, click_sound, "click-sound", "")
 CONFIG_VARIABLE (std::string, click_emphasis_sound, "click-emphasis-sound", "")
 CONFIG_VARIABLE (gain_t, click_gain, "click-gain", 1.0)
 CONFIG_VARIABLE (bool, use_click_emphasis, "use-click-emphasis", true)
+CONFIG_VARIABLE (uint32_t, click_subdivisions, "click-subdivisions", 1)
 
 /* transport control and related */
 
@@ -221,6 +227,7 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+CONFIG_VARIABLE (bool, pipelined_processing, "pipelined-processing", false)
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
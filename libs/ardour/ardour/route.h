@@ -191,6 +191,7 @@ public:
 	boost::shared_ptr<DelayLine> delay_line() const  { return _delayline; }
 
 	void flush_processors ();
+	void flush_meter_snapshots ();
 
 	void foreach_processor (boost::function<void(boost::weak_ptr<Processor>)> method) {
 		Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
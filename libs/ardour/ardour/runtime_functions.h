@@ -31,6 +31,7 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)		(ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)			    (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*mix_buffers_with_fade_t)	(ARDOUR::Sample *, const ARDOUR::Sample *, const ARDOUR::gain_t *, const ARDOUR::gain_t *, const ARDOUR::gain_t *, pframes_t, float);
 
 	LIBARDOUR_API extern compute_peak_t		compute_peak;
 	LIBARDOUR_API extern find_peaks_t               find_peaks;
@@ -38,6 +39,12 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t	mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t	mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t			copy_vector;
+
+	/** dst[i] = dst[i] * lower[i] + src[i] * envelope[i] * gain * fade[i]
+	 *  @param lower gain for the existing content of dst; may be 0 (unity)
+	 *  @param envelope may be 0 (unity)
+	 */
+	LIBARDOUR_API extern mix_buffers_with_fade_t	mix_buffers_with_fade;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
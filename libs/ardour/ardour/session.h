@@ -44,6 +44,7 @@
 #include "pbd/event_loop.h"
 #include "pbd/rcu.h"
 #include "pbd/reallocpool.h"
+#include "pbd/ringbuffer.h"
 #include "pbd/statefuldestructible.h"
 #include "pbd/signals.h"
 #include "pbd/undo.h"
@@ -60,6 +61,7 @@
 #include "ardour/ardour.h"
 #include "ardour/chan_count.h"
 #include "ardour/delivery.h"
+#include "ardour/feed_matrix.h"
 #include "ardour/interthread_info.h"
 #include "ardour/luascripting.h"
 #include "ardour/location.h"
@@ -113,6 +115,7 @@ class BufferSet;
 class Bundle;
 class Butler;
 class Click;
+struct ClickPoint;
 class ControllableDescriptor;
 class Diskstream;
 class ExportHandler;
@@ -267,6 +270,8 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	void refill_all_track_buffers ();
 	Butler* butler() { return _butler; }
 	void butler_transport_work ();
+	/** compute upcoming click positions, called by the butler */
+	void queue_clicks ();
 
 	void refresh_disk_space ();
 
@@ -794,6 +799,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	void cancel_all_solo ();
 
 	static const SessionEvent::RTeventCallback rt_cleanup;
+	static const SessionEvent::RTeventCallback rt_controls_cleanup;
 
 	void clear_all_solo_state (boost::shared_ptr<RouteList>);
 
@@ -945,6 +951,25 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	uint32_t playback_load ();
 	uint32_t capture_load ();
 
+	/** @return memory used by the playback and capture buffers of all tracks, in kB */
+	uint32_t playback_buffer_memory () const;
+	uint32_t capture_buffer_memory () const;
+
+	/** @return how often, summed over all tracks, the butler found a
+	 *  playback buffer close to running dry while rolling. See
+	 *  Track::near_underruns()
+	 */
+	uint32_t near_underruns () const;
+
+	/** @return time from a locate until the tracks were ready to play from
+	 *  the new position, in microseconds: of the most recent locate, and
+	 *  the mean and maximum since the last reset_locate_latency()
+	 */
+	uint32_t locate_latency_last () const;
+	uint32_t locate_latency_mean () const;
+	uint32_t locate_latency_max () const;
+	void reset_locate_latency ();
+
 	/* ranges */
 
 	void request_play_range (std::list<AudioRange>*, bool leave_rolling = false);
@@ -1286,6 +1311,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	void get_track_statistics ();
 	int  process_routes (pframes_t, bool& need_butler);
 	int  silent_process_routes (pframes_t, bool& need_butler);
+	void deliver_pipelined_outputs (pframes_t);
 
 	/** @return 1 if there is a pending declick fade-in,
 	    -1 if there is a pending declick fade-out,
@@ -1398,6 +1424,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	void schedule_playback_buffering_adjustment ();
 	void schedule_capture_buffering_adjustment ();
+	void adapt_playback_buffering ();
 
 	uint32_t    cumulative_rf_motion;
 	uint32_t    rf_scale;
@@ -1475,7 +1502,14 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	pthread_mutex_t _rt_emit_mutex;
 	pthread_cond_t  _rt_emit_cond;
-	bool            _rt_emit_pending;
+	gint            _rt_emit_pending;
+
+	/* pipelined processing: set if a track's eligibility was changed
+	 * by an rt-control, handled by ::rt_controls_done() (resort_routes)
+	 */
+	gint            _pipeline_update_pending;
+	gint            _pipelined_routes_changed;
+	void queue_pipeline_update ();
 
 	/* Auto Connect Thread */
 	static void *auto_connect_thread (void *);
@@ -1636,6 +1670,7 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	void non_realtime_stop (bool abort, int entry_request_count, bool& finished);
 	void non_realtime_overwrite (int entry_request_count, bool& finished);
 	void post_transport ();
+	void note_locate_latency ();
 	void engine_halted ();
 	void xrun_recovery ();
 	void set_track_loop (bool);
@@ -1806,6 +1841,18 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	mutable gint _playback_load;
 	mutable gint _capture_load;
+	mutable gint _playback_buffer_memory;
+	mutable gint _capture_buffer_memory;
+	mutable gint _near_underruns;
+
+	/* locate latency, see note_locate_latency() */
+	gint64       _locate_start;
+	gint64       _locate_latency_total;
+	uint32_t     _locates;
+	mutable gint _locate_latency_last;
+	mutable gint _locate_latency_mean;
+	mutable gint _locate_latency_max;
+	mutable gint _locate_latency_reset;
 
 	/* I/O bundles */
 
@@ -1830,9 +1877,38 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 
 	XMLNode& state(bool);
 
-	/* click track */
-	typedef std::list<Click*> Clicks;
-	Clicks                  clicks;
+	/* click track.
+	 *
+	 * The butler computes click positions ahead of the playhead into
+	 * _click_queue (see queue_clicks()), the process thread plays them
+	 * using a fixed set of voices. Entries of a previous generation are
+	 * ignored: a locate or tempo-map change only has to increment
+	 * _click_generation. While looping seamlessly, the clicks after the
+	 * loop start are queued ahead of time; the process thread counts
+	 * the loop's laps in _click_lap, which every entry carries too.
+	 */
+	static const uint32_t   max_click_voices = 16;
+	Click*                 _click_voices;
+	uint32_t               _n_click_voices;
+	PBD::RingBuffer<ClickPoint>* _click_queue;
+	gint                   _click_generation;
+	gint                   _click_lap;
+	gint                   _click_queued_generation;
+	/* where the process thread asks for more, written by the butler
+	 * between two increments of _click_refill_seq (odd: being written)
+	 */
+	gint                   _click_refill_seq;
+	framepos_t             _click_refill_at;
+	guint                  _click_refill_lap;
+	gint                   _click_refill_requested;
+	/* butler thread only */
+	guint                  _click_fill_generation;
+	framepos_t             _click_fill_pos;
+	guint                  _click_fill_lap;
+	framepos_t             _click_fill_loop_start;
+	framepos_t             _click_fill_loop_end;
+	framepos_t             _click_last_beat;
+
 	bool                   _clicking;
 	boost::shared_ptr<IO>  _click_io;
 	boost::shared_ptr<Amp> _click_gain;
@@ -1847,12 +1923,13 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	static const Sample     default_click_emphasis[];
 	static const framecnt_t default_click_emphasis_length;
 
-	Click *get_click();
 	framepos_t _clicks_cleared;
 	void   setup_click_sounds (int which);
 	void   setup_click_sounds (Sample**, Sample const *, framecnt_t*, framecnt_t, std::string const &);
 	void   clear_clicks ();
+	void   drop_clicks ();
 	void   click (framepos_t start, framecnt_t nframes);
+	void   start_click (ClickPoint const&);
 
 	std::vector<Route*> master_outs;
 
@@ -1946,13 +2023,14 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	SessionEvent* get_rt_event (boost::shared_ptr<ControlList> cl, double arg, PBD::Controllable::GroupControlDisposition group_override) {
 		SessionEvent* ev = new SessionEvent (SessionEvent::RealTimeOperation, SessionEvent::Add, SessionEvent::Immediate, 0, 0.0);
 		ev->rt_slot = boost::bind (&Session::rt_set_controls, this, cl, arg, group_override);
-		ev->rt_return = Session::rt_cleanup;
+		ev->rt_return = Session::rt_controls_cleanup;
 		ev->event_loop = PBD::EventLoop::get_event_loop_for_thread ();
 
 		return ev;
 	}
 
 	void rt_set_controls (boost::shared_ptr<ControlList>, double val, PBD::Controllable::GroupControlDisposition group_override);
+	static void rt_controls_done (SessionEvent*);
 	void rt_clear_all_solo_state (boost::shared_ptr<RouteList>, bool yn, PBD::Controllable::GroupControlDisposition group_override);
 
 	/** temporary list of Diskstreams used only during load of 2.X sessions */
@@ -1984,6 +2062,14 @@ class LIBARDOUR_API Session : public PBD::StatefulDestructible, public PBD::Scop
 	*/
 	GraphEdges _current_route_graph;
 
+	/** Transitive closure of _current_route_graph, indexed by
+	    _route_feed_index; rebuilt by resort_routes_using().
+	*/
+	FeedMatrix                            _route_feeds;
+	std::vector<boost::weak_ptr<Route> >  _route_feed_routes;
+	std::map<Route const*, uint32_t>      _route_feed_index;
+	Glib::Threads::Mutex                  _route_feeds_lock;
+
 	void ensure_route_presentation_info_gap (PresentationInfo::order_t, uint32_t gap_size);
 	bool ignore_route_processor_changes;
 
@@ -30,6 +30,7 @@
 
 #include "timecode/time.h"
 
+#include "ardour/delay_locked_loop.h"
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "midi++/parser.h"
@@ -309,18 +310,12 @@ class LIBARDOUR_API MTC_Slave : public TimecodeSlave {
 	bool           printed_timecode_warning;
 	frameoffset_t  current_delta;
 
-	/* DLL - chase MTC */
-	double t0; ///< time at the beginning of the MTC quater frame
-	double t1; ///< calculated end of the MTC quater frame
-	double e2; ///< second order loop error
-	double b, c, omega; ///< DLL filter coefficients
+	/* DLL - chase MTC, t0/t1: begin/end of the MTC quarter frame */
+	DelayLockedLoop mtc_dll;
 
 	/* DLL - sync engine */
 	int    engine_dll_initstate;
-	double te0; ///< time at the beginning of the engine process
-	double te1; ///< calculated sync time
-	double ee2; ///< second order loop error
-	double be, ce, oe; ///< DLL filter coefficients
+	DelayLockedLoop engine_dll;
 
 	void reset (bool with_pos);
 	void queue_reset (bool with_pos);
@@ -401,10 +396,7 @@ public:
 	/* DLL - chase LTC */
 	int    transport_direction;
 	int    engine_dll_initstate;
-	double t0; ///< time at the beginning of the MTC quater frame
-	double t1; ///< calculated end of the MTC quater frame
-	double e2; ///< second order loop error
-	double b, c; ///< DLL filter coefficients
+	DelayLockedLoop engine_dll;
 };
 
 class LIBARDOUR_API MIDIClock_Slave : public Slave {
@@ -450,26 +442,13 @@ class LIBARDOUR_API MIDIClock_Slave : public Slave {
 	/// since start
 	long midi_clock_count;
 
-	//the delay locked loop (DLL), see www.kokkinizita.net/papers/usingdll.pdf
-
-	/// time at the beginning of the MIDI clock frame
-	double t0;
-
-	/// calculated end of the MIDI clock frame
-	double t1;
-
-	/// loop error = real value - expected value
-	double e;
-
-	/// second order loop error
-	double e2;
+	/// the delay locked loop (DLL), in seconds:
+	/// t0/t1 are the beginning and calculated end of the MIDI clock frame
+	DelayLockedLoop dll;
 
 	/// DLL filter bandwidth
 	double bandwidth;
 
-	/// DLL filter coefficients
-	double b, c, omega;
-
 	frameoffset_t  current_delta;
 
 	void reset ();
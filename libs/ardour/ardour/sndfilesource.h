@@ -56,6 +56,8 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	int flush_header ();
 	void flush ();
 
+	void mark_streaming_write_completed (const Lock& lock);
+
 	framepos_t natural_position () const;
 
 	framepos_t last_capture_start_frame() const;
@@ -73,6 +75,12 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	static void setup_standard_crossfades (Session const &, framecnt_t sample_rate);
 	static const Source::Flag default_writable_flags;
 
+	/** read uncompressed float, 16 and 24 bit files which are no longer
+	 * written to via a memory-map instead of libsndfile (default: on)
+	 */
+	static void set_use_mmap (bool yn) { _use_mmap = yn; }
+	static bool use_mmap () { return _use_mmap; }
+
 	static int get_soundfile_info (const std::string& path, SoundFileInfo& _info, std::string& error_msg);
 
   protected:
@@ -89,8 +97,28 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SNDFILE* _sndfile;
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
+	int            _fd;
+	framecnt_t     _preallocated;
+
+	enum MapState {
+		MapUnknown,
+		MapUnsupported,
+		Mapped
+	};
+
+	mutable MapState    _map_state;
+	mutable char*       _map;
+	mutable size_t      _map_length;
+	mutable const char* _map_data;
+	mutable size_t      _map_advised; ///< end of the range passed to madvise()
+	static bool         _use_mmap;
 
 	void init_sndfile ();
+	void preallocate (framepos_t end);
+	void release_preallocation ();
+	void setup_mmap () const;
+	void drop_mmap ();
+	bool read_mapped (Sample* dst, framepos_t start, framecnt_t cnt) const;
 	int open();
 	int setup_broadcast_info (framepos_t when, struct tm&, time_t);
 	void file_closed ();
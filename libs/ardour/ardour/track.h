@@ -80,6 +80,12 @@ class LIBARDOUR_API Track : public Route, public Recordable, public PublicDiskst
 
 	bool can_record();
 
+	/** @return true if the track plays back only, and its output feeds
+	 * other routes only via its output ports. The output can then be
+	 * delivered a cycle late (see Session::resort_routes_using()).
+	 */
+	bool can_be_pipelined () const;
+
 	void use_new_diskstream ();
 	virtual boost::shared_ptr<Diskstream> create_diskstream() = 0;
 	virtual void set_diskstream (boost::shared_ptr<Diskstream>);
@@ -154,6 +160,17 @@ class LIBARDOUR_API Track : public Route, public Recordable, public PublicDiskst
 	void reset_write_sources (bool, bool force = false);
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
+	framecnt_t playback_buffer_size () const;
+	framecnt_t capture_buffer_size () const;
+	framecnt_t playback_frames_buffered () const;
+
+	/** @return the number of times the butler found the playback buffer
+	 * close to running dry while the transport was rolling
+	 */
+	uint32_t near_underruns () const { return g_atomic_int_get (&_near_underruns); }
+	void reset_near_underruns () { g_atomic_int_set (&_near_underruns, 0); }
+	void note_near_underrun () { g_atomic_int_inc (&_near_underruns); }
+
 	int do_refill ();
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (bool);
@@ -255,6 +272,7 @@ private:
 	void parameter_changed (std::string const & p);
 
 	std::string _diskstream_name;
+	mutable gint _near_underruns;
 };
 
 }; /* namespace ARDOUR*/
@@ -18,9 +18,11 @@
     $Id$
 */
 
+#include <cstring>
 #include <iostream>
 #include <vector>
 
+#include <glibmm/threads.h>
 #include <glibmm/timer.h>
 
 #include "pbd/error.h"
@@ -28,6 +30,8 @@
 
 #include "midi++/types.h"
 
+#include "evoral/midi_util.h"
+
 #include "ardour/async_midi_port.h"
 #include "ardour/audioengine.h"
 #include "ardour/midi_buffer.h"
@@ -39,6 +43,9 @@ using namespace PBD;
 
 pthread_t AsyncMIDIPort::_process_thread;
 
+/* see AsyncMIDIPort::write() */
+static Glib::Threads::Private<AsyncMIDIPort::OutputEvent> thread_output_event;
+
 #define port_engine AudioEngine::instance()->port_engine()
 
 AsyncMIDIPort::AsyncMIDIPort (string const & name, PortFlags flags)
@@ -50,6 +57,7 @@ AsyncMIDIPort::AsyncMIDIPort (string const & name, PortFlags flags)
 	, output_fifo (2048)
 	, input_fifo (1024)
 	, _xthread (true)
+	, _output_events_dropped (0)
 {
 }
 
@@ -67,44 +75,43 @@ AsyncMIDIPort::set_timer (boost::function<MIDI::framecnt_t (void)>& f)
 void
 AsyncMIDIPort::flush_output_fifo (MIDI::pframes_t nframes)
 {
-	RingBuffer< Evoral::Event<double> >::rw_vector vec = { { 0, 0 }, { 0, 0 } };
-	size_t written = 0;
+	const guint n = output_fifo.read_space ();
 
-	output_fifo.get_read_vector (&vec);
+	if (n == 0) {
+		return;
+	}
 
 	MidiBuffer& mb (get_midi_buffer (nframes));
-
-	if (vec.len[0]) {
-		Evoral::Event<double>* evp = vec.buf[0];
-
-		assert (evp->size());
-		assert (evp->buffer());
-
-		for (size_t n = 0; n < vec.len[0]; ++n, ++evp) {
-			if (mb.push_back (evp->time(), evp->size(), evp->buffer())) {
-				written++;
-			}
+	guint written = 0;
+
+	while (written < n) {
+		OutputEvent const & ev (output_fifo.read_peek (written));
+
+		assert (ev.size);
+		assert (ev.buf);
+
+		if (!Evoral::midi_event_is_valid (ev.buf, ev.size) ||
+		    ev.size + sizeof (MidiBuffer::TimeType) >= mb.capacity()) {
+			/* this will never make it into any buffer: drop it, so
+			 * that it does not hold up everything after it.
+			 */
+			g_atomic_int_inc (&_output_events_dropped);
+			++written;
+			continue;
 		}
-	}
 
-	if (vec.len[1]) {
-		Evoral::Event<double>* evp = vec.buf[1];
-
-		assert (evp->size());
-		assert (evp->buffer());
-
-		for (size_t n = 0; n < vec.len[1]; ++n, ++evp) {
-			if (mb.push_back (evp->time(), evp->size(), evp->buffer())) {
-				written++;
-			}
+		if (!mb.push_back (ev.time, ev.size, ev.buf)) {
+			/* buffer is full, leave the rest for the next flush */
+			break;
 		}
+		++written;
 	}
 
-	/* do this "atomically" after we're done pushing events into the
-	 * MidiBuffer
+	/* hand all slots back to the writers at once, after we're done
+	 * pushing events into the MidiBuffer
 	 */
 
-	output_fifo.increment_read_idx (written);
+	output_fifo.read_release (written);
 }
 
 void
@@ -170,8 +177,6 @@ AsyncMIDIPort::cycle_end (MIDI::pframes_t nframes)
 void
 AsyncMIDIPort::drain (int check_interval_usecs, int total_usecs_to_wait)
 {
-	RingBuffer< Evoral::Event<double> >::rw_vector vec = { { 0, 0 }, { 0, 0} };
-
 	if (!AudioEngine::instance()->running() || AudioEngine::instance()->session() == 0) {
 		/* no more process calls - it will never drain */
 		return;
@@ -187,8 +192,7 @@ AsyncMIDIPort::drain (int check_interval_usecs, int total_usecs_to_wait)
 	microseconds_t end = now + total_usecs_to_wait;
 
 	while (now < end) {
-		output_fifo.get_write_vector (&vec);
-		if (vec.len[0] + vec.len[1] >= output_fifo.bufsize() - 1) {
+		if (output_fifo.empty ()) {
 			break;
 		}
 		Glib::usleep (check_interval_usecs);
@@ -216,38 +220,46 @@ AsyncMIDIPort::write (const MIDI::byte * msg, size_t msglen, MIDI::timestamp_t t
 			_parser->scanner (msg[n]);
 		}
 
-		Glib::Threads::Mutex::Lock lm (output_fifo_lock);
-		RingBuffer< Evoral::Event<double> >::rw_vector vec = { { 0, 0 }, { 0, 0} };
+		/* build the event in this thread's staging event first: a
+		   writer that is pre-empted while it holds a reserved slot
+		   holds up every slot after it (e.g. MIDI clock from another
+		   thread), so only a swap may happen between reserve and commit.
+		   The staging buffer is re-used and only ever grows.
+		*/
+		OutputEvent* staged = thread_output_event.get ();
+
+		if (!staged) {
+			staged = new OutputEvent;
+			thread_output_event.set (staged);
+		}
+
+		if (staged->capacity < msglen) {
+			MIDI::byte* b = (MIDI::byte*) realloc (staged->buf, msglen);
+			if (!b) {
+				return 0;
+			}
+			staged->buf = b;
+			staged->capacity = msglen;
+		}
+
+		memcpy (staged->buf, msg, msglen);
+		staged->size = msglen;
+		staged->time = timestamp;
 
-		output_fifo.get_write_vector (&vec);
+		guint id;
+		OutputEvent* ev = output_fifo.write_reserve (id);
 
-		if (vec.len[0] + vec.len[1] < 1) {
+		if (!ev) {
 			error << "no space in FIFO for non-process thread MIDI write" << endmsg;
 			return 0;
 		}
 
-		if (vec.len[0]) {
-			/* force each event inside the ringbuffer to own its
-			   own buffer, but let that be null and of zero size
-			   initially. When ::set() is called, the buffer will
-			   be allocated to hold a *copy* of the data we're
-			   storing, and then that buffer will be used over and
-			   over, occasionally being upwardly resized as
-			   necessary.
-			*/
-			if (!vec.buf[0]->owns_buffer()) {
-                                vec.buf[0]->set_buffer (0, 0, true);
-                        }
-			vec.buf[0]->set (msg, msglen, timestamp);
-		} else {
-			/* see comment in previous branch of if() statement */
-			if (!vec.buf[1]->owns_buffer()) {
-                                vec.buf[1]->set_buffer (0, 0, true);
-                        }
-			vec.buf[1]->set (msg, msglen, timestamp);
-		}
+		/* the slot gets the staged buffer, the staging event the
+		   slot's old one, for the next write from this thread.
+		*/
+		ev->swap (*staged);
 
-		output_fifo.increment_write_idx (1);
+		output_fifo.write_commit (id);
 
 		ret = msglen;
 
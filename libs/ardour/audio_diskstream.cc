@@ -33,6 +33,7 @@
 #include "pbd/memento_command.h"
 #include "pbd/enumwriter.h"
 #include "pbd/stateful_diff_command.h"
+#include "pbd/rt_monitor.h"
 
 #include "ardour/analyser.h"
 #include "ardour/audio_buffer.h"
@@ -66,9 +67,28 @@ using namespace PBD;
 Sample* AudioDiskstream::_mixdown_buffer       = 0;
 gain_t* AudioDiskstream::_gain_buffer          = 0;
 
+/* max. number of disk_write_chunk_frames written per channel by a single do_flush() */
+const framecnt_t AudioDiskstream::capture_flush_chunks    = 4;
+/* while recording, file-writes are a multiple of this (in samples) */
+const framecnt_t AudioDiskstream::capture_write_alignment = 4096;
+
+AudioDiskstream::CaptureStats AudioDiskstream::_capture_stats;
+Glib::Threads::Mutex AudioDiskstream::_capture_stats_lock;
+AudioDiskstream::SeekStats AudioDiskstream::_seek_stats;
+Glib::Threads::Mutex AudioDiskstream::_seek_stats_lock;
+
 AudioDiskstream::AudioDiskstream (Session &sess, const string &name, Diskstream::Flag flag)
 	: Diskstream(sess, name, flag)
 	, channels (new ChannelList)
+	, _flush_buffer (0)
+	, _flush_buffer_size (0)
+	, _playback_buffer_scale (1.0)
+	, _frames_read (0)
+	, _frames_rolled (0)
+	, _read_start (max_framepos)
+	, _read_end (0)
+	, _buffer_start (max_framepos)
+	, _history_frames (0)
 {
 	/* prevent any write sources from being created */
 
@@ -84,6 +104,15 @@ AudioDiskstream::AudioDiskstream (Session &sess, const string &name, Diskstream:
 AudioDiskstream::AudioDiskstream (Session& sess, const XMLNode& node)
 	: Diskstream(sess, node)
 	, channels (new ChannelList)
+	, _flush_buffer (0)
+	, _flush_buffer_size (0)
+	, _playback_buffer_scale (1.0)
+	, _frames_read (0)
+	, _frames_rolled (0)
+	, _read_start (max_framepos)
+	, _read_end (0)
+	, _buffer_start (max_framepos)
+	, _history_frames (0)
 {
 	in_set_state = true;
 	init ();
@@ -128,6 +157,8 @@ AudioDiskstream::~AudioDiskstream ()
 	}
 
 	channels.flush ();
+
+	delete [] _flush_buffer;
 }
 
 void
@@ -456,11 +487,17 @@ AudioDiskstream::process (BufferSet& bufs, framepos_t transport_frame, pframes_t
 	Glib::Threads::Mutex::Lock sm (state_lock, Glib::Threads::TRY_LOCK);
 
 	if (!sm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		return 1;
 	}
 
 	adjust_capture_position = 0;
 
+	if (_actual_speed != 0) {
+		/* statistics for Session::adapt_playback_buffering() */
+		_frames_rolled += nframes;
+	}
+
 	for (chan = c->begin(); chan != c->end(); ++chan) {
 		(*chan)->current_capture_buffer = 0;
 		(*chan)->current_playback_buffer = 0;
@@ -771,6 +808,8 @@ AudioDiskstream::commit (framecnt_t playback_distance)
 
 	if (_actual_speed < 0.0) {
 		playback_sample -= playback_distance;
+		/* the read pointer moves on while playback_sample goes backwards */
+		_buffer_start = max_framepos;
 	} else {
 		playback_sample += playback_distance;
 	}
@@ -795,15 +834,18 @@ AudioDiskstream::commit (framecnt_t playback_distance)
 		return false;
 	}
 
+	/* _do_refill() does not write over retained history, so that is not space to refill */
+	const framecnt_t refill_space = (framecnt_t) c->front()->playback_buf->write_space() - retained_history ();
+
 	if (_slaved) {
 		if (_io && _io->active()) {
-			need_butler = c->front()->playback_buf->write_space() >= c->front()->playback_buf->bufsize() / 2;
+			need_butler = refill_space >= (framecnt_t) c->front()->playback_buf->bufsize() / 2;
 		} else {
 			need_butler = false;
 		}
 	} else {
 		if (_io && _io->active()) {
-			need_butler = ((framecnt_t) c->front()->playback_buf->write_space() >= disk_read_chunk_frames)
+			need_butler = (refill_space >= disk_read_chunk_frames)
 				|| ((framecnt_t) c->front()->capture_buf->read_space() >= disk_write_chunk_frames);
 		} else {
 			need_butler = ((framecnt_t) c->front()->capture_buf->read_space() >= disk_write_chunk_frames);
@@ -844,6 +886,9 @@ AudioDiskstream::overwrite_existing_buffers ()
 
 	overwrite_queued = false;
 
+	/* this writes the whole buffer, including data behind the read pointer */
+	_buffer_start = max_framepos;
+
 	/* assume all are the same size */
 	framecnt_t size = c->front()->playback_buf->bufsize();
 
@@ -913,8 +958,13 @@ AudioDiskstream::seek (framepos_t frame, bool complete_refill)
 
 	Glib::Threads::Mutex::Lock lm (state_lock);
 
+	const gint64 before = g_get_monotonic_time ();
+	const bool buffered = seek_in_buffers (frame);
+
 	for (n = 0, chan = c->begin(); chan != c->end(); ++chan, ++n) {
-		(*chan)->playback_buf->reset ();
+		if (!buffered) {
+			(*chan)->playback_buf->reset ();
+		}
 		(*chan)->capture_buf->reset ();
 	}
 
@@ -924,10 +974,16 @@ AudioDiskstream::seek (framepos_t frame, bool complete_refill)
 		disengage_record_enable ();
 	}
 
-	playback_sample = frame;
-	file_frame = frame;
+	if (!buffered) {
+		playback_sample = frame;
+		file_frame = frame;
+		_buffer_start = frame;
+	}
 
-	if (complete_refill) {
+	if (buffered && !c->empty() && c->front()->playback_buf->read_space() >= c->front()->playback_buf->bufsize() / 2) {
+		/* plenty left to play, the butler will top up the buffers once we roll */
+		ret = 0;
+	} else if (complete_refill) {
 		/* call _do_refill() to refill the entire buffer, using
 		   the largest reads possible.
 		*/
@@ -939,9 +995,90 @@ AudioDiskstream::seek (framepos_t frame, bool complete_refill)
 		ret = do_refill_with_alloc (true);
 	}
 
+	add_seek_stats (buffered, g_get_monotonic_time () - before);
+
 	return ret;
 }
 
+/** @return how much of the data behind the read pointer _do_refill() leaves alone */
+framecnt_t
+AudioDiskstream::retained_history () const
+{
+	const framepos_t ps = playback_sample;
+	const framepos_t bs = _buffer_start;
+
+	if (bs > ps) {
+		return 0;
+	}
+	return min (_history_frames, ps - bs);
+}
+
+/** Try to locate to @param frame by moving the read pointers within the data
+ *  that is already in the playback buffers: either ahead of the read pointer,
+ *  or played recently and retained behind it (see retained_history()).
+ *  Called with the state lock held, while the audio thread is not reading.
+ *  @return true if the buffers now start at @param frame, false if they need
+ *  to be refilled from scratch.
+ */
+bool
+AudioDiskstream::seek_in_buffers (framepos_t frame)
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	/* picked up here, so that the audio thread does not need to look at the config */
+	_history_frames = 0;
+
+	if (!c->empty()) {
+		const framecnt_t h = Config->get_audio_playback_history_seconds() * _session.frame_rate();
+		_history_frames = max ((framecnt_t) 0, min (h, (framecnt_t) c->front()->playback_buf->bufsize() / 4));
+	}
+
+	if (c->empty() || _pending_overwrite || _buffer_start == max_framepos || _buffer_start > playback_sample || _history_frames == 0) {
+		return false;
+	}
+
+	RingBufferNPT<Sample>* front = c->front()->playback_buf;
+	const size_t rp = front->get_read_ptr ();
+	const size_t wp = front->get_write_ptr ();
+
+	for (ChannelList::iterator chan = c->begin(); chan != c->end(); ++chan) {
+		/* a channel that was added later has not been filled along with the others */
+		if ((*chan)->playback_buf->get_read_ptr() != rp || (*chan)->playback_buf->get_write_ptr() != wp ||
+		    (*chan)->playback_buf->bufsize() != front->bufsize()) {
+			return false;
+		}
+	}
+
+	const framecnt_t readable = front->read_space ();
+
+	if (file_frame != playback_sample + readable) {
+		return false;
+	}
+
+	/* all of the free space behind the read pointer holds the frames
+	   right before playback_sample, as far back as _buffer_start.
+	*/
+	const framecnt_t history = min ((framecnt_t) front->write_space (), playback_sample - _buffer_start);
+
+	if (frame < playback_sample - history || frame >= file_frame) {
+		return false;
+	}
+
+	const framecnt_t size = front->bufsize ();
+	const size_t new_rp = (rp + size + (frame - playback_sample)) % size;
+
+	for (ChannelList::iterator chan = c->begin(); chan != c->end(); ++chan) {
+		(*chan)->playback_buf->set (new_rp, wp);
+	}
+
+	DEBUG_TRACE (DEBUG::Transport, string_compose ("%1: locate from %2 to %3 within buffered data [%4 .. %5)\n",
+	                                               name(), playback_sample, frame, playback_sample - history, file_frame));
+
+	playback_sample = frame;
+
+	return true;
+}
+
 int
 AudioDiskstream::can_internal_playback_seek (framecnt_t distance)
 {
@@ -971,6 +1108,10 @@ AudioDiskstream::internal_playback_seek (framecnt_t distance)
 	}
 	playback_sample += distance;
 
+	if (distance < 0) {
+		_buffer_start = max_framepos;
+	}
+
 	return 0;
 }
 
@@ -1156,6 +1297,19 @@ AudioDiskstream::_do_refill (Sample* mixdown_buffer, float* gain_buffer, framecn
 		}
 	}
 
+	if (reversed) {
+		_buffer_start = max_framepos;
+	} else {
+		/* leave recently played data alone, so that a short locate
+		   backwards can re-use it, see seek_in_buffers()
+		*/
+		const framecnt_t keep = retained_history ();
+		if (keep >= total_space) {
+			return 0;
+		}
+		total_space -= keep;
+	}
+
 	/* if we're running close to normal speed and there isn't enough
 	   space to do disk_read_chunk_frames of I/O, then don't bother.
 
@@ -1219,6 +1373,8 @@ AudioDiskstream::_do_refill (Sample* mixdown_buffer, float* gain_buffer, framecn
 
 			/* at end: nothing to do but fill with silence */
 
+			_buffer_start = max_framepos;
+
 			for (chan_n = 0, i = c->begin(); i != c->end(); ++i, ++chan_n) {
 
 				ChannelInfo* chan (*i);
@@ -1352,6 +1508,18 @@ AudioDiskstream::_do_refill (Sample* mixdown_buffer, float* gain_buffer, framecn
 	// elapsed = g_get_monotonic_time () - before;
 	// cerr << "\tbandwidth = " << (byte_size_for_read / 1048576.0) / (elapsed/1000000.0) << "MB/sec\n";
 
+	if (!reversed && file_frame_tmp < file_frame) {
+		/* wrapped around the loop: the buffered data is not contiguous */
+		_buffer_start = max_framepos;
+	}
+
+	if (_actual_speed != 0) {
+		/* statistics for Session::adapt_playback_buffering() */
+		_frames_read += samples_to_read;
+		_read_start = min (_read_start, min (file_frame, file_frame_tmp));
+		_read_end = max (_read_end, max (file_frame, file_frame_tmp));
+	}
+
 	file_frame = file_frame_tmp;
 	assert (file_frame >= 0);
 
@@ -1365,22 +1533,32 @@ AudioDiskstream::_do_refill (Sample* mixdown_buffer, float* gain_buffer, framecn
 
 /** Flush pending data to disk.
  *
- * Important note: this function will write *AT MOST* disk_write_chunk_frames
- * of data to disk. it will never write more than that.  If it writes that
- * much and there is more than that waiting to be written, it will return 1,
- * otherwise 0 on success or -1 on failure.
+ * Important note: this function will write *AT MOST* capture_flush_chunks *
+ * disk_write_chunk_frames of data per channel to disk. If there is more than
+ * disk_write_chunk_frames left after that, it will return 1, otherwise 0 on
+ * success or -1 on failure.
  *
  * If there is less than disk_write_chunk_frames to be written, no data will be
  * written at all unless @a force_flush is true.
+ *
+ * Whatever is ready is written with a single call per channel (wrapped
+ * ring-buffer data is copied into a staging buffer first), and while
+ * recording, writes are kept to multiples of capture_write_alignment so that
+ * the files grow in large, evenly sized blocks.
+ *
+ * Destructive tracks need to honour capture-transitions and write
+ * at most one chunk at a time.
  */
 int
 AudioDiskstream::do_flush (RunContext /*context*/, bool force_flush)
 {
-	uint32_t to_write;
+	framecnt_t to_write;
 	int32_t ret = 0;
 	RingBufferNPT<Sample>::rw_vector vector;
 	RingBufferNPT<CaptureTransition>::rw_vector transvec;
 	framecnt_t total;
+	framecnt_t flushed = 0;
+	const gint64 flush_start = g_get_monotonic_time ();
 
 	transvec.buf[0] = 0;
 	transvec.buf[1] = 0;
@@ -1398,27 +1576,35 @@ AudioDiskstream::do_flush (RunContext /*context*/, bool force_flush)
 			goto out;
 		}
 
-		/* if there are 2+ chunks of disk i/o possible for
-		   this track, let the caller know so that it can arrange
-		   for us to be called again, ASAP.
+		if (!(*chan)->write_source) {
+			error << string_compose(_("AudioDiskstream %1: cannot write to disk"), id()) << endmsg;
+			return -1;
+		}
 
-		   if we are forcing a flush, then if there is* any* extra
-		   work, let the caller know.
+		Sample* buf = vector.buf[0];
 
-		   if we are no longer recording and there is any extra work,
-		   let the caller know too.
-		*/
+		if (destructive()) {
 
-		if (total >= 2 * disk_write_chunk_frames || ((force_flush || !was_recording) && total > disk_write_chunk_frames)) {
-			ret = 1;
-		}
+			/* if there are 2+ chunks of disk i/o possible for
+			   this track, let the caller know so that it can arrange
+			   for us to be called again, ASAP.
 
-		to_write = min (disk_write_chunk_frames, (framecnt_t) vector.len[0]);
+			   if we are forcing a flush, then if there is* any* extra
+			   work, let the caller know.
 
-		// check the transition buffer when recording destructive
-		// important that we get this after the capture buf
+			   if we are no longer recording and there is any extra work,
+			   let the caller know too.
+			*/
+
+			if (total >= 2 * disk_write_chunk_frames || ((force_flush || !was_recording) && total > disk_write_chunk_frames)) {
+				ret = 1;
+			}
+
+			to_write = min (disk_write_chunk_frames, (framecnt_t) vector.len[0]);
+
+			// check the transition buffer when recording destructive
+			// important that we get this after the capture buf
 
-		if (destructive()) {
 			(*chan)->capture_transition_buf->get_read_vector(&transvec);
 			size_t transcount = transvec.len[0] + transvec.len[1];
 			size_t ti;
@@ -1463,39 +1649,106 @@ AudioDiskstream::do_flush (RunContext /*context*/, bool force_flush)
 			if (ti > 0) {
 				(*chan)->capture_transition_buf->increment_read_ptr(ti);
 			}
+
+		} else {
+
+			to_write = min (total, capture_flush_chunks * disk_write_chunk_frames);
+
+			if (was_recording && !force_flush && to_write >= capture_write_alignment) {
+				/* more data will follow, leave the remainder for the next flush */
+				to_write -= to_write % capture_write_alignment;
+			}
+
+			if (total - to_write >= disk_write_chunk_frames || ((force_flush || !was_recording) && total > to_write)) {
+				ret = 1;
+			}
+
+			if (to_write > (framecnt_t) vector.len[0]) {
+
+				/* the data wraps around the end of the ringbuffer,
+				   write it out in one go nevertheless.
+				*/
+
+				if (_flush_buffer_size < to_write) {
+					delete [] _flush_buffer;
+					_flush_buffer_size = capture_flush_chunks * disk_write_chunk_frames;
+					_flush_buffer = new Sample[_flush_buffer_size];
+				}
+
+				memcpy (_flush_buffer, vector.buf[0], sizeof (Sample) * vector.len[0]);
+				memcpy (_flush_buffer + vector.len[0], vector.buf[1], sizeof (Sample) * (to_write - vector.len[0]));
+				buf = _flush_buffer;
+
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 coalesced wrapped write of %2\n", name(), to_write));
+			}
 		}
 
-		if ((!(*chan)->write_source) || (*chan)->write_source->write (vector.buf[0], to_write) != to_write) {
+		if ((*chan)->write_source->write (buf, to_write) != to_write) {
 			error << string_compose(_("AudioDiskstream %1: cannot write to disk"), id()) << endmsg;
 			return -1;
 		}
 
 		(*chan)->capture_buf->increment_read_ptr (to_write);
 		(*chan)->curr_capture_cnt += to_write;
+		flushed += to_write;
+	}
 
-		if ((to_write == vector.len[0]) && (total > to_write) && (to_write < disk_write_chunk_frames) && !destructive()) {
+  out:
+	if (flushed > 0) {
+		add_capture_stats (flushed, g_get_monotonic_time () - flush_start);
+	}
+	return ret;
+}
 
-			/* we wrote all of vector.len[0] but it wasn't an entire
-			   disk_write_chunk_frames of data, so arrange for some part
-			   of vector.len[1] to be flushed to disk as well.
-			*/
+AudioDiskstream::CaptureStats
+AudioDiskstream::capture_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_capture_stats_lock);
+	return _capture_stats;
+}
 
-			to_write = min ((framecnt_t)(disk_write_chunk_frames - to_write), (framecnt_t) vector.len[1]);
+void
+AudioDiskstream::reset_capture_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_capture_stats_lock);
+	_capture_stats = CaptureStats ();
+}
 
-                        DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 additional write of %2\n", name(), to_write));
+AudioDiskstream::SeekStats
+AudioDiskstream::seek_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_seek_stats_lock);
+	return _seek_stats;
+}
 
-			if ((*chan)->write_source->write (vector.buf[1], to_write) != to_write) {
-				error << string_compose(_("AudioDiskstream %1: cannot write to disk"), id()) << endmsg;
-				return -1;
-			}
+void
+AudioDiskstream::reset_seek_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_seek_stats_lock);
+	_seek_stats = SeekStats ();
+}
 
-			(*chan)->capture_buf->increment_read_ptr (to_write);
-			(*chan)->curr_capture_cnt += to_write;
-		}
+void
+AudioDiskstream::add_seek_stats (bool buffered, gint64 usecs)
+{
+	Glib::Threads::Mutex::Lock lm (_seek_stats_lock);
+	_seek_stats.seeks += 1;
+	if (buffered) {
+		_seek_stats.buffered += 1;
 	}
+	_seek_stats.usecs += usecs;
+	_seek_stats.max_usecs = max (_seek_stats.max_usecs, usecs);
+}
 
-  out:
-	return ret;
+void
+AudioDiskstream::add_capture_stats (framecnt_t samples, gint64 usecs)
+{
+	Glib::Threads::Mutex::Lock lm (_capture_stats_lock);
+	_capture_stats.samples += samples;
+	_capture_stats.bytes   += samples * sizeof (Sample);
+	_capture_stats.flushes += 1;
+	_capture_stats.usecs   += usecs;
+	_capture_stats.max_flush_usecs = max (_capture_stats.max_flush_usecs, usecs);
 }
 
 void
@@ -2031,6 +2284,7 @@ AudioDiskstream::use_new_write_source (uint32_t n)
 	/* do not remove destructive files even if they are empty */
 
 	chan->write_source->set_allow_remove_if_empty (!destructive());
+	chan->write_source->prepare_for_live_peaks ();
 
 	return 0;
 }
@@ -2186,11 +2440,11 @@ AudioDiskstream::add_channel_to (boost::shared_ptr<ChannelList> c, uint32_t how_
 {
 	while (how_many--) {
 		c->push_back (new ChannelInfo(
-			              _session.butler()->audio_diskstream_playback_buffer_size(),
+			              scaled_playback_buffer_size (),
 			              _session.butler()->audio_diskstream_capture_buffer_size(),
 			              speed_buffer_size, wrap_buffer_size));
 		interpolation.add_channel_to (
-			_session.butler()->audio_diskstream_playback_buffer_size(),
+			scaled_playback_buffer_size (),
 			speed_buffer_size);
 	}
 
@@ -2244,6 +2498,18 @@ AudioDiskstream::playback_buffer_load () const
 	                   (double) c->front()->playback_buf->bufsize());
 }
 
+framecnt_t
+AudioDiskstream::playback_frames_buffered () const
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	if (c->empty ()) {
+		return max_framecnt;
+	}
+
+	return c->front()->playback_buf->read_space();
+}
+
 float
 AudioDiskstream::capture_buffer_load () const
 {
@@ -2487,11 +2753,146 @@ AudioDiskstream::adjust_playback_buffering ()
 {
 	boost::shared_ptr<ChannelList> c = channels.reader();
 
+	_buffer_start = max_framepos;
+
 	for (ChannelList::iterator chan = c->begin(); chan != c->end(); ++chan) {
-		(*chan)->resize_playback (_session.butler()->audio_diskstream_playback_buffer_size());
+		(*chan)->resize_playback (scaled_playback_buffer_size ());
 	}
 }
 
+framecnt_t
+AudioDiskstream::scaled_playback_buffer_size () const
+{
+	const framecnt_t nominal = _session.butler()->audio_diskstream_playback_buffer_size();
+	/* it is a design assumption that disk_read_chunk_frames is smaller
+	 * than the playback buffer, see _do_refill()
+	 */
+	return std::max (std::min (nominal, 2 * disk_read_chunk_frames), (framecnt_t) rint (nominal * _playback_buffer_scale));
+}
+
+void
+AudioDiskstream::close_read_run ()
+{
+	double density = 0;
+
+	if (_read_end > _read_start && _playlist) {
+		density = _playlist->covered_length (_read_start, _read_end) / (double) (_read_end - _read_start);
+	}
+
+	if (_frames_rolled > 0) {
+		_read_window.add (_frames_read, _frames_rolled, density);
+	}
+
+	_frames_read = 0;
+	_frames_rolled = 0;
+	_read_start = max_framepos;
+	_read_end = 0;
+}
+
+AudioDiskstream::ReadWindow::ReadWindow ()
+	: _next (0)
+{
+}
+
+void
+AudioDiskstream::ReadWindow::add (framecnt_t read, framecnt_t rolled, double density)
+{
+	_runs[_next].read = read;
+	_runs[_next].rolled = rolled;
+	_runs[_next].density = density;
+	_next = (_next + 1) % size;
+}
+
+void
+AudioDiskstream::ReadWindow::clear ()
+{
+	for (uint32_t n = 0; n < size; ++n) {
+		_runs[n] = Run ();
+	}
+	_next = 0;
+}
+
+framecnt_t
+AudioDiskstream::ReadWindow::read () const
+{
+	framecnt_t r = 0;
+	for (uint32_t n = 0; n < size; ++n) {
+		r += _runs[n].read;
+	}
+	return r;
+}
+
+double
+AudioDiskstream::ReadWindow::rate () const
+{
+	framecnt_t read = 0;
+	framecnt_t rolled = 0;
+	for (uint32_t n = 0; n < size; ++n) {
+		read += _runs[n].read;
+		rolled += _runs[n].rolled;
+	}
+	return rolled > 0 ? read / (double) rolled : 0;
+}
+
+double
+AudioDiskstream::ReadWindow::density () const
+{
+	double d = 0;
+	framecnt_t rolled = 0;
+	for (uint32_t n = 0; n < size; ++n) {
+		d += _runs[n].density * _runs[n].rolled;
+		rolled += _runs[n].rolled;
+	}
+	return rolled > 0 ? d / rolled : 0;
+}
+
+framecnt_t
+AudioDiskstream::playback_buffer_size () const
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	if (c->empty ()) {
+		return 0;
+	}
+
+	return c->front()->playback_buf->bufsize();
+}
+
+framecnt_t
+AudioDiskstream::peek_playback_buffer (Sample* dst, framecnt_t cnt, uint32_t n) const
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	if (n >= c->size ()) {
+		return 0;
+	}
+
+	RingBufferNPT<Sample>::rw_vector vec;
+	(*c)[n]->playback_buf->get_read_vector (&vec);
+
+	const framecnt_t first = min (cnt, (framecnt_t) vec.len[0]);
+	const framecnt_t second = min (cnt - first, (framecnt_t) vec.len[1]);
+
+	memcpy (dst, vec.buf[0], first * sizeof (Sample));
+	if (second) {
+		memcpy (dst + first, vec.buf[1], second * sizeof (Sample));
+	}
+
+	return first + second;
+}
+
+framecnt_t
+AudioDiskstream::capture_buffer_size () const
+{
+	boost::shared_ptr<ChannelList> c = channels.reader();
+
+	if (c->empty ()) {
+		return 0;
+	}
+
+	return c->front()->capture_buf->bufsize();
+}
+
 void
 AudioDiskstream::adjust_capture_buffering ()
 {
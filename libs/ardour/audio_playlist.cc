@@ -25,8 +25,10 @@
 #include "ardour/debug.h"
 #include "ardour/audioplaylist.h"
 #include "ardour/audioregion.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/region_sorters.h"
 #include "ardour/session.h"
+#include "ardour/source.h"
 
 #include "pbd/i18n.h"
 
@@ -36,6 +38,7 @@ using namespace PBD;
 
 AudioPlaylist::AudioPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::AUDIO, hidden)
+	, _render_cache_settings (0)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -55,16 +58,19 @@ AudioPlaylist::AudioPlaylist (Session& session, const XMLNode& node, bool hidden
 
 AudioPlaylist::AudioPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::AUDIO, hidden)
+	, _render_cache_settings (0)
 {
 }
 
 AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
+	, _render_cache_settings (0)
 {
 }
 
 AudioPlaylist::AudioPlaylist (boost::shared_ptr<const AudioPlaylist> other, framepos_t start, framecnt_t cnt, string name, bool hidden)
 	: Playlist (other, start, cnt, name, hidden)
+	, _render_cache_settings (0)
 {
 	RegionReadLock rlock2 (const_cast<AudioPlaylist*> (other.get()));
 	in_set_state++;
@@ -180,6 +186,29 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 	   zeroed.
 	*/
 
+	bool cacheable = Config->get_playlist_render_cache ();
+	uint32_t generation = 0;
+
+	if (cacheable) {
+		/* region fades and channel replication are not per-region state,
+		   so a change of either is not notified by any of our regions.
+		*/
+		const uint32_t settings = (_session.config.get_use_region_fades () ? 1 : 0) | (Config->get_replicate_missing_region_channels () ? 2 : 0);
+
+		if (settings != _render_cache_settings) {
+			_render_cache.clear ();
+			_render_cache_settings = settings;
+		}
+
+		if (_render_cache.read (buf, start, cnt, chan_n)) {
+			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 read @ %2 for %3 from render cache\n", name(), start, cnt));
+			return cnt;
+		}
+
+		/* must be taken before looking at any region */
+		generation = _render_cache.generation ();
+	}
+
 	memset (buf, 0, sizeof (Sample) * cnt);
 
 	/* this function is never called from a realtime thread, so
@@ -211,6 +240,17 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 		if ( ar->muted() )
 			continue;
 
+		/* data that is still being written may change without notice */
+		if (cacheable) {
+			SourceList const & srcs (ar->sources ());
+			for (SourceList::const_iterator s = srcs.begin(); s != srcs.end(); ++s) {
+				if ((*s)->writable ()) {
+					cacheable = false;
+					break;
+				}
+			}
+		}
+
 		/* Work out which bits of this region need to be read;
 		   first, trim to the range we are reading...
 		*/
@@ -253,9 +293,19 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, fr
 		i->region->read_at (buf + i->range.from - start, mixdown_buffer, gain_buffer, i->range.from, i->range.to - i->range.from + 1, chan_n);
 	}
 
+	if (cacheable) {
+		_render_cache.write (buf, start, cnt, chan_n, generation);
+	}
+
 	return cnt;
 }
 
+void
+AudioPlaylist::rendered_range_changed (Evoral::Range<framepos_t> const & range)
+{
+	_render_cache.invalidate (range);
+}
+
 void
 AudioPlaylist::dump () const
 {
@@ -317,6 +367,10 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 			x = xtmp;
 		}
 
+		if (changed) {
+			rendered_range_changed (region->range ());
+		}
+
 		region->set_playlist (boost::shared_ptr<Playlist>());
 	}
 
@@ -331,10 +385,6 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 bool
 AudioPlaylist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
 {
-	if (in_flush || in_set_state) {
-		return false;
-	}
-
 	PropertyChange bounds;
 	bounds.add (Properties::start);
 	bounds.add (Properties::position);
@@ -350,6 +400,27 @@ AudioPlaylist::region_changed (const PropertyChange& what_changed, boost::shared
 	our_interests.add (Properties::fade_in);
 	our_interests.add (Properties::fade_out);
 
+	/* the render cache needs to know about changes even while
+	   notifications are otherwise ignored
+	*/
+	PropertyChange rendering (bounds);
+	rendering.add (our_interests);
+	rendering.add (Properties::inverse_fade_in);
+	rendering.add (Properties::inverse_fade_out);
+	rendering.add (Properties::muted);
+	rendering.add (Properties::opaque);
+
+	if (what_changed.contains (rendering)) {
+		if (what_changed.contains (bounds)) {
+			_render_cache.invalidate (region->last_range ());
+		}
+		_render_cache.invalidate (region->range ());
+	}
+
+	if (in_flush || in_set_state) {
+		return false;
+	}
+
 	bool parent_wants_notify;
 
 	parent_wants_notify = Playlist::region_changed (what_changed, region);
@@ -21,6 +21,7 @@
 
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
+#include "pbd/rt_monitor.h"
 
 #include "evoral/Curve.hpp"
 
@@ -332,6 +333,7 @@ AudioTrack::roll (pframes_t nframes, framepos_t start_frame, framepos_t end_fram
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		boost::shared_ptr<AudioDiskstream> diskstream = audio_diskstream();
 		framecnt_t playback_distance = diskstream->calculate_playback_distance(nframes);
 		if (can_internal_playback_seek(::llabs(playback_distance))) {
@@ -32,6 +32,7 @@
 #include "pbd/epa.h"
 #include "pbd/file_utils.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/rt_monitor.h"
 #include "pbd/stacktrace.h"
 #include "pbd/unknown_type.h"
 
@@ -1235,6 +1236,8 @@ AudioEngine::thread_init_callback (void* arg)
 	AsyncMIDIPort::set_process_thread (pthread_self());
 
 	if (arg) {
+		/* graph threads register themselves */
+		PBD::RTMonitor::register_thread (X_("process"));
 		delete AudioEngine::instance()->_main_thread;
 		/* the special thread created/managed by the backend */
 		AudioEngine::instance()->_main_thread = new ProcessThread;
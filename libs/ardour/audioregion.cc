@@ -402,6 +402,8 @@ AudioRegion::listen_to_my_curves ()
 	_envelope->StateChanged.connect_same_thread (*this, boost::bind (&AudioRegion::envelope_changed, this));
 	_fade_in->StateChanged.connect_same_thread (*this, boost::bind (&AudioRegion::fade_in_changed, this));
 	_fade_out->StateChanged.connect_same_thread (*this, boost::bind (&AudioRegion::fade_out_changed, this));
+	_inverse_fade_in->StateChanged.connect_same_thread (*this, boost::bind (&AudioRegion::drop_gain_tables, this, InverseFadeInGain, InverseFadeInGain));
+	_inverse_fade_out->StateChanged.connect_same_thread (*this, boost::bind (&AudioRegion::drop_gain_tables, this, InverseFadeOutGain, InverseFadeOutGain));
 }
 
 void
@@ -581,130 +583,227 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 		return 0;
 	}
 
-	/* APPLY REGULAR GAIN CURVES AND SCALING TO mixdown_buffer */
-
-	if (envelope_active())  {
-		_envelope->curve().get_vector (internal_offset, internal_offset + to_read, gain_buffer, to_read);
-
-		if (_scale_amplitude != 1.0f) {
-			for (framecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n] * _scale_amplitude;
-			}
-		} else {
-			for (framecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n];
-			}
-		}
-	} else if (_scale_amplitude != 1.0f) {
-		apply_gain_to_buffer (mixdown_buffer, to_read, _scale_amplitude);
-	}
-
-	/* APPLY FADES TO THE DATA IN mixdown_buffer AND MIX THE RESULTS INTO
-	 * buf. The key things to realize here: (1) the fade being applied is
-	 * (as of April 26th 2012) just the inverse of the fade in curve (2)
-	 * "buf" contains data from lower regions already. So this operation
-	 * fades out the existing material.
+	/* APPLY FADES, ENVELOPE AND SCALING TO THE DATA IN mixdown_buffer AND
+	 * MIX THE RESULTS INTO buf. The key things to realize here: (1) the
+	 * fade being applied to lower layers is (as of April 26th 2012) just
+	 * the inverse of the fade in curve (2) "buf" contains data from lower
+	 * regions already. So this operation fades out the existing material.
 	 */
 
 	if (fade_in_limit != 0) {
+		mix_with_fade (buf, mixdown_buffer, FadeInGain, internal_offset, opaque(), internal_offset, fade_in_limit);
+	}
 
-		if (opaque()) {
-			if (_inverse_fade_in) {
-
-				/* explicit inverse fade in curve (e.g. for constant
-				 * power), so we have to fetch it.
-				 */
-
-				_inverse_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
+	if (fade_out_limit != 0) {
 
-				/* Fade the data from lower layers out */
-				for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= gain_buffer[n];
-				}
+		framecnt_t const curve_offset = fade_interval_start - (_length - _fade_out->back()->when);
 
-				/* refill gain buffer with the fade in */
+		mix_with_fade (buf + fade_out_offset, mixdown_buffer + fade_out_offset, FadeOutGain, curve_offset, opaque(),
+		               internal_offset + fade_out_offset, fade_out_limit);
+	}
 
-				_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
+	/* MIX OR COPY THE REGION BODY FROM mixdown_buffer INTO buf */
 
-			} else {
+	framecnt_t const N = to_read - fade_in_limit - fade_out_limit;
+	if (N > 0) {
+		Sample* dst = buf + fade_in_limit;
+		Sample* src = mixdown_buffer + fade_in_limit;
 
-				/* no explicit inverse fade in, so just use (1 - fade
-				 * in) for the fade out of lower layers
-				 */
+		if (envelope_active()) {
 
-				_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
+			gain_t* gain = gain_buffer + fade_in_limit;
+			compute_gain (EnvelopeGain, internal_offset + fade_in_limit, N, gain);
+			gain_t const scale = _scale_amplitude;
 
-				for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= 1 - gain_buffer[n];
+			if (opaque ()) {
+				for (framecnt_t n = 0; n < N; ++n) {
+					dst[n] = src[n] * (gain[n] * scale);
 				}
+			} else {
+				mix_buffers_with_fade (dst, src, gain, 0, 0, N, scale);
 			}
-		} else {
-			_fade_in->curve().get_vector (internal_offset, internal_offset + fade_in_limit, gain_buffer, fade_in_limit);
-		}
 
-		/* Mix our newly-read data in, with the fade */
-		for (framecnt_t n = 0; n < fade_in_limit; ++n) {
-			buf[n] += mixdown_buffer[n] * gain_buffer[n];
+		} else if (opaque ()) {
+			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Region %1 memcpy into buf @ %2 + %3, from mixdown buffer @ %4 + %5, len = %6 cnt was %7\n",
+									   name(), buf, fade_in_limit, mixdown_buffer, fade_in_limit, N, cnt));
+			memcpy (dst, src, N * sizeof (Sample));
+			if (_scale_amplitude != 1.0f) {
+				apply_gain_to_buffer (dst, N, _scale_amplitude);
+			}
+		} else if (_scale_amplitude != 1.0f) {
+			mix_buffers_with_gain (dst, src, N, _scale_amplitude);
+		} else {
+			mix_buffers_no_gain (dst, src, N);
 		}
 	}
 
-	if (fade_out_limit != 0) {
+	return to_read;
+}
 
-		framecnt_t const curve_offset = fade_interval_start - (_length - _fade_out->back()->when);
+/* about 5 seconds at 48kHz, 1MB per table */
+const framecnt_t AudioRegion::max_gain_table_length = 262144;
 
-		if (opaque()) {
-			if (_inverse_fade_out) {
+/** Mix @param cnt frames of @param mixdown_buffer into @param buf, with a fade, the envelope (if any) and
+ *  the region's scale amplitude applied.
+ *
+ *  @param fade FadeInGain or FadeOutGain.
+ *  @param fade_offset Offset of the first frame into the fade.
+ *  @param lower true to fade the existing contents of @param buf with the inverse of the fade.
+ *  @param envelope_offset Offset of the first frame from the start of the region.
+ */
+void
+AudioRegion::mix_with_fade (Sample* buf, Sample const* mixdown_buffer, GainCurve fade, framecnt_t fade_offset, bool lower,
+                            framecnt_t envelope_offset, framecnt_t cnt) const
+{
+	GainCurve const inverse = (fade == FadeInGain) ? InverseFadeInGain : InverseFadeOutGain;
+	GainTable const fade_table = gain_table (fade);
+	GainTable const inverse_table = lower ? gain_table (inverse) : GainTable ();
+	bool const with_envelope = envelope_active ();
 
-				_inverse_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
+	/* the envelope, and fades that are not kept as tables, are evaluated in chunks */
 
-				/* Fade the data from lower levels in */
-				for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= gain_buffer[n];
-				}
+	const framecnt_t chunk = 1024;
+	gain_t fade_scratch[chunk];
+	gain_t inverse_scratch[chunk];
+	gain_t envelope_scratch[chunk];
 
-				/* fetch the actual fade out */
+	for (framecnt_t done = 0; done < cnt; ) {
 
-				_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
+		framecnt_t const n = min (chunk, cnt - done);
 
-			} else {
+		gain_t const * f = gain_vector (fade, fade_table, fade_offset + done, n, fade_scratch);
+		gain_t const * l = lower ? gain_vector (inverse, inverse_table, fade_offset + done, n, inverse_scratch) : 0;
+		gain_t const * e = with_envelope ? gain_vector (EnvelopeGain, GainTable (), envelope_offset + done, n, envelope_scratch) : 0;
 
-				/* no explicit inverse fade out (which is
-				 * actually a fade in), so just use (1 - fade
-				 * out) for the fade in of lower layers
-				 */
+		mix_buffers_with_fade (buf + done, mixdown_buffer + done, f, l, e, n, _scale_amplitude);
 
-				_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
+		done += n;
+	}
+}
 
-				for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= 1 - gain_buffer[n];
-				}
-			}
+/** @return the number of frames covered by a gain curve */
+framecnt_t
+AudioRegion::gain_curve_length (GainCurve which) const
+{
+	switch (which) {
+	case FadeInGain:
+	case InverseFadeInGain:
+		return (framecnt_t) _fade_in->back()->when;
+	case FadeOutGain:
+	case InverseFadeOutGain:
+		return (framecnt_t) _fade_out->back()->when;
+	default:
+		break;
+	}
+	return _length;
+}
+
+/** Evaluate @param cnt frames of a gain curve from @param offset into @param vec */
+void
+AudioRegion::compute_gain (GainCurve which, framecnt_t offset, framecnt_t cnt, gain_t* vec) const
+{
+	switch (which) {
+	case FadeInGain:
+		_fade_in->curve().get_vector (offset, offset + cnt, vec, cnt);
+		break;
+	case FadeOutGain:
+		_fade_out->curve().get_vector (offset, offset + cnt, vec, cnt);
+		break;
+	case InverseFadeInGain:
+	case InverseFadeOutGain:
+	{
+		AutomationListProperty const & fade (which == InverseFadeInGain ? _fade_in : _fade_out);
+		AutomationListProperty const & inverse (which == InverseFadeInGain ? _inverse_fade_in : _inverse_fade_out);
+
+		if (inverse) {
+			/* explicit inverse curve (e.g. for constant power) */
+			inverse->curve().get_vector (offset, offset + cnt, vec, cnt);
 		} else {
-			_fade_out->curve().get_vector (curve_offset, curve_offset + fade_out_limit, gain_buffer, fade_out_limit);
+			/* no explicit inverse, so just use (1 - fade) */
+			fade->curve().get_vector (offset, offset + cnt, vec, cnt);
+			for (framecnt_t n = 0; n < cnt; ++n) {
+				vec[n] = 1 - vec[n];
+			}
 		}
+		break;
+	}
+	default:
+		_envelope->curve().get_vector (offset, offset + cnt, vec, cnt);
+		break;
+	}
+}
 
-		/* Mix our newly-read data with whatever was already there,
-		   with the fade out applied to our data.
-		*/
-		for (framecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-			buf[m] += mixdown_buffer[m] * gain_buffer[n];
+/** @return a table of the whole of a fade curve, computing it if required, or
+ *  an empty pointer if the curve is too long to be kept as a table.
+ */
+AudioRegion::GainTable
+AudioRegion::gain_table (GainCurve which) const
+{
+	framecnt_t const len = gain_curve_length (which);
+
+	if (which >= NumGainTables || len <= 0 || len > max_gain_table_length) {
+		return GainTable ();
+	}
+
+	uint32_t version;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_gain_table_lock);
+		GainTableSlot const& s (_gain_tables[which]);
+
+		/* the length check catches a change of the fade's length
+		 * that was not notified yet
+		 */
+		if (s.table && (framecnt_t) s.table->size() == len) {
+			return s.table;
 		}
+
+		version = s.version;
 	}
 
-	/* MIX OR COPY THE REGION BODY FROM mixdown_buffer INTO buf */
+	/* evaluate the curve without holding the lock, so that editing the
+	 * curve (which drops the table) does not have to wait for it.
+	 */
+	std::vector<gain_t>* v = new std::vector<gain_t> (len);
+	compute_gain (which, 0, len, &(*v)[0]);
+	GainTable t (v);
 
-	framecnt_t const N = to_read - fade_in_limit - fade_out_limit;
-	if (N > 0) {
-		if (opaque ()) {
-			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Region %1 memcpy into buf @ %2 + %3, from mixdown buffer @ %4 + %5, len = %6 cnt was %7\n",
-									   name(), buf, fade_in_limit, mixdown_buffer, fade_in_limit, N, cnt));
-			memcpy (buf + fade_in_limit, mixdown_buffer + fade_in_limit, N * sizeof (Sample));
-		} else {
-			mix_buffers_no_gain (buf + fade_in_limit, mixdown_buffer + fade_in_limit, N);
+	{
+		Glib::Threads::Mutex::Lock lm (_gain_table_lock);
+		GainTableSlot& s (_gain_tables[which]);
+
+		/* unless the curve changed meanwhile */
+		if (s.version == version) {
+			s.table = t;
 		}
 	}
 
-	return to_read;
+	return t;
+}
+
+/** @return @param cnt values of a gain curve from @param offset: from @param table if it is
+ *  not empty, otherwise evaluated into @param scratch.
+ */
+gain_t const *
+AudioRegion::gain_vector (GainCurve which, GainTable const& table, framecnt_t offset, framecnt_t cnt, gain_t* scratch) const
+{
+	if (table && offset >= 0 && offset + cnt <= (framecnt_t) table->size()) {
+		return &(*table)[offset];
+	}
+
+	compute_gain (which, offset, cnt, scratch);
+	return scratch;
+}
+
+void
+AudioRegion::drop_gain_tables (GainCurve first, GainCurve last)
+{
+	Glib::Threads::Mutex::Lock lm (_gain_table_lock);
+
+	for (int n = first; n <= last; ++n) {
+		_gain_tables[n].table.reset ();
+		++_gain_tables[n].version;
+	}
 }
 
 /** Read data directly from one of our sources, accounting for the situation when the track has a different channel
@@ -1511,12 +1610,14 @@ AudioRegion::normalize (float max_amplitude, float target_dB)
 void
 AudioRegion::fade_in_changed ()
 {
+	drop_gain_tables (FadeInGain, InverseFadeInGain);
 	send_change (PropertyChange (Properties::fade_in));
 }
 
 void
 AudioRegion::fade_out_changed ()
 {
+	drop_gain_tables (FadeOutGain, InverseFadeOutGain);
 	send_change (PropertyChange (Properties::fade_out));
 }
 
@@ -57,6 +57,7 @@
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/session_event.h"
 
 #include "pbd/i18n.h"
 
@@ -74,8 +75,15 @@ bool AudioSource::_build_missing_peakfiles = false;
 /** true if we want peakfiles (e.g. if we are displaying a GUI) */
 bool AudioSource::_build_peakfiles = false;
 
+Glib::Threads::Mutex AudioSource::_live_peak_queue_lock;
+Glib::Threads::Cond  AudioSource::_live_peaks_to_compute;
+list<boost::weak_ptr<AudioSource> > AudioSource::_live_peak_queue;
+
 #define _FPP 256
 
+/* the live peak thread holds a source's lock for at most this many frames at a time */
+static const framecnt_t live_peak_chunk = 65536;
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _length (0)
@@ -89,6 +97,9 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _live_peak_data (0)
+	, _live_peak_frame (0)
+	, _live_peak_queued (false)
 {
 }
 
@@ -105,6 +116,9 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _last_scale (0.0)
 	, _last_map_off (0)
 	, _last_raw_map_length (0)
+	, _live_peak_data (0)
+	, _live_peak_frame (0)
+	, _live_peak_queued (false)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -125,6 +139,7 @@ AudioSource::~AudioSource ()
 	}
 
 	delete [] peak_leftovers;
+	delete _live_peak_data;
 }
 
 XMLNode&
@@ -760,6 +775,7 @@ AudioSource::build_peaks_from_scratch ()
 			}
 
 			if (compute_and_write_peaks (buf.get(), current_frame, frames_read, true, false, _FPP)) {
+				lp.acquire();
 				break;
 			}
 
@@ -818,9 +834,22 @@ AudioSource::prepare_for_peakfile_writes ()
 	return 0;
 }
 
+/** _lock MUST be held by caller */
 void
 AudioSource::done_with_peakfile_writes (bool done)
 {
+	Glib::Threads::Mutex::Lock lp (_peak_compute_lock);
+
+	if (_live_peak_data) {
+		/* deal with whatever the live peak thread has not done yet */
+		if (!_session.deletion_in_progress() && !_session.peaks_cleanup_in_progres()) {
+			flush_live_peaks (_live_peak_data->read_space ());
+		}
+		Glib::Threads::Mutex::Lock lq (_live_peak_lock);
+		delete _live_peak_data;
+		_live_peak_data = 0;
+	}
+
 	if (_session.deletion_in_progress() || _session.peaks_cleanup_in_progres()) {
 		if (_peakfile_fd) {
 			close (_peakfile_fd);
@@ -843,8 +872,160 @@ AudioSource::done_with_peakfile_writes (bool done)
 	_peakfile_fd = -1;
 }
 
+void
+AudioSource::init_live_peaks ()
+{
+	Glib::Threads::Thread::create (sigc::ptr_fun (&AudioSource::live_peak_work));
+}
+
+void
+AudioSource::prepare_for_live_peaks ()
+{
+	if (!Config->get_live_peaks_in_own_thread()) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lq (_live_peak_lock);
+
+	if (!_live_peak_data) {
+		_live_peak_data = new PBD::RingBufferNPT<Sample> ((framecnt_t) (sample_rate() * Config->get_audio_capture_buffer_seconds()) + 1);
+	}
+}
+
+void
+AudioSource::live_peak_work ()
+{
+	SessionEvent::create_per_thread_pool (X_("LivePeaks"), 64);
+
+	while (true) {
+		_live_peak_queue_lock.lock ();
+
+	  wait:
+		if (_live_peak_queue.empty()) {
+			_live_peaks_to_compute.wait (_live_peak_queue_lock);
+		}
+
+		if (_live_peak_queue.empty()) {
+			goto wait;
+		}
+
+		boost::shared_ptr<AudioSource> as (_live_peak_queue.front().lock());
+		_live_peak_queue.pop_front ();
+		_live_peak_queue_lock.unlock ();
+
+		if (!as) {
+			continue;
+		}
+
+		{
+			/* not the source's _lock: the writer keeps going */
+			Glib::Threads::Mutex::Lock lp (as->_peak_compute_lock);
+			as->flush_live_peaks (live_peak_chunk);
+		}
+
+		Glib::Threads::Mutex::Lock lq (as->_live_peak_lock);
+
+		if (as->_live_peak_data && as->_live_peak_data->read_space ()) {
+			/* more to do, but give other sources a go first */
+			Glib::Threads::Mutex::Lock lw (_live_peak_queue_lock);
+			_live_peak_queue.push_back (as);
+		} else {
+			as->_live_peak_queued = false;
+		}
+	}
+}
+
+/** Compute peaks for up to @param max_frames of the data waiting in
+ * _live_peak_data. _peak_compute_lock MUST be held by caller, which makes
+ * it the only reader of _live_peak_data. The data is read in place:
+ * the writer only ever adds to it.
+ */
+void
+AudioSource::flush_live_peaks (framecnt_t max_frames)
+{
+	while (max_frames > 0) {
+
+		PBD::RingBufferNPT<Sample>::rw_vector vec;
+		framepos_t frame;
+
+		{
+			Glib::Threads::Mutex::Lock lq (_live_peak_lock);
+			if (!_live_peak_data) {
+				return;
+			}
+			_live_peak_data->get_read_vector (&vec);
+			frame = _live_peak_frame;
+		}
+
+		const framecnt_t cnt = min ((framecnt_t) vec.len[0], max_frames);
+
+		if (cnt == 0) {
+			break;
+		}
+
+		compute_and_write_peaks (vec.buf[0], frame, cnt, true, true);
+
+		Glib::Threads::Mutex::Lock lq (_live_peak_lock);
+		_live_peak_data->increment_read_ptr (cnt);
+		_live_peak_frame += cnt;
+		max_frames -= cnt;
+	}
+}
+
+/** Like compute_and_write_peaks(), for data that is being written as it is
+ * recorded. If live-peaks-in-own-thread is set, the data is copied and peaks
+ * are computed by the live peak thread, so that the caller (usually the
+ * butler) is not held up by peak computation and peakfile i/o.
+ *
+ * @param first_frame Offset from the source start of the first frame of @param buf.
+ * _lock MUST be held by caller.
+ */
+void
+AudioSource::compute_and_write_live_peaks (Sample* buf, framepos_t first_frame, framecnt_t cnt)
+{
+	{
+		Glib::Threads::Mutex::Lock lq (_live_peak_lock);
+
+		if (_live_peak_data && Config->get_live_peaks_in_own_thread()) {
+
+			const framecnt_t pending = _live_peak_data->read_space ();
+
+			if (pending == 0) {
+				_live_peak_frame = first_frame;
+			}
+
+			/* the new data must follow on from what is waiting (this
+			   is not so after a destructive write after a locate) and
+			   fit; otherwise catch up and do it here.
+			*/
+			if ((pending == 0 || first_frame == _live_peak_frame + pending) && (framecnt_t) _live_peak_data->write_space () >= cnt) {
+
+				_live_peak_data->write (buf, cnt);
+
+				if (!_live_peak_queued) {
+					_live_peak_queued = true;
+					Glib::Threads::Mutex::Lock lm (_live_peak_queue_lock);
+					_live_peak_queue.push_back (boost::weak_ptr<AudioSource> (shared_from_this ()));
+					_live_peaks_to_compute.signal ();
+				}
+				return;
+			}
+		}
+	}
+
+	/* no live peak buffer (the option is off, or was turned on while
+	   writing) or the live peak thread is not keeping up.
+	*/
+
+	Glib::Threads::Mutex::Lock lp (_peak_compute_lock);
+
+	flush_live_peaks (max_framepos);
+	compute_and_write_peaks (buf, first_frame, cnt, true, true);
+}
+
 /** @param first_frame Offset from the source start of the first frame to
- * process. _lock MUST be held by caller.
+ * process. _lock MUST be held by caller, or _peak_compute_lock for data
+ * being recorded (see ::flush_live_peaks()).
 */
 int
 AudioSource::compute_and_write_peaks (Sample* buf, framecnt_t first_frame, framecnt_t cnt,
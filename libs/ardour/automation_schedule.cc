@@ -0,0 +1,222 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <glibmm/threads.h>
+
+#include "evoral/ControlList.hpp"
+
+#include "ardour/automation_control.h"
+#include "ardour/automation_schedule.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+AutomationSchedule::AutomationSchedule ()
+{
+}
+
+void
+AutomationSchedule::set_controls (vector<boost::shared_ptr<AutomationControl> > const& controls)
+{
+	_list_connections.drop_connections ();
+	_entries.clear ();
+
+	for (vector<boost::shared_ptr<AutomationControl> >::const_iterator c = controls.begin(); c != controls.end(); ++c) {
+		if (!(*c)->list ()) {
+			continue;
+		}
+		Entry e;
+		e.control = *c;
+		_entries.push_back (e);
+	}
+
+	for (size_t n = 0; n < _entries.size (); ++n) {
+		boost::shared_ptr<Evoral::ControlList> list (_entries[n].control->list ());
+		list->Dirty.connect_same_thread (_list_connections, boost::bind (&AutomationSchedule::list_changed, this, n));
+		list->InterpolationChanged.connect_same_thread (_list_connections, boost::bind (&AutomationSchedule::list_changed, this, n));
+	}
+}
+
+void
+AutomationSchedule::list_changed (size_t n)
+{
+	g_atomic_int_set (&_entries[n].dirty, 1);
+}
+
+void
+AutomationSchedule::invalidate ()
+{
+	for (size_t n = 0; n < _entries.size (); ++n) {
+		list_changed (n);
+	}
+}
+
+/** Make sure that e.segment is the segment of the control's list that
+ * @param now falls into.
+ * @return false if the list is busy (being edited)
+ */
+bool
+AutomationSchedule::locate (Entry& e, double now)
+{
+	if (g_atomic_int_compare_and_exchange (&e.dirty, 1, 0)) {
+		e.have_segment = false;
+	}
+
+	Evoral::ControlList const& list (*e.control->list ());
+
+	if (e.have_segment && now >= e.segment.from && now < e.segment.to) {
+		return true;
+	}
+
+	Glib::Threads::RWLock::ReaderLock lm (list.lock (), Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		return false;
+	}
+
+	find_segment (list, now, e.segment);
+	e.value_set = false;
+	++_stats.lookups;
+
+	/* edits of a frozen list (e.g. a drag in the GUI) are signalled
+	 * as they happen, see list_changed()
+	 */
+	e.have_segment = true;
+
+	return true;
+}
+
+void
+AutomationSchedule::run (double now)
+{
+	for (Entries::iterator e = _entries.begin(); e != _entries.end(); ++e) {
+
+		if (!e->control->automation_playback ()) {
+			/* the value may be changed by other means until playback
+			 * (re)starts, e.g. at the end of a touch.
+			 */
+			e->value_set = false;
+			continue;
+		}
+
+		if (!locate (*e, now)) {
+			continue;
+		}
+
+		double val;
+
+		if (e->segment.constant) {
+
+			if (e->value_set) {
+				++_stats.skipped;
+				continue;
+			}
+
+			val = e->segment.value;
+
+		} else {
+
+			bool valid;
+
+			val = e->control->list ()->rt_safe_eval (now, valid);
+
+			if (!valid) {
+				continue;
+			}
+		}
+
+		/* see PluginInsert::connect_and_run() for why this may
+		 * use set_value_unchecked()
+		 */
+		e->control->set_value_unchecked (val);
+		e->value_set = true;
+		++_stats.evaluations;
+	}
+}
+
+bool
+AutomationSchedule::next_event (double now, double end, double& when)
+{
+	when = numeric_limits<double>::max ();
+
+	for (Entries::iterator e = _entries.begin(); e != _entries.end(); ++e) {
+
+		if (!e->control->automation_playback () || !locate (*e, now)) {
+			continue;
+		}
+
+		when = min (when, e->segment.to);
+	}
+
+	return when < end;
+}
+
+void
+AutomationSchedule::find_segment (Evoral::ControlList const& list, double when, Segment& s)
+{
+	Evoral::ControlList::EventList const& events (list.events ());
+
+	s.from = -numeric_limits<double>::max ();
+	s.to = numeric_limits<double>::max ();
+	s.constant = true;
+
+	if (events.empty ()) {
+		s.value = list.default_value ();
+		return;
+	}
+
+	const Evoral::ControlEvent cp (when, 0.0);
+	Evoral::ControlList::const_iterator next = upper_bound (events.begin(), events.end(), &cp, Evoral::ControlList::time_comparator);
+
+	if (next == events.begin()) {
+		/* before the first control point, which has the value */
+		s.to = (*next)->when;
+		s.value = (*next)->value;
+		return;
+	}
+
+	Evoral::ControlList::const_iterator prev = next;
+	--prev;
+
+	s.from = (*prev)->when;
+	s.value = (*prev)->value;
+
+	if (next == events.end()) {
+		/* after the last control point */
+		return;
+	}
+
+	s.to = (*next)->when;
+
+	switch (list.interpolation ()) {
+	case Evoral::ControlList::Discrete:
+		break;
+	case Evoral::ControlList::Linear:
+		s.constant = ((*prev)->value == (*next)->value);
+		break;
+	default:
+		/* a curve may overshoot even between equal values */
+		s.constant = false;
+		break;
+	}
+}
@@ -17,6 +17,8 @@
 
 */
 
+#include <algorithm>
+#include <cmath>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -27,6 +29,7 @@
 
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
+#include "ardour/audio_diskstream.h"
 #include "ardour/debug.h"
 #include "ardour/butler.h"
 #include "ardour/io.h"
@@ -162,7 +165,6 @@ Butler::thread_work ()
 	uint32_t err = 0;
 
 	bool disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time()));
@@ -209,6 +211,8 @@ Butler::thread_work ()
 			DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttransport work complete @ %1\n", g_get_monotonic_time()));
 		}
 
+		_session.queue_clicks ();
+
 		frameoffset_t audition_seek;
 		if (should_run && _session.is_auditioning()
 				&& (audition_seek = _session.the_auditioner()->seek_frame()) >= 0) {
@@ -219,56 +223,16 @@ Butler::thread_work ()
 			_session.the_auditioner()->seek_response(audition_seek);
 		}
 
-		boost::shared_ptr<RouteList> rl = _session.get_routes();
-
-		RouteList rl_with_auditioner = *rl;
-		rl_with_auditioner.push_back (_session.the_auditioner());
-
-		for (i = rl_with_auditioner.begin(); !transport_work_requested() && should_run && i != rl_with_auditioner.end(); ++i) {
-
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active()) {
-				/* don't read inactive tracks */
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-			case 0:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-				break;
-
-			case 1:
-				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
-				disk_work_outstanding = true;
-				break;
-
-			default:
-				error << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << endmsg;
-                                std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), (*i)->name()) << std::endl;
-				break;
-			}
-
-		}
-
-		if (i != rl_with_auditioner.begin() && i != rl_with_auditioner.end()) {
-			/* we didn't get to all the streams */
-			disk_work_outstanding = true;
-		}
+		queue_disk_work (_session.get_routes());
+		disk_work_outstanding = do_disk_work (err);
 
-		if (!err && transport_work_requested()) {
-			DEBUG_TRACE (DEBUG::Butler, "transport work requested during refill, back to restart\n");
-			goto restart;
+#ifndef NDEBUG
+		if (DEBUG_ENABLED (DEBUG::Butler) && _session.actively_recording()) {
+			AudioDiskstream::CaptureStats const cs (AudioDiskstream::capture_stats ());
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("capture: %1 MB in %2 flushes, %3 MB/s, worst flush %4 ms\n",
+			                                            cs.bytes / 1048576, cs.flushes, cs.throughput () / 1048576.0, cs.max_flush_usecs / 1000.0));
 		}
-
-		disk_work_outstanding = flush_tracks_to_disk_normal (rl, err);
+#endif
 
 		if (err && _session.actively_recording()) {
 			/* stop the transport and try to catch as much possible
@@ -279,7 +243,7 @@ Butler::thread_work ()
 		}
 
 		if (!err && transport_work_requested()) {
-			DEBUG_TRACE (DEBUG::Butler, "transport work requested during flush, back to restart\n");
+			DEBUG_TRACE (DEBUG::Butler, "transport work requested during disk i/o, back to restart\n");
 			goto restart;
 		}
 
@@ -302,19 +266,32 @@ Butler::thread_work ()
 
 		DEBUG_TRACE (DEBUG::Butler, "butler emptying pool trash\n");
 		empty_pool_trash ();
+
+		/* meter snapshot buffers retired by resizes are freed here,
+		 * never in the process thread
+		 */
+		boost::shared_ptr<RouteList> rl = _session.get_routes ();
+		for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
+			(*i)->flush_meter_snapshots ();
+		}
 	}
 
 	return (0);
 }
 
-bool
-Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+void
+Butler::queue_disk_work (boost::shared_ptr<RouteList> rl)
 {
-	bool disk_work_outstanding = false;
+	/* when the buffers are consumed faster than realtime, they also run dry sooner */
+	const double speed = std::max (1.0, fabs (_session.transport_speed ()));
+	const bool rolling = _session.transport_speed () != 0;
 
-	for (RouteList::iterator i = rl->begin(); !transport_work_requested() && should_run && i != rl->end(); ++i) {
+	_disk_work.clear ();
 
-		// cerr << "write behind for " << (*i)->name () << endl;
+	RouteList tracks = *rl;
+	tracks.push_back (_session.the_auditioner());
+
+	for (RouteList::iterator i = tracks.begin(); i != tracks.end(); ++i) {
 
 		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
 
@@ -322,33 +299,109 @@ Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t&
 			continue;
 		}
 
-		/* note that we still try to flush diskstreams attached to inactive routes
+		boost::shared_ptr<IO> io = tr->input ();
+
+		if (io && !io->active()) {
+			/* don't read inactive tracks */
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
+		} else {
+			/* buffer sizes may be adapted per track; MIDI tracks have none of their own,
+			 * they read ahead by a fixed time.
+			 */
+			framecnt_t bufsize = tr->playback_buffer_size ();
+			if (bufsize == 0) {
+				bufsize = MidiDiskstream::readahead_frames ();
+			}
+
+			const framecnt_t buffered = tr->playback_frames_buffered ();
+			const framecnt_t to_underrun = buffered == max_framecnt ? max_framecnt : (framecnt_t) (buffered / speed);
+
+			if (rolling && to_underrun < bufsize / 8) {
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("track %1 is %2 frames from a playback underrun\n", tr->name(), to_underrun));
+				tr->note_near_underrun ();
+			}
+
+			_disk_work.push_back (DiskWork (tr, DiskWork::Refill, to_underrun));
+		}
+
+		/* note that we still try to flush diskstreams attached to inactive routes.
+		 * The auditioner does not record.
 		 */
+		if (*i != _session.the_auditioner()) {
+			const framecnt_t to_overrun = tr->capture_buffer_load () * audio_dstream_capture_buffer_size;
+			_disk_work.push_back (DiskWork (tr, DiskWork::Flush, to_overrun));
+		}
+	}
 
-		int ret;
+	/* most urgent first. On a tie, reads go before writes and
+	 * tracks retain their order.
+	 */
+	std::stable_sort (_disk_work.begin(), _disk_work.end());
+}
 
-		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
-		ret = tr->do_flush (ButlerContext, false);
-		switch (ret) {
-		case 0:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
-			break;
+bool
+Butler::do_disk_work (uint32_t& errors)
+{
+	bool disk_work_outstanding = false;
+	std::vector<DiskWork>::iterator i;
 
-		case 1:
-			DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
-			disk_work_outstanding = true;
-			break;
+	for (i = _disk_work.begin(); !transport_work_requested() && should_run && i != _disk_work.end(); ++i) {
 
-		default:
-			errors++;
-			error << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << endmsg;
-			std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), (*i)->name()) << std::endl;
-			/* don't break - try to flush all streams in case they
-			   are split across disks.
-			*/
+		boost::shared_ptr<Track> tr = i->track;
+
+		if (i->type == DiskWork::Refill) {
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
+
+			switch (tr->do_refill ()) {
+			case 0:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name()));
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				error << string_compose(_("Butler read ahead failure on dstream %1"), tr->name()) << endmsg;
+				std::cerr << string_compose(_("Butler read ahead failure on dstream %1"), tr->name()) << std::endl;
+				break;
+			}
+
+		} else {
+
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
+
+			switch (tr->do_flush (ButlerContext, false)) {
+			case 0:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
+				break;
+
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
+				disk_work_outstanding = true;
+				break;
+
+			default:
+				errors++;
+				error << string_compose(_("Butler write-behind failure on dstream %1"), tr->name()) << endmsg;
+				std::cerr << string_compose(_("Butler write-behind failure on dstream %1"), tr->name()) << std::endl;
+				/* don't break - try to flush all streams in case they
+				   are split across disks.
+				*/
+			}
 		}
 	}
 
+	if (i != _disk_work.begin() && i != _disk_work.end()) {
+		/* we didn't get to all the streams */
+		disk_work_outstanding = true;
+	}
+
+	/* do not hold on to the tracks */
+	_disk_work.clear ();
+
 	return disk_work_outstanding;
 }
 
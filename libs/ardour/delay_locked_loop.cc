@@ -0,0 +1,108 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cmath>
+
+#include "ardour/delay_locked_loop.h"
+
+using namespace ARDOUR;
+
+DelayLockedLoop::DelayLockedLoop ()
+	: _t0 (0)
+	, _t1 (0)
+	, _e2 (0)
+	, _b (0)
+	, _c (0)
+	, _omega (0)
+	, _acquire_factor (1.0)
+	, _acquire_updates (0)
+	, _acquire_left (0)
+	, _initialized (false)
+{
+	reset_stats ();
+}
+
+double
+DelayLockedLoop::omega (double bandwidth, double interval)
+{
+	return 2.0 * M_PI * bandwidth * interval;
+}
+
+void
+DelayLockedLoop::set_coefficients (double omega)
+{
+	_b = 1.4142135623730950488 * omega;
+	_c = omega * omega;
+}
+
+void
+DelayLockedLoop::set_omega (double omega)
+{
+	_omega = omega;
+	if (_acquire_left == 0) {
+		set_coefficients (omega);
+	}
+}
+
+void
+DelayLockedLoop::set_acquisition (double factor, uint32_t n_updates)
+{
+	_acquire_factor = factor > 1.0 ? factor : 1.0;
+	_acquire_updates = _acquire_factor > 1.0 ? n_updates : 0;
+}
+
+void
+DelayLockedLoop::init (double t, double period)
+{
+	_e2 = period;
+	_t0 = t;
+	_t1 = t + period;
+	_initialized = true;
+	_acquire_left = _acquire_updates;
+	reset_stats ();
+	set_coefficients (_acquire_left > 0 ? _omega * _acquire_factor : _omega);
+}
+
+void
+DelayLockedLoop::update_acquisition ()
+{
+	/* narrow the bandwidth geometrically from the acquisition
+	 * bandwidth down to the nominal one.
+	 */
+	--_acquire_left;
+	set_coefficients (_omega * pow (_acquire_factor, (double) _acquire_left / (double) _acquire_updates));
+}
+
+double
+DelayLockedLoop::jitter () const
+{
+	if (_n_updates < 2) {
+		return 0;
+	}
+	return sqrt (_err_m2 / (double) (_n_updates - 1));
+}
+
+void
+DelayLockedLoop::reset_stats ()
+{
+	_n_updates = 0;
+	_err_mean = 0;
+	_err_m2 = 0;
+	_err_max = 0;
+}
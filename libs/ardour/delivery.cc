@@ -17,12 +17,14 @@
 */
 
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 #include "pbd/enumwriter.h"
 #include "pbd/convert.h"
 
 #include "ardour/amp.h"
+#include "ardour/audio_port.h"
 #include "ardour/audioengine.h"
 #include "ardour/buffer_set.h"
 #include "ardour/debug.h"
@@ -56,6 +58,12 @@ Delivery::Delivery (Session& s, boost::shared_ptr<IO> io, boost::shared_ptr<Pann
 	, _no_outs_cuz_we_no_monitor (false)
 	, _mute_master (mm)
 	, _no_panner_reset (false)
+	, _pipelined (false)
+	, _pipeline_wanted (false)
+	, _pipeline_clear (false)
+	, _pipeline_delay (0)
+	, _pipeline_pos (0)
+	, _pipeline_advance (0)
 {
 	if (pannable) {
 		bool is_send = false;
@@ -80,6 +88,12 @@ Delivery::Delivery (Session& s, boost::shared_ptr<Pannable> pannable, boost::sha
 	, _no_outs_cuz_we_no_monitor (false)
 	, _mute_master (mm)
 	, _no_panner_reset (false)
+	, _pipelined (false)
+	, _pipeline_wanted (false)
+	, _pipeline_clear (false)
+	, _pipeline_delay (0)
+	, _pipeline_pos (0)
+	, _pipeline_advance (0)
 {
 	if (pannable) {
 		bool is_send = false;
@@ -107,6 +121,7 @@ Delivery::~Delivery()
 
 	ScopedConnectionList::drop_connections ();
 
+	drop_pipeline ();
 	delete _output_buffers;
 }
 
@@ -235,22 +250,42 @@ Delivery::run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame, do
 
 	PortSet& ports (_output->ports());
 	gain_t tgain;
+	BufferSet* obufs = _output_buffers;
+	Glib::Threads::Mutex::Lock lm (_pipeline_lock, Glib::Threads::NOT_LOCK);
 
 	if (ports.num_ports () == 0) {
 		goto out;
 	}
 
 	if (!_active && !_pending_active) {
-		_output->silence (nframes);
+		if (!_pipelined) {
+			_output->silence (nframes);
+		}
 		goto out;
 	}
 
-	/* this setup is not just for our purposes, but for anything that comes after us in the
-	 * processing pathway that wants to use this->output_buffers() for some reason.
-	 */
+	if (_pipelined) {
+
+		/* routes reading from our ports do not wait for us: never
+		 * touch the port buffers, but write to the pipeline which
+		 * ::deliver_pipelined() copies to the ports next cycle.
+		 */
+
+		if (!lm.try_acquire () || !_pipelined || _pipeline_clear || _pipeline_buffers.empty ()) {
+			goto out;
+		}
+
+		obufs = &_session.get_scratch_buffers (ChanCount (DataType::AUDIO, _pipeline_buffers.size ()), true);
 
-	// TODO delayline -- latency-compensation
-	output_buffers().get_backend_port_addresses (ports, nframes);
+	} else {
+
+		/* this setup is not just for our purposes, but for anything that comes after us in the
+		 * processing pathway that wants to use this->output_buffers() for some reason.
+		 */
+
+		// TODO delayline -- latency-compensation
+		output_buffers().get_backend_port_addresses (ports, nframes);
+	}
 
 	// this Delivery processor is not a derived type, and thus we assume
 	// we really can modify the buffers passed in (it is almost certainly
@@ -268,11 +303,14 @@ Delivery::run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame, do
 
 		/* we were quiet last time, and we're still supposed to be quiet.
 			 Silence the outputs, and make sure the buffers are quiet too,
+			 (the pipeline was already silenced by ::deliver_pipelined())
 			 */
 
-		_output->silence (nframes);
+		if (!_pipelined) {
+			_output->silence (nframes);
+		}
 		if (result_required) {
-			bufs.set_count (output_buffers().count ());
+			bufs.set_count (obufs->count ());
 			Amp::apply_simple_gain (bufs, nframes, GAIN_COEFF_ZERO);
 		}
 		goto out;
@@ -295,16 +333,27 @@ Delivery::run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame, do
 
 		// Use the panner to distribute audio to output port buffers
 
-		_panshell->run (bufs, output_buffers(), start_frame, end_frame, nframes);
+		_panshell->run (bufs, *obufs, start_frame, end_frame, nframes);
 
 		// non-audio data will not have been delivered by the panner
+		// (pipelined deliveries only have audio outputs)
 
-		for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
+		for (DataType::iterator t = DataType::begin(); !_pipelined && t != DataType::end(); ++t) {
 			if (*t != DataType::AUDIO && bufs.count().get(*t) > 0) {
 				_output->copy_to_outputs (bufs, *t, nframes, ports.port(0)->port_offset());
 			}
 		}
 
+	} else if (_pipelined) {
+
+		// 1:1 copy, extra outputs receive a copy of the last buffer, like IO::copy_to_outputs()
+
+		const uint32_t n_in = bufs.count().n_audio();
+
+		for (uint32_t n = 0; n_in > 0 && n < obufs->count().n_audio(); ++n) {
+			obufs->get_audio (n).read_from (bufs.get_audio (min (n, n_in - 1)), nframes);
+		}
+
 	} else {
 
 		// Do a 1:1 copy of data to output ports
@@ -322,8 +371,12 @@ Delivery::run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame, do
 		}
 	}
 
+	if (_pipelined) {
+		write_pipeline (*obufs, nframes);
+	}
+
 	if (result_required) {
-		bufs.read_from (output_buffers (), nframes);
+		bufs.read_from (*obufs, nframes);
 	}
 
 out:
@@ -504,6 +557,15 @@ Delivery::realtime_locate ()
                         i->realtime_locate ();
                 }
         }
+
+	/* do not play out what was rendered for the previous position */
+
+	Glib::Threads::Mutex::Lock lm (_pipeline_lock, Glib::Threads::TRY_LOCK);
+	if (lm.locked ()) {
+		for (vector<Sample*>::iterator i = _pipeline_buffers.begin(); i != _pipeline_buffers.end(); ++i) {
+			memset (*i, 0, sizeof (Sample) * 2 * _pipeline_delay);
+		}
+	}
 }
 
 gain_t
@@ -585,6 +647,195 @@ Delivery::output_changed (IOChange change, void* /*src*/)
 	if (change.type & IOChange::ConfigurationChanged) {
 		reset_panner ();
 		_output_buffers->attach_buffers (_output->ports ());
+
+		Glib::Threads::Mutex::Lock lm (_pipeline_lock);
+		if (!_pipeline_buffers.empty ()) {
+			reset_pipeline ();
+		}
+	}
+}
+
+/** Allocate (or free) the pipeline for a change of ::set_pipelined()
+ * that is about to happen. Called from a non-realtime thread.
+ * @return true if this changes our latency
+ */
+bool
+Delivery::prepare_pipeline (bool yn)
+{
+	if (_role != Main || !_output) {
+		return false;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_pipeline_lock);
+
+	const bool changed = (yn != _pipeline_wanted);
+	_pipeline_wanted = yn;
+
+	if (yn) {
+		if (_pipeline_buffers.empty () || _pipeline_delay != _session.engine().samples_per_cycle()) {
+			reset_pipeline ();
+		}
+	} else if (!_pipelined) {
+		/* if we are still pipelined, the next call frees it */
+		drop_pipeline ();
+	}
+
+	return changed;
+}
+
+/** Called from the process thread at the start of a cycle, before
+ * ::deliver_pipelined(). Must not allocate: see ::prepare_pipeline().
+ */
+void
+Delivery::set_pipelined (bool yn)
+{
+	if (_role != Main || !_output || yn == _pipelined) {
+		return;
+	}
+
+	_pipelined = yn;
+
+	/* ::deliver_pipelined() silences what is left from last time */
+	_pipeline_clear = yn;
+}
+
+framecnt_t
+Delivery::signal_latency () const
+{
+	/* the state that the next graph will have, if it differs */
+	return _pipeline_wanted ? _pipeline_delay : 0;
+}
+
+int
+Delivery::set_block_size (pframes_t nframes)
+{
+	Glib::Threads::Mutex::Lock lm (_pipeline_lock);
+
+	if (!_pipeline_buffers.empty () && _pipeline_delay != _session.engine().samples_per_cycle()) {
+		reset_pipeline ();
+	}
+
+	return IOProcessor::set_block_size (nframes);
+}
+
+/** (Re)allocate the pipeline: one cycle of delay plus the cycle
+ * being written, for every audio output.
+ * Must be called with _pipeline_lock held.
+ */
+void
+Delivery::reset_pipeline ()
+{
+	drop_pipeline ();
+
+	_pipeline_delay = _session.engine().samples_per_cycle();
+
+	const uint32_t n_audio = _output->n_ports().n_audio();
+
+	for (uint32_t n = 0; n < n_audio; ++n) {
+		Sample* buf = new Sample[2 * _pipeline_delay];
+		memset (buf, 0, sizeof (Sample) * 2 * _pipeline_delay);
+		_pipeline_buffers.push_back (buf);
+	}
+}
+
+/** Must be called with _pipeline_lock held */
+void
+Delivery::drop_pipeline ()
+{
+	for (vector<Sample*>::iterator i = _pipeline_buffers.begin(); i != _pipeline_buffers.end(); ++i) {
+		delete [] *i;
+	}
+	_pipeline_buffers.clear ();
+	_pipeline_pos = 0;
+	_pipeline_advance = 0;
+}
+
+/** Called from the process thread before any route runs, to deliver what
+ * ::run() wrote one cycle ago to our output ports.
+ */
+void
+Delivery::deliver_pipelined (pframes_t nframes)
+{
+	if (!_pipelined) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_pipeline_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked () || !_pipelined || _pipeline_delay < nframes) {
+		_output->silence (nframes);
+		return;
+	}
+
+	if (_pipeline_clear) {
+		for (vector<Sample*>::iterator i = _pipeline_buffers.begin(); i != _pipeline_buffers.end(); ++i) {
+			memset (*i, 0, sizeof (Sample) * 2 * _pipeline_delay);
+		}
+		_pipeline_pos = 0;
+		_pipeline_advance = 0;
+		_pipeline_clear = false;
+	}
+
+	const framecnt_t size = 2 * _pipeline_delay;
+
+	/* move on by the size of the previous (sub-)cycle. The data written
+	 * at _pipeline_pos is read back exactly _pipeline_delay samples later.
+	 */
+
+	_pipeline_pos = (_pipeline_pos + _pipeline_advance) % size;
+	_pipeline_advance = nframes;
+
+	const framecnt_t rpos = (_pipeline_pos + size - _pipeline_delay) % size;
+	const framecnt_t n1 = min ((framecnt_t) nframes, size - rpos);
+	const framecnt_t w1 = min ((framecnt_t) nframes, size - _pipeline_pos);
+
+	const uint32_t n_audio = _output->n_ports().n_audio();
+
+	for (uint32_t n = 0; n < n_audio; ++n) {
+
+		AudioBuffer& out (_output->ports().nth_audio_port (n)->get_audio_buffer (nframes));
+
+		if (n >= _pipeline_buffers.size ()) {
+			out.silence (nframes);
+			continue;
+		}
+
+		Sample* buf = _pipeline_buffers[n];
+
+		out.read_from (buf + rpos, n1);
+		if (n1 < nframes) {
+			out.read_from (buf, nframes - n1, n1);
+		}
+
+		/* pre-silence the part that this cycle's ::run() writes to */
+
+		memset (buf + _pipeline_pos, 0, sizeof (Sample) * w1);
+		if (w1 < nframes) {
+			memset (buf, 0, sizeof (Sample) * (nframes - w1));
+		}
+	}
+}
+
+/** Must be called with _pipeline_lock held */
+void
+Delivery::write_pipeline (BufferSet& bufs, pframes_t nframes)
+{
+	const framecnt_t size = 2 * _pipeline_delay;
+	const framecnt_t w1 = min ((framecnt_t) nframes, size - _pipeline_pos);
+	const uint32_t n_audio = min ((uint32_t) _pipeline_buffers.size (), bufs.count().n_audio());
+
+	if (nframes > _pipeline_delay) {
+		return;
+	}
+
+	for (uint32_t n = 0; n < n_audio; ++n) {
+		Sample const* src = bufs.get_audio (n).data ();
+		Sample* buf = _pipeline_buffers[n];
+
+		memcpy (buf + _pipeline_pos, src, sizeof (Sample) * w1);
+		if (w1 < nframes) {
+			memcpy (buf, src + w1, sizeof (Sample) * (nframes - w1));
+		}
 	}
 }
 
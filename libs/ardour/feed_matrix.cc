@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cassert>
+
+#include "ardour/feed_matrix.h"
+
+using namespace ARDOUR;
+
+void
+FeedMatrix::reset (uint32_t n)
+{
+	_downstream.assign (n, Set (n));
+	_audible.assign (n, Set (n));
+	_upstream.assign (n, Set (n));
+	_upstream_audible.assign (n, Set (n));
+}
+
+void
+FeedMatrix::swap (FeedMatrix& other)
+{
+	_downstream.swap (other._downstream);
+	_audible.swap (other._audible);
+	_upstream.swap (other._upstream);
+	_upstream_audible.swap (other._upstream_audible);
+}
+
+void
+FeedMatrix::add (uint32_t from, uint32_t to, bool via_sends_only)
+{
+	assert (from < size () && to < size ());
+
+	_downstream[from].set (to);
+	if (!via_sends_only) {
+		_audible[from].set (to);
+	}
+}
+
+void
+FeedMatrix::transitive_closure (std::vector<Set>& m)
+{
+	/* Warshall's algorithm, one row at a time: if i reaches k,
+	 * i also reaches everything that k reaches. Cycles (feedback)
+	 * are harmless here, nodes in a loop simply reach themselves.
+	 */
+	const size_t n = m.size ();
+
+	for (size_t k = 0; k < n; ++k) {
+		Set const& via = m[k];
+		if (via.none ()) {
+			continue;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			if (i != k && m[i].test (k)) {
+				m[i] |= via;
+			}
+		}
+	}
+}
+
+void
+FeedMatrix::transpose (std::vector<Set> const& m, std::vector<Set>& t)
+{
+	const size_t n = m.size ();
+
+	for (size_t i = 0; i < n; ++i) {
+		t[i].reset ();
+	}
+
+	for (size_t i = 0; i < n; ++i) {
+		for (Set::size_type j = m[i].find_first (); j != Set::npos; j = m[i].find_next (j)) {
+			t[j].set (i);
+		}
+	}
+}
+
+void
+FeedMatrix::close ()
+{
+	transitive_closure (_downstream);
+	transitive_closure (_audible);
+	transpose (_downstream, _upstream);
+	transpose (_audible, _upstream_audible);
+}
+
+bool
+FeedMatrix::feeds (uint32_t from, uint32_t to, bool* via_sends_only) const
+{
+	assert (from < size () && to < size ());
+
+	if (!_downstream[from].test (to)) {
+		return false;
+	}
+
+	if (via_sends_only) {
+		*via_sends_only = !_audible[from].test (to);
+	}
+
+	return true;
+}
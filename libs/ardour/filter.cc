@@ -112,7 +112,10 @@ Filter::finish (boost::shared_ptr<Region> region, SourceList& nsrcs, string regi
 	for (SourceList::iterator si = nsrcs.begin(); si != nsrcs.end(); ++si) {
 		boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource>(*si);
 		if (afs) {
-			afs->done_with_peakfile_writes ();
+			{
+				Source::Lock lm (afs->mutex());
+				afs->done_with_peakfile_writes ();
+			}
 			afs->update_header (region->position(), *now, xnow);
 			afs->mark_immutable ();
 		}
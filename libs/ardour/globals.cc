@@ -25,6 +25,7 @@
 #endif
 
 #include <cstdio> // Needed so that libraptor (included in lrdf) won't complain
+#include <iostream>
 #include <cstdlib>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -76,6 +77,7 @@
 #include "pbd/error.h"
 #include "pbd/id.h"
 #include "pbd/pbd.h"
+#include "pbd/rt_monitor.h"
 #include "pbd/strsplit.h"
 #include "pbd/fpu.h"
 #include "pbd/file_utils.h"
@@ -90,6 +92,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/audioplaylist.h"
 #include "ardour/audioregion.h"
+#include "ardour/audiosource.h"
 #include "ardour/buffer_manager.h"
 #include "ardour/control_protocol_manager.h"
 #include "ardour/directory_names.h"
@@ -137,6 +140,7 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain = 0;
 copy_vector_t			ARDOUR::copy_vector = 0;
+mix_buffers_with_fade_t ARDOUR::mix_buffers_with_fade = 0;
 
 PBD::Signal1<void,std::string> ARDOUR::BootMessage;
 PBD::Signal3<void,std::string,std::string,bool> ARDOUR::PluginScanMessage;
@@ -186,6 +190,7 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
+			mix_buffers_with_fade = x86_sse_avx_mix_buffers_with_fade;
 
 			generic_mix_functions = false;
 
@@ -200,6 +205,7 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
+			mix_buffers_with_fade = x86_sse_mix_buffers_with_fade;
 
 			generic_mix_functions = false;
 
@@ -214,6 +220,7 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_with_gain  = veclib_mix_buffers_with_gain;
 			mix_buffers_no_gain    = veclib_mix_buffers_no_gain;
 			copy_vector            = default_copy_vector;
+			mix_buffers_with_fade  = default_mix_buffers_with_fade;
 
 			generic_mix_functions = false;
 
@@ -234,6 +241,7 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_with_gain = default_mix_buffers_with_gain;
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
+		mix_buffers_with_fade = default_mix_buffers_with_fade;
 
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
@@ -431,6 +439,10 @@ ARDOUR::init (bool use_windows_vst, bool try_optimization, const char* localedir
 
 	SessionEvent::init_event_pool ();
 
+	if (getenv ("ARDOUR_RT_MONITOR")) {
+		PBD::RTMonitor::set_enabled (true);
+	}
+
 	Operations::make_operations_quarks ();
 	SessionObject::make_property_quarks ();
 	Region::make_property_quarks ();
@@ -503,6 +515,7 @@ ARDOUR::init (bool use_windows_vst, bool try_optimization, const char* localedir
 
 	SourceFactory::init ();
 	Analyser::init ();
+	AudioSource::init_live_peaks ();
 
 	/* singletons - first object is "it" */
 	(void) PluginManager::instance();
@@ -586,6 +599,10 @@ ARDOUR::cleanup ()
 
 	ARDOUR::AudioEngine::destroy ();
 
+	if (PBD::RTMonitor::enabled ()) {
+		PBD::RTMonitor::report (std::cerr);
+	}
+
 	delete Library;
 #ifdef HAVE_LRDF
 	lrdf_cleanup ();
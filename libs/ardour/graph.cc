@@ -23,8 +23,10 @@
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/rt_monitor.h"
 
 #include "ardour/debug.h"
+#include "ardour/delivery.h"
 #include "ardour/graph.h"
 #include "ardour/types.h"
 #include "ardour/session.h"
@@ -180,6 +182,7 @@ Graph::clear_other_chain ()
 
                         _nodes_rt[_setup_chain].clear ();
                         _init_trigger_list[_setup_chain].clear ();
+                        _pipeline_states[_setup_chain].clear ();
                         break;
                 }
                 /* setup chain == pending chain - we have
@@ -189,12 +192,14 @@ Graph::clear_other_chain ()
         }
 }
 
+/** Pick up a chain set up by ::rechain(), if there is one.
+ *  Called by the session at the start of a cycle, before the pipelined
+ *  outputs are delivered and before the graph runs: the pipelined state
+ *  of the routes changes together with the edges that depend on it.
+ */
 void
-Graph::prep()
+Graph::swap_chain ()
 {
-        node_list_t::iterator i;
-        int chain;
-
         if (_swap_mutex.trylock()) {
                 // we got the swap mutex.
                 if (_current_chain != _pending_chain)
@@ -202,11 +207,25 @@ Graph::prep()
                         // printf ("chain swap ! %d -> %d\n", _current_chain, _pending_chain);
                         _setup_chain = _current_chain;
                         _current_chain = _pending_chain;
+
+                        std::vector<std::pair<boost::shared_ptr<Delivery>, bool> >& ps (_pipeline_states[_current_chain]);
+                        for (std::vector<std::pair<boost::shared_ptr<Delivery>, bool> >::iterator i = ps.begin(); i != ps.end(); ++i) {
+                                i->first->set_pipelined (i->second);
+                        }
+
                         _cleanup_cond.signal ();
                 }
                 _swap_mutex.unlock ();
         }
+}
 
+void
+Graph::prep()
+{
+        node_list_t::iterator i;
+        int chain;
+
+        /* the chain was swapped by ::swap_chain() */
         chain = _current_chain;
 
         _graph_empty = true;
@@ -277,10 +296,12 @@ Graph::restart_cycle()
 /** Rechain our stuff using a list of routes (which can be in any order) and
  *  a directed graph of their interconnections, which is guaranteed to be
  *  acyclic.
+ *  @param pipelined Routes whose main outs are pipelined in the new chain;
+ *  see ::swap_chain().
  */
 
 void
-Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges)
+Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges, std::set<boost::shared_ptr<Route> > const & pipelined)
 {
         Glib::Threads::Mutex::Lock ls (_swap_mutex);
 
@@ -298,12 +319,18 @@ Graph::rechain (boost::shared_ptr<RouteList> routelist, GraphEdges const & edges
         _init_trigger_list[chain].clear();
 
         _nodes_rt[chain].clear();
+        _pipeline_states[chain].clear();
 
 	/* Clear things out, and make _nodes_rt[chain] a copy of routelist */
         for (RouteList::iterator ri=routelist->begin(); ri!=routelist->end(); ri++) {
                 (*ri)->_init_refcount[chain] = 0;
                 (*ri)->_activation_set[chain].clear();
                 _nodes_rt[chain].push_back (*ri);
+
+                boost::shared_ptr<Delivery> main_outs ((*ri)->main_outs ());
+                if (main_outs) {
+                        _pipeline_states[chain].push_back (std::make_pair (main_outs, pipelined.find (*ri) != pipelined.end ()));
+                }
         }
 
         // now add refs for the connections.
@@ -412,6 +439,8 @@ Graph::helper_thread()
 	ProcessThread* pt = new ProcessThread ();
 	resume_rt_malloc_checks ();
 
+	RTMonitor::register_thread (X_("graph helper"));
+
 	pt->get_buffers();
 
 	while(1) {
@@ -420,6 +449,8 @@ Graph::helper_thread()
 		}
 	}
 
+	RTMonitor::unregister_thread ();
+
 	pt->drop_buffers();
 	delete pt;
 }
@@ -432,6 +463,8 @@ Graph::main_thread()
 	ProcessThread* pt = new ProcessThread ();
 	resume_rt_malloc_checks ();
 
+	RTMonitor::register_thread (X_("graph main"));
+
 	pt->get_buffers();
 
 again:
@@ -459,6 +492,8 @@ again:
 		}
 	}
 
+	RTMonitor::unregister_thread ();
+
 	pt->drop_buffers();
 	delete (pt);
 }
@@ -504,11 +539,13 @@ Graph::silent_process_routes (pframes_t nframes, framepos_t start_frame, framepo
         _process_retval = 0;
         _process_need_butler = false;
 
-        if (!_graph_empty) {
-		DEBUG_TRACE(DEBUG::ProcessThreads, "wake graph for silent process\n");
-                _callback_start_sem.signal ();
-                _callback_done_sem.wait ();
-        }
+	/* always wake the graph, even if it was empty last time around:
+	   only prep() picks up a new chain, and the main thread copes
+	   with an empty graph itself.
+	*/
+	DEBUG_TRACE(DEBUG::ProcessThreads, "wake graph for silent process\n");
+        _callback_start_sem.signal ();
+        _callback_done_sem.wait ();
 
         need_butler = _process_need_butler;
 
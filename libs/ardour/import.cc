@@ -545,7 +545,10 @@ Session::import_files (ImportStatus& status)
 
 			if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(*x)) != 0) {
 				afs->update_header((*x)->natural_position(), *now, xnow);
-				afs->done_with_peakfile_writes ();
+				{
+					Source::Lock lm (afs->mutex());
+					afs->done_with_peakfile_writes ();
+				}
 
 				/* now that there is data there, requeue the file for analysis */
 
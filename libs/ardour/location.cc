@@ -769,6 +769,7 @@ Location::set_scene_change (boost::shared_ptr<SceneChange>  sc)
 
 Locations::Locations (Session& s)
 	: SessionHandleRef (s)
+	, _index_dirty (0)
 {
 	current_location = 0;
 }
@@ -804,7 +805,6 @@ Locations::set_current (Location *loc, bool want_lock)
 int
 Locations::next_available_name(string& result,string base)
 {
-	LocationList::iterator i;
 	string::size_type l;
 	int suffix;
 	char buf[32];
@@ -817,22 +817,29 @@ Locations::next_available_name(string& result,string base)
 	if (!base.empty()) {
 
 		/* find all existing names that match "base", and store
-		   the numeric part of them (if any) in the map "taken"
+		   the numeric part of them (if any) in the map "taken".
+		   The names in the index are sorted, so all names starting
+		   with "base" follow each other.
 		*/
 
-		for (i = locations.begin(); i != locations.end(); ++i) {
+		Glib::Threads::Mutex::Lock lm (lock);
+		Index const & idx (index ());
 
-			const string& temp ((*i)->name());
+		for (vector<string>::const_iterator i = lower_bound (idx.names.begin(), idx.names.end(), base); i != idx.names.end(); ++i) {
 
-			if (!temp.find (base,0)) {
-				/* grab what comes after the "base" as if it was
-				   a number, and assuming that works OK,
-				   store it in "taken" so that we know it
-				   has been used.
-				*/
-                                if ((suffix = atoi (temp.substr(l))) != 0) {
-					taken.insert (make_pair (suffix,true));
-				}
+			const string& temp (*i);
+
+			if (temp.compare (0, l, base)) {
+				break;
+			}
+
+			/* grab what comes after the "base" as if it was
+			   a number, and assuming that works OK,
+			   store it in "taken" so that we know it
+			   has been used.
+			*/
+			if ((suffix = atoi (temp.substr(l))) != 0) {
+				taken.insert (make_pair (suffix,true));
 			}
 		}
 	}
@@ -885,6 +892,7 @@ Locations::clear ()
 			++tmp;
 
 			if (!(*i)->is_session_range()) {
+				stop_listening (*i);
 				delete *i;
 				locations.erase (i);
 			}
@@ -893,6 +901,7 @@ Locations::clear ()
 		}
 
 		current_location = 0;
+		invalidate_index ();
 	}
 
 	changed (); /* EMIT SIGNAL */
@@ -911,12 +920,15 @@ Locations::clear_markers ()
 			++tmp;
 
 			if ((*i)->is_mark() && !(*i)->is_session_range()) {
+				stop_listening (*i);
 				delete *i;
 				locations.erase (i);
 			}
 
 			i = tmp;
 		}
+
+		invalidate_index ();
 	}
 
 	changed (); /* EMIT SIGNAL */
@@ -946,6 +958,7 @@ Locations::clear_ranges ()
 			}
 
 			if (!(*i)->is_mark()) {
+				stop_listening (*i);
 				delete *i;
 				locations.erase (i);
 
@@ -955,6 +968,7 @@ Locations::clear_ranges ()
 		}
 
 		current_location = 0;
+		invalidate_index ();
 	}
 
 	changed ();
@@ -973,6 +987,9 @@ Locations::add (Location *loc, bool make_current)
 		if (make_current) {
 			current_location = loc;
 		}
+
+		listen_to (loc);
+		invalidate_index ();
 	}
 
 	added (loc); /* EMIT SIGNAL */
@@ -1007,6 +1024,7 @@ Locations::remove (Location *loc)
 
 		for (i = locations.begin(); i != locations.end(); ++i) {
 			if ((*i) == loc) {
+				stop_listening (*i);
 				delete *i;
 				locations.erase (i);
 				was_removed = true;
@@ -1014,6 +1032,7 @@ Locations::remove (Location *loc)
 					current_location = 0;
 					was_current = true;
 				}
+				invalidate_index ();
 				break;
 			}
 		}
@@ -1059,14 +1078,16 @@ Locations::set_state (const XMLNode& node, int version)
 	current_location = 0;
 
 	Location* session_range_location = 0;
-	if (version < 3000) {
-		session_range_location = new Location (_session, 0, 0, _("session"), Location::IsSessionRange);
-		new_locations.push_back (session_range_location);
-	}
 
 	{
 		Glib::Threads::Mutex::Lock lm (lock);
 
+		if (version < 3000) {
+			session_range_location = new Location (_session, 0, 0, _("session"), Location::IsSessionRange);
+			new_locations.push_back (session_range_location);
+			listen_to (session_range_location);
+		}
+
 		XMLNodeConstIterator niter;
 		for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 
@@ -1090,6 +1111,7 @@ Locations::set_state (const XMLNode& node, int version)
 					loc->set_state (**niter, version);
 				} else {
 					loc = new Location (_session, **niter);
+					listen_to (loc);
 				}
 
 				bool add = true;
@@ -1148,6 +1170,7 @@ Locations::set_state (const XMLNode& node, int version)
 			}
 
 			if (!found) {
+				stop_listening (*i);
 				delete *i;
 				locations.erase (i);
 			}
@@ -1162,6 +1185,8 @@ Locations::set_state (const XMLNode& node, int version)
 		} else {
 			current_location = 0;
 		}
+
+		invalidate_index ();
 	}
 
 	changed (); /* EMIT SIGNAL */
@@ -1170,50 +1195,24 @@ Locations::set_state (const XMLNode& node, int version)
 }
 
 
-typedef std::pair<framepos_t,Location*> LocationPair;
-
-struct LocationStartEarlierComparison
-{
-	bool operator() (LocationPair a, LocationPair b) {
-		return a.first < b.first;
-	}
-};
-
-struct LocationStartLaterComparison
-{
-	bool operator() (LocationPair a, LocationPair b) {
-		return a.first > b.first;
-	}
-};
-
 framepos_t
 Locations::first_mark_before (framepos_t frame, bool include_special_ranges)
 {
 	Glib::Threads::Mutex::Lock lm (lock);
-	vector<LocationPair> locs;
+	Index const & idx (index ());
+	Index::Marks::const_iterator i = lower_bound (idx.marks.begin(), idx.marks.end(), frame, Index::Mark::before);
 
-	for (LocationList::iterator i = locations.begin(); i != locations.end(); ++i) {
-		locs.push_back (make_pair ((*i)->start(), (*i)));
-		if (!(*i)->is_mark()) {
-			locs.push_back (make_pair ((*i)->end(), (*i)));
-		}
-	}
+	/* walk back from the first mark at or after frame */
 
-	LocationStartLaterComparison cmp;
-	sort (locs.begin(), locs.end(), cmp);
-
-	/* locs is sorted in ascending order */
-
-	for (vector<LocationPair>::iterator i = locs.begin(); i != locs.end(); ++i) {
-		if ((*i).second->is_hidden()) {
+	while (i != idx.marks.begin()) {
+		--i;
+		if (i->flags & Location::IsHidden) {
 			continue;
 		}
-		if (!include_special_ranges && ((*i).second->is_auto_loop() || (*i).second->is_auto_punch())) {
+		if (!include_special_ranges && (i->flags & (Location::IsAutoLoop | Location::IsAutoPunch))) {
 			continue;
 		}
-		if ((*i).first < frame) {
-			return (*i).first;
-		}
+		return i->pos;
 	}
 
 	return -1;
@@ -1223,34 +1222,37 @@ Location*
 Locations::mark_at (framepos_t pos, framecnt_t slop) const
 {
 	Glib::Threads::Mutex::Lock lm (lock);
+	Index const & idx (index ());
 	Location* closest = 0;
 	frameoffset_t mindelta = max_framepos;
 	frameoffset_t delta;
 
-	/* locations are not necessarily stored in linear time order so we have
-	 * to iterate across all of them to find the one closest to a give point.
-	 */
+	/* only marks within [pos - slop, pos + slop] need to be considered */
 
-	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
+	for (Index::Marks::const_iterator i = lower_bound (idx.marks.begin(), idx.marks.end(), pos - slop, Index::Mark::before); i != idx.marks.end(); ++i) {
 
-		if ((*i)->is_mark()) {
-			if (pos > (*i)->start()) {
-				delta = pos - (*i)->start();
-			} else {
-				delta = (*i)->start() - pos;
-			}
+		if (i->pos > pos && i->pos - pos > slop) {
+			break;
+		}
 
-			if (slop == 0 && delta == 0) {
-				/* special case: no slop, and direct hit for position */
-				return *i;
-			}
+		if (!(i->flags & Location::IsMark)) {
+			continue;
+		}
 
-			if (delta <= slop) {
-				if (delta < mindelta) {
-					closest = *i;
-					mindelta = delta;
-				}
-			}
+		if (pos > i->pos) {
+			delta = pos - i->pos;
+		} else {
+			delta = i->pos - pos;
+		}
+
+		if (slop == 0 && delta == 0) {
+			/* special case: no slop, and direct hit for position */
+			return i->location;
+		}
+
+		if (delta < mindelta) {
+			closest = i->location;
+			mindelta = delta;
 		}
 	}
 
@@ -1261,30 +1263,16 @@ framepos_t
 Locations::first_mark_after (framepos_t frame, bool include_special_ranges)
 {
 	Glib::Threads::Mutex::Lock lm (lock);
-	vector<LocationPair> locs;
+	Index const & idx (index ());
 
-	for (LocationList::iterator i = locations.begin(); i != locations.end(); ++i) {
-		locs.push_back (make_pair ((*i)->start(), (*i)));
-		if (!(*i)->is_mark()) {
-			locs.push_back (make_pair ((*i)->end(), (*i)));
-		}
-	}
-
-	LocationStartEarlierComparison cmp;
-	sort (locs.begin(), locs.end(), cmp);
-
-	/* locs is sorted in reverse order */
-
-	for (vector<LocationPair>::iterator i = locs.begin(); i != locs.end(); ++i) {
-		if ((*i).second->is_hidden()) {
+	for (Index::Marks::const_iterator i = upper_bound (idx.marks.begin(), idx.marks.end(), frame, Index::Mark::after); i != idx.marks.end(); ++i) {
+		if (i->flags & Location::IsHidden) {
 			continue;
 		}
-		if (!include_special_ranges && ((*i).second->is_auto_loop() || (*i).second->is_auto_punch())) {
+		if (!include_special_ranges && (i->flags & (Location::IsAutoLoop | Location::IsAutoPunch))) {
 			continue;
 		}
-		if ((*i).first > frame) {
-			return (*i).first;
-		}
+		return i->pos;
 	}
 
 	return -1;
@@ -1302,64 +1290,27 @@ Locations::marks_either_side (framepos_t const frame, framepos_t& before, framep
 {
 	before = after = max_framepos;
 
-	LocationList locs;
-
-	{
-		Glib::Threads::Mutex::Lock lm (lock);
-		locs = locations;
-	}
-
-	/* Get a list of positions; don't store any that are exactly on our requested position */
+	Glib::Threads::Mutex::Lock lm (lock);
+	Index const & idx (index ());
 
-	std::list<framepos_t> positions;
+	const int ignore = Location::IsAutoLoop | Location::IsAutoPunch | Location::IsHidden;
 
-	for (LocationList::const_iterator i = locs.begin(); i != locs.end(); ++i) {
-		if (((*i)->is_auto_loop() || (*i)->is_auto_punch())) {
-			continue;
+	for (Index::Marks::const_iterator i = upper_bound (idx.marks.begin(), idx.marks.end(), frame, Index::Mark::after); i != idx.marks.end(); ++i) {
+		if (!(i->flags & ignore)) {
+			after = i->pos;
+			break;
 		}
-
-		if (!(*i)->is_hidden()) {
-			if ((*i)->is_mark ()) {
-				if ((*i)->start() != frame) {
-					positions.push_back ((*i)->start ());
-				}
-			} else {
-				if ((*i)->start() != frame) {
-					positions.push_back ((*i)->start ());
-				}
-				if ((*i)->end() != frame) {
-					positions.push_back ((*i)->end ());
-				}
-			}
-		}
-	}
-
-	if (positions.empty ()) {
-		return;
 	}
 
-	positions.sort ();
-
-	std::list<framepos_t>::iterator i = positions.begin ();
-	while (i != positions.end () && *i < frame) {
-		++i;
-	}
-
-	if (i == positions.end ()) {
-		/* run out of marks */
-		before = positions.back ();
-		return;
-	}
+	Index::Marks::const_iterator i = lower_bound (idx.marks.begin(), idx.marks.end(), frame, Index::Mark::before);
 
-	after = *i;
-
-	if (i == positions.begin ()) {
-		/* none before */
-		return;
+	while (i != idx.marks.begin()) {
+		--i;
+		if (!(i->flags & ignore)) {
+			before = i->pos;
+			break;
+		}
 	}
-
-	--i;
-	before = *i;
 }
 
 Location*
@@ -1423,11 +1374,83 @@ void
 Locations::find_all_between (framepos_t start, framepos_t end, LocationList& ll, Location::Flags flags)
 {
 	Glib::Threads::Mutex::Lock lm (lock);
+	Index const & idx (index ());
+
+	for (Index::Marks::const_iterator i = lower_bound (idx.marks.begin(), idx.marks.end(), start, Index::Mark::before); i != idx.marks.end() && i->pos < end; ++i) {
+		if (i->is_end) {
+			continue;
+		}
+		if ((flags == 0 || (i->flags & flags)) && i->end < end) {
+			ll.push_back (i->location);
+		}
+	}
+}
+
+/** Must be called with the lock held */
+void
+Locations::listen_to (Location* loc)
+{
+	boost::shared_ptr<ScopedConnectionList> connections (new ScopedConnectionList);
+
+	loc->StartChanged.connect_same_thread (*connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->EndChanged.connect_same_thread (*connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->Changed.connect_same_thread (*connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->FlagsChanged.connect_same_thread (*connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->NameChanged.connect_same_thread (*connections, boost::bind (&Locations::location_changed, this, loc));
+
+	_location_connections[loc] = connections;
+}
+
+/** Must be called with the lock held */
+void
+Locations::stop_listening (Location* loc)
+{
+	_location_connections.erase (loc);
+}
+
+void
+Locations::location_changed (Location*)
+{
+	invalidate_index ();
+}
+
+void
+Locations::invalidate_index ()
+{
+	g_atomic_int_set (&_index_dirty, 1);
+}
+
+/** Must be called with the lock held, and the index must only be used
+ *  while it is held: it points to the locations.
+ */
+Locations::Index const &
+Locations::index () const
+{
+	if (g_atomic_int_compare_and_exchange (&_index_dirty, 1, 0)) {
+		rebuild_index ();
+	}
+	return _index;
+}
+
+/** Must be called with the lock held */
+void
+Locations::rebuild_index () const
+{
+	Index& idx (_index);
+
+	idx.marks.clear ();
+	idx.names.clear ();
+	idx.marks.reserve (2 * locations.size ());
+	idx.names.reserve (locations.size ());
 
 	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
-		if ((flags == 0 || (*i)->matches (flags)) &&
-		    ((*i)->start() >= start && (*i)->end() < end)) {
-			ll.push_back (*i);
+		idx.marks.push_back (Index::Mark ((*i)->start(), *i, false));
+		if (!(*i)->is_mark()) {
+			idx.marks.push_back (Index::Mark ((*i)->end(), *i, true));
 		}
+		idx.names.push_back ((*i)->name());
 	}
+
+	sort (idx.marks.begin(), idx.marks.end());
+	sort (idx.names.begin(), idx.names.end());
 }
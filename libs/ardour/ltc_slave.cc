@@ -17,6 +17,8 @@
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 */
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <errno.h>
 #include <sys/types.h>
@@ -159,20 +161,20 @@ LTC_Slave::reset()
 void
 LTC_Slave::parse_ltc(const ARDOUR::pframes_t nframes, const Sample* const in, const ARDOUR::framecnt_t posinfo)
 {
-	pframes_t i;
 	unsigned char sound[8192];
-	if (nframes > 8192) {
-		/* TODO warn once or wrap, loop conversion below
-		 * does jack/A3 support > 8192 spp anyway?
-		 */
-		return;
-	}
 
-	for (i = 0; i < nframes; i++) {
-		const int snd=(int)rint((127.0*in[i])+128.0);
-		sound[i] = (unsigned char) (snd&0xff);
+	/* libltc's own float conversion truncates, round as we always did.
+	 * Blocks larger than the conversion buffer are decoded in chunks.
+	 */
+	for (pframes_t off = 0; off < nframes; ) {
+		const pframes_t n = std::min (nframes - off, (pframes_t) sizeof (sound));
+		for (pframes_t i = 0; i < n; i++) {
+			const int snd=(int)rint((127.0*in[off + i])+128.0);
+			sound[i] = (unsigned char) (snd&0xff);
+		}
+		ltc_decoder_write(decoder, sound, n, posinfo + off);
+		off += n;
 	}
-	ltc_decoder_write(decoder, sound, nframes, posinfo);
 	return;
 }
 
@@ -411,14 +413,13 @@ LTC_Slave::process_ltc(framepos_t const /*now*/)
 void
 LTC_Slave::init_engine_dll (framepos_t pos, int32_t inc)
 {
-	double omega = 2.0 * M_PI * double(inc) / double(session.frame_rate());
-	b = 1.4142135623730950488 * omega;
-	c = omega * omega;
-
-	e2 = double(ltc_speed * inc);
-	t0 = double(pos);
-	t1 = t0 + e2;
-	DEBUG_TRACE (DEBUG::LTC, string_compose ("[re-]init Engine DLL %1 %2 %3\n", t0, t1, e2));
+	const double omega = DelayLockedLoop::omega (1.0, double(inc) / double(session.frame_rate()));
+	engine_dll.set_omega (omega);
+	/* this is the only loop between LTC and the engine,
+	 * lock in with a moderately wider bandwidth */
+	engine_dll.set_acquisition (2.0, ceil (3.0 / omega));
+	engine_dll.init (double(pos), double(ltc_speed * inc));
+	DEBUG_TRACE (DEBUG::LTC, string_compose ("[re-]init Engine DLL %1 %2 %3\n", engine_dll.t0(), engine_dll.t1(), engine_dll.e2()));
 }
 
 /* main entry point from session_process.cc
@@ -531,11 +532,10 @@ LTC_Slave::speed_and_position (double& speed, framepos_t& pos)
 
 	if (!engine_init_called) {
 		const double e = elapsed + double (last_ltc_frame - sess_pos);
-		t0 = t1;
-		t1 += b * e + e2;
-		e2 += c * e;
-		speed_flt = (t1 - t0) / double(session.engine().samples_per_cycle());
-		DEBUG_TRACE (DEBUG::LTC, string_compose ("LTC engine DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5\n", t0, t1, e, speed_flt, e2 - session.engine().samples_per_cycle() ));
+		engine_dll.update (e);
+		speed_flt = engine_dll.ratio (session.engine().samples_per_cycle());
+		DEBUG_TRACE (DEBUG::LTC, string_compose ("LTC engine DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5 jitter:%6\n",
+					engine_dll.t0(), engine_dll.t1(), e, speed_flt, engine_dll.e2() - session.engine().samples_per_cycle(), engine_dll.jitter()));
 	} else {
 		DEBUG_TRACE (DEBUG::LTC, string_compose ("LTC adjusting elapsed (no DLL) from %1 by %2\n", elapsed, (2 * nframes * ltc_speed)));
 		speed_flt = 0;
@@ -21,6 +21,7 @@
 #include "timecode/bbt_time.h"
 #include "pbd/stateful_diff_command.h"
 #include "pbd/openuri.h"
+#include "pbd/rt_monitor.h"
 #include "evoral/Control.hpp"
 #include "evoral/ControlList.hpp"
 #include "evoral/Range.hpp"
@@ -359,6 +360,15 @@ LuaBindings::common (lua_State* L)
 		.addConst ("UseGroup", PBD::Controllable::GroupControlDisposition(PBD::Controllable::UseGroup))
 		.endNamespace ()
 
+		.beginNamespace ("RTMonitor")
+		.addFunction ("available", &PBD::RTMonitor::available)
+		.addFunction ("enabled", &PBD::RTMonitor::enabled)
+		.addFunction ("set_enabled", &PBD::RTMonitor::set_enabled)
+		.addFunction ("set_record_call_sites", &PBD::RTMonitor::set_record_call_sites)
+		.addFunction ("reset", &PBD::RTMonitor::reset)
+		.addFunction ("report", (std::string (*) ())&PBD::RTMonitor::report)
+		.endNamespace ()
+
 		.endNamespace (); // PBD
 
 	luabridge::getGlobalNamespace (L)
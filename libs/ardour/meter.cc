@@ -37,6 +37,7 @@ using namespace ARDOUR;
 
 PeakMeter::PeakMeter (Session& s, const std::string& name)
     : Processor (s, string_compose ("meter-%1", name))
+    , _snapshots (new SnapshotSlots)
 {
 	Kmeterdsp::init(s.nominal_frame_rate());
 	Iec1ppmdsp::init(s.nominal_frame_rate());
@@ -48,6 +49,8 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 	_reset_max = true;
 	_bufcnt = 0;
 	_combined_peak = 0;
+	_snapshot_seq = 0;
+	_level_read = 0;
 }
 
 PeakMeter::~PeakMeter ()
@@ -190,9 +193,89 @@ PeakMeter::run (BufferSet& bufs, framepos_t /*start_frame*/, framepos_t /*end_fr
 		_bufcnt = 0;
 	}
 
+	publish_snapshot ();
+
 	_active = _pending_active;
 }
 
+/** Copy the current meter values into the unpublished snapshot-slot
+ * and publish it. Only the process thread (or any thread while the
+ * meter is inactive) may call this.
+ *
+ * The K, IEC and VU meters report the highest value since they were
+ * last read. They are read here every cycle, and the snapshot holds on
+ * to the highest reading until a reader has taken a snapshot, which
+ * gives the same ballistics as reading the meters from the GUI.
+ */
+void
+PeakMeter::publish_snapshot ()
+{
+	boost::shared_ptr<SnapshotSlots> slots = _snapshots.reader ();
+
+	const guint seq = g_atomic_int_get (&_snapshot_seq) + 1;
+	Snapshot& s (slots->slot[seq & 1]);
+	Snapshot const& prev (slots->slot[(seq - 1) & 1]);
+
+	const uint32_t n_midi = current_meters.n_midi ();
+	const uint32_t n_meters = s.peak.size ();
+	assert (_peak_power.size () == n_meters);
+
+	const bool hold = !g_atomic_int_compare_and_exchange (&_level_read, 1, 0)
+		&& prev.type == _meter_type && prev.level.size () == n_meters;
+
+	s.seq = seq;
+	s.type = _meter_type;
+	s.n_midi = n_midi;
+	s.combined_peak = accurate_coefficient_to_dB (_combined_peak);
+
+	for (uint32_t n = 0; n < n_meters; ++n) {
+		s.peak[n] = _peak_power[n];
+		s.max_peak[n] = accurate_coefficient_to_dB (_max_peak_signal[n]);
+		s.level[n] = _peak_power[n];
+	}
+
+	for (uint32_t n = n_midi, i = 0; n < n_meters && i < _kmeter.size (); ++n, ++i) {
+		float level;
+		if (_meter_type & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
+			level = accurate_coefficient_to_dB (_kmeter[i]->read ());
+		} else if (_meter_type & (MeterIEC1DIN | MeterIEC1NOR)) {
+			level = accurate_coefficient_to_dB (_iec1meter[i]->read ());
+		} else if (_meter_type & (MeterIEC2BBC | MeterIEC2EBU)) {
+			level = accurate_coefficient_to_dB (_iec2meter[i]->read ());
+		} else if (_meter_type & MeterVU) {
+			level = accurate_coefficient_to_dB (_vumeter[i]->read ());
+		} else {
+			continue;
+		}
+		s.level[n] = hold ? max (level, prev.level[n]) : level;
+	}
+
+	g_atomic_int_set (&_snapshot_seq, seq);
+}
+
+bool
+PeakMeter::snapshot (Snapshot& s) const
+{
+	/* the slot being read is only re-used by the process thread after
+	 * the next snapshot has been published. If that happened while
+	 * copying, try again.
+	 */
+	boost::shared_ptr<SnapshotSlots> slots = _snapshots.reader ();
+
+	for (int retry = 0; retry < 4; ++retry) {
+		const guint seq = g_atomic_int_get (&_snapshot_seq);
+		if (seq == 0) {
+			return false;
+		}
+		s = slots->slot[seq & 1];
+		if ((guint) g_atomic_int_get (&_snapshot_seq) == seq) {
+			g_atomic_int_set (&_level_read, 1);
+			return true;
+		}
+	}
+	return false;
+}
+
 void
 PeakMeter::reset ()
 {
@@ -203,6 +286,7 @@ PeakMeter::reset ()
 			_peak_power[i] = -std::numeric_limits<float>::infinity();
 			_peak_buffer[i] = 0;
 		}
+		publish_snapshot ();
 	}
 
 	// these are handled async just fine.
@@ -225,6 +309,7 @@ PeakMeter::reset_max ()
 		_max_peak_signal[i] = 0;
 		_peak_buffer[i] = 0;
 	}
+	publish_snapshot ();
 }
 
 bool
@@ -293,6 +378,17 @@ PeakMeter::set_max_channels (const ChanCount& chn)
 	assert(_peak_power.size() == limit);
 	assert(_max_peak_signal.size() == limit);
 
+	if (_snapshots.reader ()->slot[0].peak.size () != limit) {
+		/* readers may be copying the current slots */
+		RCUWriter<SnapshotSlots> writer (_snapshots);
+		boost::shared_ptr<SnapshotSlots> slots = writer.get_copy ();
+		for (int i = 0; i < 2; ++i) {
+			slots->slot[i].peak.resize (limit, -std::numeric_limits<float>::infinity());
+			slots->slot[i].max_peak.resize (limit, -std::numeric_limits<float>::infinity());
+			slots->slot[i].level.resize (limit, -std::numeric_limits<float>::infinity());
+		}
+	}
+
 	/* alloc/free other audio-only meter types. */
 	while (_kmeter.size() > n_audio) {
 		delete (_kmeter.back());
@@ -323,66 +419,63 @@ PeakMeter::set_max_channels (const ChanCount& chn)
  * Caller MUST hold its own processor_lock to prevent reconfiguration
  * of meter size during this call.
  */
+float
+PeakMeter::meter_level (uint32_t n, MeterType type)
+{
+	/* a single value cannot tear, no need to copy the snapshot */
+	boost::shared_ptr<SnapshotSlots> slots = _snapshots.reader ();
 
-#define CHECKSIZE(MTR) (n < MTR.size() + n_midi && n >= n_midi)
+	if (type & (MeterKrms | MeterK20 | MeterK14 | MeterK12 | MeterIEC1DIN | MeterIEC1NOR | MeterIEC2BBC | MeterIEC2EBU | MeterVU)) {
+		g_atomic_int_set (&_level_read, 1);
+	}
+
+	return slots->slot[g_atomic_int_get (&_snapshot_seq) & 1].value (n, type);
+}
 
 float
-PeakMeter::meter_level(uint32_t n, MeterType type) {
-	float mcptmp;
-	switch (type) {
+PeakMeter::Snapshot::value (uint32_t n, MeterType t) const
+{
+	switch (t) {
 		case MeterKrms:
 		case MeterK20:
 		case MeterK14:
 		case MeterK12:
-			{
-				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_kmeter)) {
-					return accurate_coefficient_to_dB (_kmeter[n - n_midi]->read());
-				}
+			if (n >= n_midi && n < level.size() && (type & (MeterKrms | MeterK20 | MeterK14 | MeterK12))) {
+				return level[n];
 			}
 			break;
 		case MeterIEC1DIN:
 		case MeterIEC1NOR:
-			{
-				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_iec1meter)) {
-					return accurate_coefficient_to_dB (_iec1meter[n - n_midi]->read());
-				}
+			if (n >= n_midi && n < level.size() && (type & (MeterIEC1DIN | MeterIEC1NOR))) {
+				return level[n];
 			}
 			break;
 		case MeterIEC2BBC:
 		case MeterIEC2EBU:
-			{
-				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_iec2meter)) {
-					return accurate_coefficient_to_dB (_iec2meter[n - n_midi]->read());
-				}
+			if (n >= n_midi && n < level.size() && (type & (MeterIEC2BBC | MeterIEC2EBU))) {
+				return level[n];
 			}
 			break;
 		case MeterVU:
-			{
-				const uint32_t n_midi = current_meters.n_midi();
-				if (CHECKSIZE(_vumeter)) {
-					return accurate_coefficient_to_dB (_vumeter[n - n_midi]->read());
-				}
+			if (n >= n_midi && n < level.size() && (type & MeterVU)) {
+				return level[n];
 			}
 			break;
 		case MeterPeak:
 		case MeterPeak0dB:
-			if (n < _peak_power.size()) {
-				return _peak_power[n];
+			if (n < peak.size()) {
+				return peak[n];
 			}
 			break;
 		case MeterMCP:
-			mcptmp = _combined_peak;
-			return accurate_coefficient_to_dB(mcptmp);
+			return combined_peak;
 		case MeterMaxSignal:
 			assert(0);
 			break;
 		default:
 		case MeterMaxPeak:
-			if (n < _max_peak_signal.size()) {
-				return accurate_coefficient_to_dB(_max_peak_signal[n]);
+			if (n < max_peak.size()) {
+				return max_peak[n];
 			}
 			break;
 	}
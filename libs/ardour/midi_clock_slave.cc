@@ -109,9 +109,7 @@ void
 MIDIClock_Slave::calculate_filter_coefficients()
 {
 	// omega = 2 * PI * Bandwidth / MIDI clock frame frequency in Hz
-	omega = 2.0 * M_PI * bandwidth * one_ppqn_in_frames / session->frame_rate();
-	b = 1.4142135623730950488 * omega;
-	c = omega * omega;
+	dll.set_omega (DelayLockedLoop::omega (bandwidth, one_ppqn_in_frames / session->frame_rate()));
 }
 
 void
@@ -140,10 +138,10 @@ MIDIClock_Slave::update_midi_clock (Parser& /*parser*/, framepos_t timestamp)
 		// calculate filter coefficients
 		calculate_filter_coefficients();
 
-		// initialize DLL
-		e2 = double(one_ppqn_in_frames) / double(session->frame_rate());
-		t0 = double(elapsed_since_start) / double(session->frame_rate());
-		t1 = t0 + e2;
+		// initialize DLL, lock in with a wider bandwidth
+		dll.set_acquisition (4.0, ceil (3.0 / DelayLockedLoop::omega (bandwidth, one_ppqn_in_frames / session->frame_rate())));
+		dll.init (double(elapsed_since_start) / double(session->frame_rate()),
+		          double(one_ppqn_in_frames) / double(session->frame_rate()));
 
 		// let ardour go after first MIDI Clock Event
 		_starting = false;
@@ -157,13 +155,10 @@ MIDIClock_Slave::update_midi_clock (Parser& /*parser*/, framepos_t timestamp)
 		// because t1 is used to calculate the transport speed,
 		// so the loop will compensate for accumulating rounding errors
 		error = (double(should_be_position) - (double(session->transport_frame()) + double(cycle_offset)));
-		e = error / double(session->frame_rate());
 		current_delta = error;
 
 		// update DLL
-		t0 = t1;
-		t1 += b * e + e2;
-		e2 += c * e;
+		dll.update (error / double(session->frame_rate()));
 	}
 
 	DEBUG_TRACE (DEBUG::MidiClock, string_compose ("clock #%1 @ %2 should-be %3 transport %4 error %5 appspeed %6 "
@@ -173,12 +168,12 @@ MIDIClock_Slave::update_midi_clock (Parser& /*parser*/, framepos_t timestamp)
 						       should_be_position,                                        // should-be
 						       session->transport_frame(),                                // transport
 						       error,                                                     // error
-						       ((t1 - t0) * session->frame_rate()) / one_ppqn_in_frames, // appspeed
+						       (dll.period() * session->frame_rate()) / one_ppqn_in_frames, // appspeed
 						       timestamp - last_timestamp,                                // read delta
 						       one_ppqn_in_frames,                                        // should-be delta
-						       (t1 - t0) * session->frame_rate(),                         // t1-t0
-						       t0 * session->frame_rate(),                                // t0
-						       t1 * session->frame_rate(),                                // t1
+						       dll.period() * session->frame_rate(),                      // t1-t0
+						       dll.t0() * session->frame_rate(),                          // t0
+						       dll.t1() * session->frame_rate(),                          // t1
 						       session->frame_rate(),                                      // framerate
 						       session->frame_time()
 
@@ -335,7 +330,7 @@ MIDIClock_Slave::speed_and_position (double& speed, framepos_t& pos)
 	}
 
 	// calculate speed
-	speed = ((t1 - t0) * session->frame_rate()) / one_ppqn_in_frames;
+	speed = (dll.period() * session->frame_rate()) / one_ppqn_in_frames;
 
 	// provide a 0.1% deadzone to lock the speed
 	if (fabs(speed - 1.0) <= 0.001)
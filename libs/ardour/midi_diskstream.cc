@@ -1404,6 +1404,23 @@ MidiDiskstream::capture_buffer_load () const
 	return 1;
 }
 
+framecnt_t
+MidiDiskstream::playback_frames_buffered () const
+{
+	/* unlike the load, this does tell the two cases above apart: MIDI is
+	   read ahead by time, whether or not the playlist has events there.
+	*/
+
+	if (file_frame == max_framepos) {
+		return max_framecnt;
+	}
+
+	const uint32_t frames_read = g_atomic_int_get (const_cast<gint*> (&_frames_read_from_ringbuffer));
+	const uint32_t frames_written = g_atomic_int_get (const_cast<gint*> (&_frames_written_to_ringbuffer));
+
+	return frames_written > frames_read ? frames_written - frames_read : 0;
+}
+
 int
 MidiDiskstream::use_pending_capture_data (XMLNode& /*node*/)
 {
@@ -31,6 +31,7 @@
 
 #include "pbd/enumwriter.h"
 #include "pbd/convert.h"
+#include "pbd/rt_monitor.h"
 #include "evoral/midi_util.h"
 
 #include "ardour/beats_frames_converter.h"
@@ -356,6 +357,7 @@ MidiTrack::roll (pframes_t nframes, framepos_t start_frame, framepos_t end_frame
 {
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		boost::shared_ptr<MidiDiskstream> diskstream = midi_diskstream();
 		framecnt_t playback_distance = diskstream->calculate_playback_distance(nframes);
 		if (can_internal_playback_seek(::llabs(playback_distance))) {
@@ -142,6 +142,30 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_mix_buffers_with_fade (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const gain_t * fade, const gain_t * lower, const gain_t * envelope, pframes_t nframes, float gain)
+{
+	/* branch once, outside of the loops */
+
+	if (lower && envelope) {
+		for (pframes_t i = 0; i < nframes; i++) {
+			dst[i] = dst[i] * lower[i] + src[i] * (envelope[i] * gain) * fade[i];
+		}
+	} else if (lower) {
+		for (pframes_t i = 0; i < nframes; i++) {
+			dst[i] = dst[i] * lower[i] + src[i] * gain * fade[i];
+		}
+	} else if (envelope) {
+		for (pframes_t i = 0; i < nframes; i++) {
+			dst[i] += src[i] * (envelope[i] * gain) * fade[i];
+		}
+	} else {
+		for (pframes_t i = 0; i < nframes; i++) {
+			dst[i] += src[i] * gain * fade[i];
+		}
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
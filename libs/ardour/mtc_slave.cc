@@ -17,6 +17,7 @@
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 */
+#include <cmath>
 #include <iostream>
 #include <errno.h>
 #include <sys/types.h>
@@ -251,14 +252,12 @@ MTC_Slave::read_current (SafeTime *st) const
 void
 MTC_Slave::init_mtc_dll(framepos_t tme, double qtr)
 {
-	omega = 2.0 * M_PI * qtr / 2.0 / double(session.frame_rate());
-	b = 1.4142135623730950488 * omega;
-	c = omega * omega;
-
-	e2 = qtr;
-	t0 = double(tme);
-	t1 = t0 + e2;
-	DEBUG_TRACE (DEBUG::MTC, string_compose ("[re-]init MTC DLL %1 %2 %3\n", t0, t1, e2));
+	const double omega = DelayLockedLoop::omega (0.5, qtr / double(session.frame_rate()));
+	mtc_dll.set_omega (omega);
+	/* lock in with a wider bandwidth, see DelayLockedLoop::set_acquisition */
+	mtc_dll.set_acquisition (4.0, ceil (3.0 / omega));
+	mtc_dll.init (double(tme), qtr);
+	DEBUG_TRACE (DEBUG::MTC, string_compose ("[re-]init MTC DLL %1 %2 %3\n", mtc_dll.t0(), mtc_dll.t1(), mtc_dll.e2()));
 }
 
 /* called from MIDI parser */
@@ -276,13 +275,12 @@ MTC_Slave::update_mtc_qtr (Parser& /*p*/, int which_qtr, framepos_t now)
 	double mtc_speed = 0;
 	if (first_mtc_timestamp != 0) {
 		/* update MTC DLL and calculate speed */
-		const double e = mtc_frame_dll - (double)transport_direction * ((double)now - (double)current.timestamp + t0);
-		t0 = t1;
-		t1 += b * e + e2;
-		e2 += c * e;
+		const double e = mtc_frame_dll - (double)transport_direction * ((double)now - (double)current.timestamp + mtc_dll.t0());
+		mtc_dll.update (e);
 
-		mtc_speed = (t1 - t0) / qtr_d;
-		DEBUG_TRACE (DEBUG::MTC, string_compose ("qtr frame DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5\n", t0, t1, e, mtc_speed, e2 - qtr_d));
+		mtc_speed = mtc_dll.ratio (qtr_d);
+		DEBUG_TRACE (DEBUG::MTC, string_compose ("qtr frame DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5 jitter:%6\n",
+					mtc_dll.t0(), mtc_dll.t1(), e, mtc_speed, mtc_dll.e2() - qtr_d, mtc_dll.jitter()));
 
 		current.guard1++;
 		current.position = mtc_frame;
@@ -570,14 +568,9 @@ MTC_Slave::init_engine_dll (framepos_t pos, framepos_t inc)
 	 * But this is only really a problem if the user performs manual
 	 * seeks while transport is running and slaved to MTC.
 	 */
-	oe = 2.0 * M_PI * double(inc) / 2.0 / double(session.frame_rate());
-	be = 1.4142135623730950488 * oe;
-	ce = oe * oe;
-
-	ee2 = double(transport_direction * inc);
-	te0 = double(pos);
-	te1 = te0 + ee2;
-	DEBUG_TRACE (DEBUG::MTC, string_compose ("[re-]init Engine DLL %1 %2 %3\n", te0, te1, ee2));
+	engine_dll.set_omega (DelayLockedLoop::omega (0.5, double(inc) / double(session.frame_rate())));
+	engine_dll.init (double(pos), double(transport_direction * inc));
+	DEBUG_TRACE (DEBUG::MTC, string_compose ("[re-]init Engine DLL %1 %2 %3\n", engine_dll.t0(), engine_dll.t1(), engine_dll.e2()));
 }
 
 /* main entry point from session_process.cc
@@ -655,11 +648,10 @@ MTC_Slave::speed_and_position (double& speed, framepos_t& pos)
 
 			/* update engine DLL and calculate speed */
 			const double e = double (last.position + elapsed - sess_pos);
-			te0 = te1;
-			te1 += be * e + ee2;
-			ee2 += ce * e;
-			speed_flt = (te1 - te0) / double(session.engine().samples_per_cycle());
-			DEBUG_TRACE (DEBUG::MTC, string_compose ("engine DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5\n", te0, te1, e, speed_flt, ee2 - session.engine().samples_per_cycle() ));
+			engine_dll.update (e);
+			speed_flt = engine_dll.ratio (session.engine().samples_per_cycle());
+			DEBUG_TRACE (DEBUG::MTC, string_compose ("engine DLL t0:%1 t1:%2 err:%3 spd:%4 ddt:%5\n",
+						engine_dll.t0(), engine_dll.t1(), e, speed_flt, engine_dll.e2() - session.engine().samples_per_cycle() ));
 		}
 	}
 
@@ -751,6 +751,7 @@ Playlist::flush_notifications (bool from_undo)
 	 region->set_position (position, sub_num);
 
 	 regions.insert (upper_bound (regions.begin(), regions.end(), region, cmp), region);
+	 rendered_range_changed (region->range ());
 	 all_regions.insert (region);
 
 	 possibly_splice_unlocked (position, region->length(), region);
@@ -811,6 +812,7 @@ Playlist::flush_notifications (bool from_undo)
 			 framepos_t pos = (*i)->position();
 			 framecnt_t distance = (*i)->length();
 
+			 rendered_range_changed ((*i)->range ());
 			 regions.erase (i);
 
 			 possibly_splice_unlocked (pos, -distance);
@@ -1724,6 +1726,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 	 RegionWriteLock rl (this);
 	 regions.clear ();
 	 all_regions.clear ();
+	 rendered_range_changed (Evoral::Range<framepos_t> (0, max_framepos));
  }
 
  void
@@ -1751,6 +1754,7 @@ Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shar
 		 }
 
 		 regions.clear ();
+		 rendered_range_changed (Evoral::Range<framepos_t> (0, max_framepos));
 
 		 for (set<boost::shared_ptr<Region> >::iterator s = pending_removes.begin(); s != pending_removes.end(); ++s) {
 			 remove_dependents (*s);
@@ -1933,6 +1937,40 @@ Playlist::regions_touched_locked (framepos_t start, framepos_t end)
 	return rlist;
 }
 
+/** @return the number of frames between @a start and @a end (exclusive)
+ *  that are covered by at least one region.
+ */
+framecnt_t
+Playlist::covered_length (framepos_t start, framepos_t end)
+{
+	vector<pair<framepos_t, framepos_t> > ranges;
+
+	{
+		RegionReadLock rlock (this);
+		for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
+			const framepos_t s = max (start, (*i)->position ());
+			const framepos_t e = min (end, (*i)->position () + (*i)->length ());
+			if (s < e) {
+				ranges.push_back (make_pair (s, e));
+			}
+		}
+	}
+
+	sort (ranges.begin (), ranges.end ());
+
+	framecnt_t covered = 0;
+	framepos_t covered_to = start;
+
+	for (vector<pair<framepos_t, framepos_t> >::const_iterator r = ranges.begin(); r != ranges.end(); ++r) {
+		if (r->second > covered_to) {
+			covered += r->second - max (r->first, covered_to);
+			covered_to = r->second;
+		}
+	}
+
+	return covered;
+}
+
 framepos_t
 Playlist::find_next_transient (framepos_t from, int dir)
 {
@@ -2577,6 +2615,10 @@ Playlist::relayer ()
 			layers[j][k].push_back (*i);
 		}
 
+		if ((*i)->layer () != (layer_t) j) {
+			rendered_range_changed ((*i)->range ());
+		}
+
 		(*i)->set_layer (j);
 	}
 
@@ -0,0 +1,603 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/debug.h"
+#include "ardour/filesystem_paths.h"
+#include "ardour/playlist_render_cache.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+const framecnt_t PlaylistRenderCache::block_frames = 16384;
+
+/* more pending invalidations than this are coalesced, or turned into a clear() */
+static const size_t max_pending = 64;
+
+/* more data than this waiting to be written is not kept (4MB) */
+static const framecnt_t max_queued_frames = 1048576;
+
+gint PlaylistRenderCache::_total_slots = 0;
+gint PlaylistRenderCache::_max_total_slots = 0;
+Glib::Threads::Mutex PlaylistRenderCache::_queue_lock;
+Glib::Threads::Cond PlaylistRenderCache::_queue_cond;
+list<PlaylistRenderCache::WriteJob*> PlaylistRenderCache::_queue;
+framecnt_t PlaylistRenderCache::_queued_frames = 0;
+PlaylistRenderCache* PlaylistRenderCache::_storing = 0;
+Glib::Threads::Thread* PlaylistRenderCache::_writer = 0;
+bool PlaylistRenderCache::_writer_quit = false;
+
+PlaylistRenderCache::PlaylistRenderCache ()
+	: _n_slots (0)
+	, _failed (false)
+	, _fd (-1)
+	, _slot_epoch (0)
+	, _pending_clear (false)
+	, _generation (0)
+{
+}
+
+PlaylistRenderCache::~PlaylistRenderCache ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+		for (list<WriteJob*>::iterator i = _queue.begin (); i != _queue.end (); ) {
+			if ((*i)->cache == this) {
+				_queued_frames -= (*i)->data.size ();
+				delete *i;
+				i = _queue.erase (i);
+			} else {
+				++i;
+			}
+		}
+
+		while (_storing == this) {
+			_queue_cond.wait (_queue_lock);
+		}
+	}
+
+	release_slots ();
+
+	if (_fd >= 0) {
+		::close (_fd);
+#ifdef PLATFORM_WINDOWS
+		::g_unlink (_path.c_str ());
+#endif
+	}
+}
+
+void
+PlaylistRenderCache::set_max_frames (framecnt_t frames)
+{
+	g_atomic_int_set (&_max_total_slots, (gint) min ((framecnt_t) G_MAXINT, max ((framecnt_t) 0, frames / block_frames)));
+}
+
+/** take a slot from the budget of all caches */
+bool
+PlaylistRenderCache::reserve_slot ()
+{
+	while (true) {
+		const gint n = g_atomic_int_get (&_total_slots);
+		if (n >= g_atomic_int_get (&_max_total_slots)) {
+			return false;
+		}
+		if (g_atomic_int_compare_and_exchange (&_total_slots, n, n + 1)) {
+			return true;
+		}
+	}
+}
+
+/** return all slots of the cache file to the budget. Called with _lock held, or from the destructor. */
+void
+PlaylistRenderCache::release_slots ()
+{
+	g_atomic_int_add (&_total_slots, - (gint) _n_slots);
+	_n_slots = 0;
+	_free_slots.clear ();
+	++_slot_epoch;
+
+	if (_fd >= 0 && ftruncate (_fd, 0)) {
+		/* the space is reused anyway */
+	}
+}
+
+uint32_t
+PlaylistRenderCache::generation () const
+{
+	return (uint32_t) g_atomic_int_get (&_generation);
+}
+
+void
+PlaylistRenderCache::invalidate (Evoral::Range<framepos_t> const& range)
+{
+	Glib::Threads::Mutex::Lock lm (_pending_lock);
+
+	g_atomic_int_inc (&_generation);
+
+	if (_pending_clear) {
+		return;
+	}
+
+	_pending.add (range);
+
+	if (_pending.get ().size () > max_pending) {
+		_pending = Evoral::RangeList<framepos_t> ();
+		_pending_clear = true;
+	}
+}
+
+void
+PlaylistRenderCache::clear ()
+{
+	Glib::Threads::Mutex::Lock lm (_pending_lock);
+
+	g_atomic_int_inc (&_generation);
+
+	_pending = Evoral::RangeList<framepos_t> ();
+	_pending_clear = true;
+}
+
+PlaylistRenderCache::Stats
+PlaylistRenderCache::stats () const
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Stats s (_stats);
+	s.blocks = _blocks.size ();
+	return s;
+}
+
+/** drop the blocks that were invalidated since the last call. Called with _lock held. */
+void
+PlaylistRenderCache::apply_pending ()
+{
+	Evoral::RangeList<framepos_t> pending;
+	bool pending_clear;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_pending_lock);
+		pending = _pending;
+		pending_clear = _pending_clear;
+		_pending = Evoral::RangeList<framepos_t> ();
+		_pending_clear = false;
+	}
+
+	if (pending_clear) {
+		_stats.invalidated += _blocks.size ();
+		_blocks.clear ();
+		release_slots ();
+		return;
+	}
+
+	if (pending.empty ()) {
+		return;
+	}
+
+	Evoral::RangeList<framepos_t>::List const& l = pending.get ();
+
+	for (Evoral::RangeList<framepos_t>::List::const_iterator r = l.begin (); r != l.end (); ++r) {
+
+		const framepos_t first = max ((framepos_t) 0, r->from) / block_frames;
+		const framepos_t last = max ((framepos_t) 0, r->to) / block_frames;
+
+		Blocks::iterator i = _blocks.lower_bound (BlockKey (first, 0));
+
+		while (i != _blocks.end () && i->first.first <= last) {
+			Blocks::iterator tmp = i;
+			++tmp;
+			drop (i);
+			++_stats.invalidated;
+			i = tmp;
+		}
+	}
+}
+
+void
+PlaylistRenderCache::drop (Blocks::iterator i)
+{
+	_free_slots.push_back (i->second.slot);
+	_blocks.erase (i);
+}
+
+bool
+PlaylistRenderCache::read (Sample* dst, framepos_t start, framecnt_t cnt, uint32_t chan)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	apply_pending ();
+
+	if (_blocks.empty () || start < 0) {
+		++_stats.misses;
+		return false;
+	}
+
+	const framepos_t end = start + cnt;
+
+	/* only use the cache if all of the requested range is there */
+
+	for (framepos_t pos = start; pos < end; ) {
+		const framepos_t b = pos / block_frames;
+		const framecnt_t offset = pos - b * block_frames;
+		const framecnt_t n = min (end - pos, block_frames - offset);
+
+		Blocks::const_iterator i = _blocks.find (BlockKey (b, chan));
+
+		if (i == _blocks.end () || offset < i->second.from || offset + n > i->second.to) {
+			++_stats.misses;
+			return false;
+		}
+
+		pos += n;
+	}
+
+	for (framepos_t pos = start; pos < end; ) {
+		const framepos_t b = pos / block_frames;
+		const framecnt_t offset = pos - b * block_frames;
+		const framecnt_t n = min (end - pos, block_frames - offset);
+
+		Blocks::iterator i = _blocks.find (BlockKey (b, chan));
+
+		if (!io (i->second, dst + (pos - start), offset, n, false)) {
+			drop (i);
+			++_stats.misses;
+			return false;
+		}
+
+		pos += n;
+	}
+
+	++_stats.hits;
+	return true;
+}
+
+void
+PlaylistRenderCache::write (Sample const* src, framepos_t start, framecnt_t cnt, uint32_t chan, uint32_t generation)
+{
+	if (generation != this->generation () || start < 0 || cnt <= 0 || g_atomic_int_get (&_max_total_slots) == 0) {
+		/* something changed while the data was rendered, or no space */
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+	if (_queued_frames + cnt > max_queued_frames) {
+		/* the disk does not keep up; this is only a cache */
+		return;
+	}
+
+	if (_writer_quit) {
+		/* being stopped */
+		return;
+	}
+
+	if (!_writer) {
+		try {
+			_writer = Glib::Threads::Thread::create (sigc::ptr_fun (&PlaylistRenderCache::writer_thread));
+		} catch (Glib::Threads::ThreadError const&) {
+			return;
+		}
+	}
+
+	WriteJob* job = new WriteJob;
+	job->cache = this;
+	job->start = start;
+	job->chan = chan;
+	job->generation = generation;
+	job->data.assign (src, src + cnt);
+
+	_queue.push_back (job);
+	_queued_frames += cnt;
+	_queue_cond.broadcast ();
+}
+
+/** Called with _queue_lock held */
+bool
+PlaylistRenderCache::queued () const
+{
+	for (list<WriteJob*>::const_iterator i = _queue.begin (); i != _queue.end (); ++i) {
+		if ((*i)->cache == this) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+PlaylistRenderCache::flush ()
+{
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+	while (_storing == this || queued ()) {
+		_queue_cond.wait (_queue_lock);
+	}
+}
+
+void
+PlaylistRenderCache::stop_writer_thread ()
+{
+	Glib::Threads::Thread* t;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_queue_lock);
+		if (!_writer || _writer_quit) {
+			return;
+		}
+		t = _writer;
+		_writer_quit = true;
+		_queue_cond.broadcast ();
+	}
+
+	/* what is still queued is written first */
+	t->join ();
+
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+	_writer = 0;
+	_writer_quit = false;
+}
+
+void
+PlaylistRenderCache::writer_thread ()
+{
+	pthread_set_name (X_("RenderCache"));
+
+	Glib::Threads::Mutex::Lock lm (_queue_lock);
+
+	while (true) {
+
+		while (_queue.empty () && !_writer_quit) {
+			_queue_cond.wait (_queue_lock);
+		}
+
+		if (_queue.empty ()) {
+			break;
+		}
+
+		WriteJob* job = _queue.front ();
+		_queue.pop_front ();
+		_queued_frames -= job->data.size ();
+
+		/* the cache is not destroyed while it is being stored to */
+		_storing = job->cache;
+		lm.release ();
+
+		job->cache->store (*job);
+		delete job;
+
+		lm.acquire ();
+		_storing = 0;
+		_queue_cond.broadcast ();
+	}
+}
+
+/** write the data of a job to the cache file. Called by writer_thread().
+ *
+ * _lock is not held during the disk i/o, so that read() does not wait for
+ * it: the slots are taken first, then written, and the blocks only
+ * published (or extended) once their data is on disk. There is only one
+ * writer thread, so no one else hands out slots in the meantime.
+ */
+void
+PlaylistRenderCache::store (WriteJob& job)
+{
+	struct Part {
+		BlockKey   key;
+		uint32_t   slot;
+		framecnt_t offset;
+		framecnt_t cnt;
+		Sample*    data;
+		bool       fresh; ///< a new block, in a slot of its own
+		bool       ok;
+	};
+
+	std::vector<Part> parts;
+	uint32_t epoch;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		apply_pending ();
+
+		if (job.generation != generation () || _failed) {
+			/* something changed since the data was rendered */
+			return;
+		}
+
+		if (!open_file ()) {
+			return;
+		}
+
+		const framepos_t start = job.start;
+		const framepos_t end = start + job.data.size ();
+
+		for (framepos_t pos = start; pos < end; ) {
+			Part part;
+			const framepos_t b = pos / block_frames;
+
+			part.key = BlockKey (b, job.chan);
+			part.offset = pos - b * block_frames;
+			part.cnt = min (end - pos, block_frames - part.offset);
+			part.data = &job.data[pos - start];
+			part.ok = false;
+
+			pos += part.cnt;
+
+			Blocks::const_iterator i = _blocks.find (part.key);
+
+			if (i != _blocks.end ()) {
+				/* writing to the existing slot only touches what
+				 * read() may use if it is the same data.
+				 */
+				part.slot = i->second.slot;
+				part.fresh = false;
+			} else if (!_free_slots.empty ()) {
+				part.slot = _free_slots.back ();
+				_free_slots.pop_back ();
+				part.fresh = true;
+			} else if (reserve_slot ()) {
+				part.slot = _n_slots++;
+				part.fresh = true;
+			} else {
+				/* full */
+				continue;
+			}
+
+			parts.push_back (part);
+		}
+
+		epoch = _slot_epoch;
+	}
+
+	for (std::vector<Part>::iterator p = parts.begin (); p != parts.end (); ++p) {
+		Block block;
+		block.slot = p->slot;
+		p->ok = io (block, p->data, p->offset, p->cnt, true);
+	}
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	apply_pending ();
+
+	const bool valid = (job.generation == generation ());
+
+	for (std::vector<Part>::const_iterator p = parts.begin (); p != parts.end (); ++p) {
+
+		if (p->fresh) {
+			if (valid && p->ok) {
+				Block block;
+				block.slot = p->slot;
+				block.from = p->offset;
+				block.to = p->offset + p->cnt;
+				_blocks.insert (make_pair (p->key, block));
+			} else if (epoch == _slot_epoch) {
+				/* unless all slots were released meanwhile */
+				_free_slots.push_back (p->slot);
+			}
+			continue;
+		}
+
+		Blocks::iterator i = _blocks.find (p->key);
+
+		if (i == _blocks.end () || i->second.slot != p->slot) {
+			/* dropped meanwhile */
+			continue;
+		}
+
+		if (!p->ok) {
+			drop (i);
+			continue;
+		}
+
+		if (!valid) {
+			continue;
+		}
+
+		Block& block (i->second);
+
+		if (p->offset > block.to || p->offset + p->cnt < block.from) {
+			/* not contiguous with what is there: replace it */
+			block.from = p->offset;
+			block.to = p->offset + p->cnt;
+		} else {
+			block.from = min (block.from, p->offset);
+			block.to = max (block.to, p->offset + p->cnt);
+		}
+	}
+}
+
+/** Called with _lock held */
+bool
+PlaylistRenderCache::open_file ()
+{
+	if (_fd >= 0) {
+		return true;
+	}
+
+	const string dir = Glib::build_filename (user_cache_directory (), X_("render"));
+
+	if (g_mkdir_with_parents (dir.c_str (), 0755)) {
+		error << string_compose (_("Cannot create playlist render cache folder %1 (%2)"), dir, strerror (errno)) << endmsg;
+		_failed = true;
+		return false;
+	}
+
+	string path = Glib::build_filename (dir, X_("playlist-XXXXXX"));
+	std::vector<char> tmpl (path.begin (), path.end ());
+	tmpl.push_back ('\0');
+
+	if ((_fd = g_mkstemp (&tmpl[0])) < 0) {
+		error << string_compose (_("Cannot create playlist render cache file in %1 (%2)"), dir, strerror (errno)) << endmsg;
+		_failed = true;
+		return false;
+	}
+
+	_path = &tmpl[0];
+
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("playlist render cache in %1\n", _path));
+
+#ifndef PLATFORM_WINDOWS
+	/* nothing else uses the file, and it must not outlive us (or a crash) */
+	::g_unlink (_path.c_str ());
+#endif
+
+	return true;
+}
+
+/** Called with _lock held, or by store() for slots that it owns */
+bool
+PlaylistRenderCache::io (Block const& block, Sample* data, framecnt_t offset, framecnt_t cnt, bool write)
+{
+	const off_t pos = ((off_t) block.slot * block_frames + offset) * sizeof (Sample);
+	const ssize_t bytes = cnt * sizeof (Sample);
+
+#ifdef PLATFORM_WINDOWS
+	/* no pread()/pwrite(): the file position is shared */
+	Glib::Threads::Mutex::Lock lm (_io_lock);
+
+	if (lseek (_fd, pos, SEEK_SET) != pos) {
+		return false;
+	}
+
+	if (write) {
+		return ::write (_fd, data, bytes) == bytes;
+	}
+
+	return ::read (_fd, data, bytes) == bytes;
+#else
+	if (write) {
+		return ::pwrite (_fd, data, bytes, pos) == bytes;
+	}
+
+	return ::pread (_fd, data, bytes, pos) == bytes;
+#endif
+}
@@ -486,6 +486,18 @@ PluginInsert::create_automatable_parameters ()
 			ac->Changed.connect_same_thread (*this, boost::bind (&PluginInsert::enable_changed, this));
 		}
 	}
+
+	vector<boost::shared_ptr<AutomationControl> > acs;
+
+	for (Controls::iterator li = controls().begin(); li != controls().end(); ++li) {
+		boost::shared_ptr<AutomationControl> c = boost::dynamic_pointer_cast<AutomationControl> (li->second);
+		if (c) {
+			acs.push_back (c);
+		}
+	}
+
+	Glib::Threads::Mutex::Lock lm (control_lock ());
+	_automation_schedule.set_controls (acs);
 }
 /** Called when something outside of this host has modified a plugin
  * parameter. Responsible for propagating the change to two places:
@@ -518,6 +530,11 @@ PluginInsert::parameter_changed_externally (uint32_t which, float val)
 		pc->catch_up_with_external_value (val);
 	}
 
+	/* the plugin may have changed an automated parameter: have the
+	 * automation set it again.
+	 */
+	_automation_schedule.invalidate ();
+
 	/* Second propagation: tell all plugins except the first to
 	   update the value of this parameter. For sane plugin APIs,
 	   there are no other plugins, so this is a no-op in those
@@ -736,34 +753,16 @@ PluginInsert::connect_and_run (BufferSet& bufs, framepos_t start, framepos_t end
 	bufs.set_count(ChanCount::max(bufs.count(), _configured_out));
 
 	if (with_auto) {
-
-		uint32_t n = 0;
-
-		for (Controls::iterator li = controls().begin(); li != controls().end(); ++li, ++n) {
-
-			boost::shared_ptr<AutomationControl> c
-				= boost::dynamic_pointer_cast<AutomationControl>(li->second);
-
-			if (c->list() && c->automation_playback()) {
-				bool valid;
-
-				const float val = c->list()->rt_safe_eval (start, valid);
-
-				if (valid) {
-					/* This is the ONLY place where we are
-					 *  allowed to call
-					 *  AutomationControl::set_value_unchecked(). We
-					 *  know that the control is in
-					 *  automation playback mode, so no
-					 *  check on writable() is required
-					 *  (which must be done in AutomationControl::set_value()
-					 *
-					 */
-					c->set_value_unchecked(val);
-				}
-
-			}
-		}
+		/* This is the ONLY place where we are allowed to call
+		 * AutomationControl::set_value_unchecked() (by way of the
+		 * schedule). It only sets controls that are in automation
+		 * playback mode, so no check on writable() is required
+		 * (which must be done in AutomationControl::set_value()).
+		 *
+		 * Lists are only evaluated when their value may have
+		 * changed since the last time.
+		 */
+		_automation_schedule.run (start);
 	}
 
 	/* Calculate if, and how many frames we need to collect for analysis */
@@ -1110,7 +1109,7 @@ PluginInsert::run (BufferSet& bufs, framepos_t start_frame, framepos_t end_frame
 void
 PluginInsert::automation_run (BufferSet& bufs, framepos_t start, framepos_t end, double speed, pframes_t nframes)
 {
-	Evoral::ControlEvent next_event (0, 0.0f);
+	double next_event;
 	framecnt_t offset = 0;
 
 	Glib::Threads::Mutex::Lock lm (control_lock(), Glib::Threads::TRY_LOCK);
@@ -1120,7 +1119,7 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, framepos_t end,
 		return;
 	}
 
-	if (!find_next_event (start, end, next_event) || _plugins.front()->requires_fixed_sized_buffers()) {
+	if (!_automation_schedule.next_event (start, end, next_event) || _plugins.front()->requires_fixed_sized_buffers()) {
 
 		/* no events have a time within the relevant range */
 
@@ -1130,7 +1129,7 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, framepos_t end,
 
 	while (nframes) {
 
-		framecnt_t cnt = min (((framecnt_t) ceil (next_event.when) - start), (framecnt_t) nframes);
+		framecnt_t cnt = min (((framecnt_t) ceil (next_event) - start), (framecnt_t) nframes);
 
 		connect_and_run (bufs, start, start + cnt, speed, cnt, offset, true); // XXX (start + cnt) * speed
 
@@ -1138,7 +1137,7 @@ PluginInsert::automation_run (BufferSet& bufs, framepos_t start, framepos_t end,
 		offset += cnt;
 		start += cnt;
 
-		if (!find_next_event (start, end, next_event)) {
+		if (!_automation_schedule.next_event (start, end, next_event)) {
 			break;
 		}
 	}
@@ -2946,6 +2945,7 @@ PluginInsert::load_preset (ARDOUR::Plugin::PresetRecord pr)
 			ok = false;
 		}
 	}
+	_automation_schedule.invalidate ();
 	return ok;
 }
 
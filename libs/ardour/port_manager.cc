@@ -40,6 +40,7 @@ using std::vector;
 PortManager::PortManager ()
 	: ports (new Ports)
 	, _port_remove_in_progress (false)
+	, _registration_batch_depth (0)
 {
 }
 
@@ -61,6 +62,11 @@ PortManager::remove_all_ports ()
 		ps->clear ();
 	}
 
+	{
+		Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+		_pending_ports.clear ();
+	}
+
 	/* clear dead wood list in RCU */
 
 	ports.flush ();
@@ -228,12 +234,23 @@ PortManager::get_port_by_name (const string& portname)
 		return x->second;
 	}
 
-        return boost::shared_ptr<Port> ();
+        return find_pending_port (rel);
 }
 
 void
 PortManager::port_renamed (const std::string& old_relative_name, const std::string& new_relative_name)
 {
+	{
+		Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+		Ports::iterator x = _pending_ports.find (old_relative_name);
+		if (x != _pending_ports.end()) {
+			boost::shared_ptr<Port> port = x->second;
+			_pending_ports.erase (x);
+			_pending_ports.insert (make_pair (new_relative_name, port));
+			return;
+		}
+	}
+
 	RCUWriter<Ports> writer (ports);
 	boost::shared_ptr<Ports> p = writer.get_copy();
 	Ports::iterator x = p->find (old_relative_name);
@@ -248,7 +265,7 @@ PortManager::port_renamed (const std::string& old_relative_name, const std::stri
 int
 PortManager::get_ports (DataType type, PortList& pl)
 {
-	boost::shared_ptr<Ports> plist = ports.reader();
+	boost::shared_ptr<Ports> plist = all_ports ();
 	for (Ports::iterator p = plist->begin(); p != plist->end(); ++p) {
 		if (p->second->type() == type) {
 			pl.push_back (p->second);
@@ -317,12 +334,18 @@ PortManager::register_port (DataType dtype, const string& portname, bool input,
 			throw PortRegistrationFailure("unable to create port (unknown type)");
 		}
 
-		RCUWriter<Ports> writer (ports);
-		boost::shared_ptr<Ports> ps = writer.get_copy ();
-		ps->insert (make_pair (make_port_name_relative (portname), newport));
+		Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
 
-		/* writer goes out of scope, forces update */
+		if (_registration_batch_depth > 0) {
+			_pending_ports.insert (make_pair (make_port_name_relative (portname), newport));
+		} else {
+			lm.release ();
+			RCUWriter<Ports> writer (ports);
+			boost::shared_ptr<Ports> ps = writer.get_copy ();
+			ps->insert (make_pair (make_port_name_relative (portname), newport));
 
+			/* writer goes out of scope, forces update */
+		}
 	}
 
 	catch (PortRegistrationFailure& err) {
@@ -350,6 +373,63 @@ PortManager::register_output_port (DataType type, const string& portname, bool a
 	return register_port (type, portname, false, async);
 }
 
+void
+PortManager::begin_registration_batch ()
+{
+	Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+	++_registration_batch_depth;
+}
+
+void
+PortManager::end_registration_batch ()
+{
+	Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+
+	assert (_registration_batch_depth > 0);
+
+	if (--_registration_batch_depth > 0 || _pending_ports.empty ()) {
+		return;
+	}
+
+	DEBUG_TRACE (DEBUG::Ports, string_compose ("adding %1 batch-registered ports\n", _pending_ports.size ()));
+
+	{
+		RCUWriter<Ports> writer (ports);
+		boost::shared_ptr<Ports> ps = writer.get_copy ();
+		ps->insert (_pending_ports.begin (), _pending_ports.end ());
+	}
+
+	_pending_ports.clear ();
+}
+
+/** @return our ports, including those of an unfinished registration batch.
+ * Not realtime-safe.
+ */
+boost::shared_ptr<PortManager::Ports>
+PortManager::all_ports ()
+{
+	Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+
+	if (_pending_ports.empty ()) {
+		return ports.reader ();
+	}
+
+	boost::shared_ptr<Ports> all (new Ports (*ports.reader ()));
+	all->insert (_pending_ports.begin (), _pending_ports.end ());
+	return all;
+}
+
+boost::shared_ptr<Port>
+PortManager::find_pending_port (const std::string& relative_name)
+{
+	Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+	Ports::iterator x = _pending_ports.find (relative_name);
+	if (x != _pending_ports.end()) {
+		return x->second;
+	}
+	return boost::shared_ptr<Port> ();
+}
+
 int
 PortManager::unregister_port (boost::shared_ptr<Port> port)
 {
@@ -361,6 +441,15 @@ PortManager::unregister_port (boost::shared_ptr<Port> port)
 
 	/* caller must hold process lock */
 
+	{
+		Glib::Threads::Mutex::Lock lm (_pending_ports_lock);
+		Ports::iterator x = _pending_ports.find (make_port_name_relative (port->name()));
+		if (x != _pending_ports.end()) {
+			_pending_ports.erase (x);
+			return 0;
+		}
+	}
+
 	{
 		RCUWriter<Ports> writer (ports);
 		boost::shared_ptr<Ports> ps = writer.get_copy ();
@@ -502,7 +591,7 @@ PortManager::reestablish_ports ()
 {
 	Ports::iterator i;
 
-	boost::shared_ptr<Ports> p = ports.reader ();
+	boost::shared_ptr<Ports> p = all_ports ();
 
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("reestablish %1 ports\n", p->size()));
 
@@ -526,7 +615,7 @@ PortManager::reestablish_ports ()
 int
 PortManager::reconnect_ports ()
 {
-	boost::shared_ptr<Ports> p = ports.reader ();
+	boost::shared_ptr<Ports> p = all_ports ();
 
 	if (!Profile->get_trx()) {
 		/* re-establish connections */
@@ -552,11 +641,15 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 	x = pr->find (make_port_name_relative (a));
 	if (x != pr->end()) {
 		port_a = x->second;
+	} else {
+		port_a = find_pending_port (make_port_name_relative (a));
 	}
 
 	x = pr->find (make_port_name_relative (b));
 	if (x != pr->end()) {
 		port_b = x->second;
+	} else {
+		port_b = find_pending_port (make_port_name_relative (b));
 	}
 
 	PortConnectedOrDisconnected (
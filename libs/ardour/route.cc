@@ -34,6 +34,7 @@
 #include "pbd/stacktrace.h"
 #include "pbd/convert.h"
 #include "pbd/unwind.h"
+#include "pbd/rt_monitor.h"
 
 #include "ardour/amp.h"
 #include "ardour/audio_buffer.h"
@@ -64,6 +65,7 @@
 #include "ardour/port_insert.h"
 #include "ardour/processor.h"
 #include "ardour/profile.h"
+#include "ardour/return.h"
 #include "ardour/route.h"
 #include "ardour/route_group.h"
 #include "ardour/send.h"
@@ -2876,7 +2878,13 @@ Route::silence_unlocked (framecnt_t nframes)
 
 	if (!_silent) {
 
-		_output->silence (nframes);
+		/* the ports of pipelined main outs were written before any
+		 * route ran, and may already be read by routes that we feed
+		 * (see Delivery::deliver_pipelined)
+		 */
+		if (!_main_outs || !_main_outs->pipelined ()) {
+			_output->silence (nframes);
+		}
 
 		for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
 			boost::shared_ptr<PluginInsert> pi;
@@ -3404,6 +3412,7 @@ Route::no_roll (pframes_t nframes, framepos_t start_frame, framepos_t end_frame,
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		return 0;
 	}
 
@@ -3453,6 +3462,7 @@ Route::roll (pframes_t nframes, framepos_t start_frame, framepos_t end_frame, in
 {
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		return 0;
 	}
 
@@ -3510,6 +3520,27 @@ Route::flush_processors ()
 	}
 }
 
+/** Called from a non-RT thread (the butler) */
+void
+Route::flush_meter_snapshots ()
+{
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+
+	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		boost::shared_ptr<PeakMeter> meter;
+		boost::shared_ptr<Send> send;
+		boost::shared_ptr<Return> ret;
+
+		if ((meter = boost::dynamic_pointer_cast<PeakMeter> (*i)) != 0) {
+			meter->flush_snapshots ();
+		} else if ((send = boost::dynamic_pointer_cast<Send> (*i)) != 0) {
+			send->meter()->flush_snapshots ();
+		} else if ((ret = boost::dynamic_pointer_cast<Return> (*i)) != 0) {
+			ret->meter()->flush_snapshots ();
+		}
+	}
+}
+
 #ifdef __clang__
 __attribute__((annotate("realtime")))
 #endif
@@ -67,6 +67,7 @@
 #include "ardour/control_protocol_manager.h"
 #include "ardour/data_type.h"
 #include "ardour/debug.h"
+#include "ardour/delivery.h"
 #include "ardour/directory_names.h"
 #ifdef USE_TRACKS_CODE_FEATURES
 #include "ardour/engine_state_controller.h"
@@ -82,6 +83,7 @@
 #include "ardour/midi_ui.h"
 #include "ardour/operations.h"
 #include "ardour/playlist.h"
+#include "ardour/playlist_render_cache.h"
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/process_thread.h"
@@ -152,6 +154,7 @@ PBD::Signal2<void,std::string,std::string> Session::VersionMismatch;
 const framecnt_t Session::bounce_chunk_size = 8192;
 static void clean_up_session_event (SessionEvent* ev) { delete ev; }
 const SessionEvent::RTeventCallback Session::rt_cleanup (clean_up_session_event);
+const SessionEvent::RTeventCallback Session::rt_controls_cleanup (Session::rt_controls_done);
 
 // seconds should be added after the region exceeds end marker
 #ifdef USE_TRACKS_CODE_FEATURES
@@ -250,7 +253,9 @@ Session::Session (AudioEngine &eng,
 	, _locations (new Locations (*this))
 	, _ignore_skips_updates (false)
 	, _rt_thread_active (false)
-	, _rt_emit_pending (false)
+	, _rt_emit_pending (0)
+	, _pipeline_update_pending (0)
+	, _pipelined_routes_changed (0)
 	, _ac_thread_active (false)
 	, _latency_recompute_pending (0)
 	, step_speed (0)
@@ -291,9 +296,35 @@ Session::Session (AudioEngine &eng,
 	, no_questions_about_missing_files (false)
 	, _playback_load (0)
 	, _capture_load (0)
+	, _playback_buffer_memory (0)
+	, _capture_buffer_memory (0)
+	, _near_underruns (0)
+	, _locate_start (0)
+	, _locate_latency_total (0)
+	, _locates (0)
+	, _locate_latency_last (0)
+	, _locate_latency_mean (0)
+	, _locate_latency_max (0)
+	, _locate_latency_reset (0)
 	, _bundles (new BundleList)
 	, _bundle_xml_node (0)
 	, _current_trans (0)
+	, _click_voices (new Click[max_click_voices])
+	, _n_click_voices (0)
+	, _click_queue (new PBD::RingBuffer<ClickPoint> (1024))
+	, _click_generation (0)
+	, _click_lap (0)
+	, _click_queued_generation (-1)
+	, _click_refill_seq (0)
+	, _click_refill_at (0)
+	, _click_refill_lap (0)
+	, _click_refill_requested (0)
+	, _click_fill_generation (~0)
+	, _click_fill_pos (0)
+	, _click_fill_lap (0)
+	, _click_fill_loop_start (0)
+	, _click_fill_loop_end (0)
+	, _click_last_beat (-1)
 	, _clicking (false)
 	, click_data (0)
 	, click_emphasis_data (0)
@@ -680,6 +711,8 @@ Session::destroy ()
 	}
 
 	clear_clicks ();
+	delete _click_queue;
+	delete [] _click_voices;
 
 	/* need to remove auditioner before monitoring section
 	 * otherwise it is re-connected */
@@ -744,6 +777,8 @@ Session::destroy ()
 	/* not strictly necessary, but doing it here allows the shared_ptr debugging to work */
 	playlists.reset ();
 
+	PlaylistRenderCache::stop_writer_thread ();
+
 	emit_thread_terminate ();
 
 	pthread_cond_destroy (&_rt_emit_cond);
@@ -2142,6 +2177,11 @@ Session::set_block_size (pframes_t nframes)
 
 		set_worst_io_latencies ();
 	}
+
+	if (Config->get_pipelined_processing ()) {
+		/* pipelined tracks are delayed by one cycle */
+		update_latency_compensation ();
+	}
 }
 
 
@@ -2218,6 +2258,11 @@ Session::resort_routes ()
 		/* writer goes out of scope and forces update */
 	}
 
+	if (g_atomic_int_compare_and_exchange (&_pipelined_routes_changed, 1, 0)) {
+		/* pipelined tracks add a cycle of latency */
+		update_latency_compensation ();
+	}
+
 #ifndef NDEBUG
 	if (DEBUG_ENABLED(DEBUG::Graph)) {
 		boost::shared_ptr<RouteList> rl = routes.reader ();
@@ -2263,12 +2308,17 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 	 *    is used by the solo code.
 	 */
 
-	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+	FeedMatrix feeds;
+	feeds.reset (r->size ());
+
+	uint32_t ii = 0;
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i, ++ii) {
 
 		/* Clear out the route's list of direct or indirect feeds */
 		(*i)->clear_fed_by ();
 
-		for (RouteList::iterator j = r->begin(); j != r->end(); ++j) {
+		uint32_t jj = 0;
+		for (RouteList::iterator j = r->begin(); j != r->end(); ++j, ++jj) {
 
 			bool via_sends_only;
 
@@ -2280,10 +2330,67 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 				edges.add (*j, *i, via_sends_only);
 				/* tell the route (for part #2) */
 				(*i)->add_fed_by (*j, via_sends_only);
+				/* and the session's reachability index */
+				feeds.add (jj, ii, via_sends_only);
 			}
 		}
 	}
 
+	/* Pipelined processing: the output of playback-only tracks is
+	 * delivered to their ports at the start of the next cycle (see
+	 * Delivery::deliver_pipelined), so nothing they feed needs to wait for
+	 * them in the process graph, and they run in parallel with the busses.
+	 * This only pays off with more than one process thread.
+	 *
+	 * The extra cycle of latency is compensated for by the usual
+	 * track latency compensation. Tracks that may listen to their input
+	 * are never pipelined (see Track::can_be_pipelined).
+	 *
+	 * The process thread applies the new pipelined states when it picks up
+	 * the new graph (Graph::swap_chain), so the two always match.
+	 */
+
+	GraphEdges process_edges (edges);
+	set<GraphVertex> pipelined_routes;
+
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+		boost::shared_ptr<Delivery> main_outs = (*i)->main_outs ();
+
+		if (!main_outs) {
+			continue;
+		}
+
+		const bool pipelined = _process_graph && Config->get_pipelined_processing ()
+			&& tr && !tr->is_auditioner () && tr->can_be_pipelined ();
+
+		if (pipelined) {
+			pipelined_routes.insert (*i);
+			set<GraphVertex> fed (edges.from (*i));
+			for (set<GraphVertex>::iterator f = fed.begin(); f != fed.end(); ++f) {
+				process_edges.remove (*i, *f);
+			}
+		}
+	}
+
+	/* The index used for solo propagation follows the connections as
+	 * they are, even with feedback: unlike trace_terminal(), the
+	 * closure copes with cycles.
+	 */
+	feeds.close ();
+
+	{
+		Glib::Threads::Mutex::Lock lm (_route_feeds_lock);
+		_route_feeds.swap (feeds);
+		_route_feed_routes.clear ();
+		_route_feed_index.clear ();
+		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+			_route_feed_index[(*i).get ()] = _route_feed_routes.size ();
+			_route_feed_routes.push_back (*i);
+		}
+	}
+
 	/* Attempt a topological sort of the route graph */
 	boost::shared_ptr<RouteList> sorted_routes = topological_sort (r, edges);
 
@@ -2295,7 +2402,17 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 		   topologically-sorted list, but hey ho.
 		*/
 		if (_process_graph) {
-			_process_graph->rechain (sorted_routes, edges);
+			for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+				boost::shared_ptr<Delivery> main_outs = (*i)->main_outs ();
+				if (!main_outs) {
+					continue;
+				}
+				if (main_outs->prepare_pipeline (pipelined_routes.find (*i) != pipelined_routes.end ())) {
+					g_atomic_int_set (&_pipelined_routes_changed, 1);
+				}
+			}
+
+			_process_graph->rechain (sorted_routes, process_edges, pipelined_routes);
 		}
 
 		_current_route_graph = edges;
@@ -2324,8 +2441,8 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 		   until the feedback is fixed, what is played back will not quite
 		   reflect what is actually connected.  Note also that we do not
 		   do trace_terminal here, as it would fail due to an endless recursion,
-		   so the solo code will think that everything is still connected
-		   as it was before.
+		   so the routes' fed-by lists only hold their direct feeds. Solo
+		   propagation uses the session's index, which is up to date.
 		*/
 
 		FeedbackDetected (); /* EMIT SIGNAL */
@@ -2444,6 +2561,8 @@ Session::new_midi_track (const ChanCount& input, const ChanCount& output,
 	const string name_pattern = default_track_name_pattern (DataType::MIDI);
 	bool const use_number = (how_many != 1) || name_template.empty () || (name_template == name_pattern);
 
+	PortManager::RegistrationBatch port_batch (_engine);
+
 	while (how_many) {
 		if (!find_route_name (name_template.empty() ? _("MIDI") : name_template, ++track_id, track_name, use_number)) {
 			error << "cannot find name for new midi track" << endmsg;
@@ -2482,6 +2601,22 @@ Session::new_midi_track (const ChanCount& input, const ChanCount& output,
 
 			track->non_realtime_input_change();
 
+			/* add the instrument before the track is added to the
+			 * session, so that the whole batch is sorted into the
+			 * graph once. This also means that its audio outputs are
+			 * auto-connected by add_routes() like those of audio
+			 * tracks (counting on from the outputs of existing
+			 * tracks), not by midi_output_change_handler().
+			 */
+			if (instrument) {
+				PluginPtr plugin = instrument->load (*this);
+				if (pset) {
+					plugin->load_preset (*pset);
+				}
+				boost::shared_ptr<Processor> p (new PluginInsert (*this, plugin));
+				track->add_processor (p, PreFader);
+			}
+
 			if (route_group) {
 				route_group->add (track);
 			}
@@ -2507,6 +2642,8 @@ Session::new_midi_track (const ChanCount& input, const ChanCount& output,
 	}
 
   failed:
+	port_batch.end ();
+
 	if (!new_routes.empty()) {
 		StateProtector sp (this);
 		if (Profile->get_trx()) {
@@ -2514,18 +2651,6 @@ Session::new_midi_track (const ChanCount& input, const ChanCount& output,
 		} else {
 			add_routes (new_routes, true, true, false, order);
 		}
-
-		if (instrument) {
-			for (RouteList::iterator r = new_routes.begin(); r != new_routes.end(); ++r) {
-				PluginPtr plugin = instrument->load (*this);
-				if (pset) {
-					plugin->load_preset (*pset);
-				}
-				boost::shared_ptr<Processor> p (new PluginInsert (*this, plugin));
-				(*r)->add_processor (p, PreFader);
-
-			}
-		}
 	}
 
 	return ret;
@@ -2542,6 +2667,8 @@ Session::new_midi_route (RouteGroup* route_group, uint32_t how_many, string name
 
 	bool const use_number = (how_many != 1) || name_template.empty () || name_template == _("Midi Bus");
 
+	PortManager::RegistrationBatch port_batch (_engine);
+
 	while (how_many) {
 		if (!find_route_name (name_template.empty () ? _("Midi Bus") : name_template, ++bus_id, bus_name, use_number)) {
 			error << "cannot find name for new midi bus" << endmsg;
@@ -2576,6 +2703,16 @@ Session::new_midi_route (RouteGroup* route_group, uint32_t how_many, string name
 				}
 			}
 
+			/* see new_midi_track() */
+			if (instrument) {
+				PluginPtr plugin = instrument->load (*this);
+				if (pset) {
+					plugin->load_preset (*pset);
+				}
+				boost::shared_ptr<Processor> p (new PluginInsert (*this, plugin));
+				bus->add_processor (p, PreFader);
+			}
+
 			if (route_group) {
 				route_group->add (bus);
 			}
@@ -2599,20 +2736,11 @@ Session::new_midi_route (RouteGroup* route_group, uint32_t how_many, string name
 	}
 
   failure:
+	port_batch.end ();
+
 	if (!ret.empty()) {
 		StateProtector sp (this);
 		add_routes (ret, false, false, false, order);
-
-		if (instrument) {
-			for (RouteList::iterator r = ret.begin(); r != ret.end(); ++r) {
-				PluginPtr plugin = instrument->load (*this);
-				if (pset) {
-					plugin->load_preset (*pset);
-				}
-				boost::shared_ptr<Processor> p (new PluginInsert (*this, plugin));
-				(*r)->add_processor (p, PreFader);
-			}
-		}
 	}
 
 	return ret;
@@ -2972,6 +3100,8 @@ Session::new_audio_track (int input_channels, int output_channels, RouteGroup* r
 	const string name_pattern = default_track_name_pattern (DataType::AUDIO);
 	bool const use_number = (how_many != 1) || name_template.empty () || (name_template == name_pattern);
 
+	PortManager::RegistrationBatch port_batch (_engine);
+
 	while (how_many) {
 
 		if (!find_route_name (name_template.empty() ? _(name_pattern.c_str()) : name_template, ++track_id, track_name, use_number)) {
@@ -3057,6 +3187,8 @@ Session::new_audio_track (int input_channels, int output_channels, RouteGroup* r
 	}
 
   failed:
+	port_batch.end ();
+
 	if (!new_routes.empty()) {
 		StateProtector sp (this);
 		if (Profile->get_trx()) {
@@ -3083,6 +3215,8 @@ Session::new_audio_route (int input_channels, int output_channels, RouteGroup* r
 
 	bool const use_number = (how_many != 1) || name_template.empty () || name_template == _("Bus");
 
+	PortManager::RegistrationBatch port_batch (_engine);
+
 	while (how_many) {
 		if (!find_route_name (name_template.empty () ? _("Bus") : name_template, ++bus_id, bus_name, use_number)) {
 			error << "cannot find name for new audio bus" << endmsg;
@@ -3144,6 +3278,8 @@ Session::new_audio_route (int input_channels, int output_channels, RouteGroup* r
 	}
 
   failure:
+	port_batch.end ();
+
 	if (!ret.empty()) {
 		StateProtector sp (this);
 		if (Profile->get_trx()) {
@@ -3181,6 +3317,7 @@ Session::new_route_from_template (uint32_t how_many, PresentationInfo::order_t i
 	*/
 	Stateful::ForceIDRegeneration force_ids;
 	IO::disable_connecting ();
+	PortManager::RegistrationBatch port_batch (_engine);
 
 	while (how_many) {
 
@@ -3338,6 +3475,8 @@ Session::new_route_from_template (uint32_t how_many, PresentationInfo::order_t i
 	}
 
   out:
+	port_batch.end ();
+
 	if (!ret.empty()) {
 		StateProtector sp (this);
 		if (Profile->get_trx()) {
@@ -3434,6 +3573,8 @@ Session::add_routes_inner (RouteList& new_routes, bool input_auto_connect, bool
 			tr->PlaylistChanged.connect_same_thread (*this, boost::bind (&Session::track_playlist_changed, this, boost::weak_ptr<Track> (tr)));
 			track_playlist_changed (boost::weak_ptr<Track> (tr));
 			tr->rec_enable_control()->Changed.connect_same_thread (*this, boost::bind (&Session::update_route_record_state, this));
+			tr->rec_enable_control()->Changed.connect_same_thread (*this, boost::bind (&Session::queue_pipeline_update, this));
+			tr->monitoring_control()->Changed.connect_same_thread (*this, boost::bind (&Session::queue_pipeline_update, this));
 
 			boost::shared_ptr<MidiTrack> mt = boost::dynamic_pointer_cast<MidiTrack> (tr);
 			if (mt) {
@@ -3798,6 +3939,39 @@ Session::route_solo_isolated_changed (boost::weak_ptr<Route> wpr)
 	}
 }
 
+/** A route in the signal flow of a route whose solo state changed */
+struct SoloFlowRoute {
+	SoloFlowRoute (boost::shared_ptr<Route> r) : route (r), feeds (false), fed (false), feeds_via_sends_only (false), fed_via_sends_only (false) {}
+	boost::shared_ptr<Route> route;
+	bool feeds; ///< route feeds the changed route
+	bool fed;   ///< route is fed by the changed route
+	bool feeds_via_sends_only;
+	bool fed_via_sends_only;
+};
+
+/** @return false if solo changes of other routes are not propagated to @param r */
+static bool
+solo_propagates_to (boost::shared_ptr<Route> const& r, RouteGroup* rg, bool group_already_accounted_for)
+{
+	if (r->solo_isolate_control()->solo_isolated() || !r->can_solo()) {
+		/* route does not get solo propagated to it */
+		DEBUG_TRACE (DEBUG::Solo, string_compose ("%1 excluded from solo because iso = %2 can_solo = %3\n", r->name(), r->solo_isolate_control()->solo_isolated(),
+		                                          r->can_solo()));
+		return false;
+	}
+
+	if ((group_already_accounted_for && r->route_group() && r->route_group() == rg)) {
+		/* this route is a part of the same solo group as the route
+		 * that was changed. Changing that route did change or will
+		 * change all group members appropriately, so we can ignore it
+		 * here
+		 */
+		return false;
+	}
+
+	return true;
+}
+
 void
 Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlDisposition group_override,  boost::weak_ptr<Route> wpr)
 {
@@ -3865,17 +4039,7 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 				continue;
 			}
 
-			if ((*i)->solo_isolate_control()->solo_isolated() || !(*i)->can_solo()) {
-				/* route does not get solo propagated to it */
-				continue;
-			}
-
-			if ((group_already_accounted_for && (*i)->route_group() && (*i)->route_group() == rg)) {
-				/* this route is a part of the same solo group as the route
-				 * that was changed. Changing that route did change or will
-				 * change all group members appropriately, so we can ignore it
-				 * here
-				 */
+			if (!solo_propagates_to (*i, rg, group_already_accounted_for)) {
 				continue;
 			}
 
@@ -3885,83 +4049,95 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 
 	DEBUG_TRACE (DEBUG::Solo, string_compose ("propagate solo change, delta = %1\n", delta));
 
+	/* Only routes in the signal flow of the changed route need to be
+	 * visited, the session's reachability index has them. Everything
+	 * else is "uninvolved" and only needs to be told if its (implicit)
+	 * mute state changed, which is only the case when the session
+	 * starts or stops soloing.
+	 */
+
+	std::vector<SoloFlowRoute> involved;
 	RouteList uninvolved;
+	std::vector<bool> uninvolved_was_muted;
 
-	DEBUG_TRACE (DEBUG::Solo, string_compose ("%1\n", route->name()));
+	{
+		Glib::Threads::Mutex::Lock lm (_route_feeds_lock);
 
-	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
-		bool via_sends_only;
-		bool in_signal_flow;
+		FeedMatrix::Set in_flow (_route_feeds.size ());
+		std::map<Route const*, uint32_t>::const_iterator x = _route_feed_index.find (route.get ());
 
-		if ((*i) == route) {
-			/* already changed */
-			continue;
-		}
+		if (x != _route_feed_index.end ()) {
+			const uint32_t n = x->second;
+			in_flow = _route_feeds.upstream (n) | _route_feeds.downstream (n);
 
-		if ((*i)->solo_isolate_control()->solo_isolated() || !(*i)->can_solo()) {
-			/* route does not get solo propagated to it */
-			DEBUG_TRACE (DEBUG::Solo, string_compose ("%1 excluded from solo because iso = %2 can_solo = %3\n", (*i)->name(), (*i)->solo_isolate_control()->solo_isolated(),
-			                                          (*i)->can_solo()));
-			continue;
+			for (FeedMatrix::Set::size_type i = in_flow.find_first (); i != FeedMatrix::Set::npos; i = in_flow.find_next (i)) {
+				boost::shared_ptr<Route> other (_route_feed_routes[i].lock ());
+				if (!other || other == route) {
+					continue;
+				}
+				SoloFlowRoute inv (other);
+				inv.feeds = _route_feeds.feeds (i, n, &inv.feeds_via_sends_only);
+				inv.fed   = _route_feeds.feeds (n, i, &inv.fed_via_sends_only);
+				involved.push_back (inv);
+			}
+		} else {
+			DEBUG_TRACE (DEBUG::Solo, string_compose ("%1 is not (yet) part of the route graph\n", route->name()));
 		}
 
-		if ((group_already_accounted_for && (*i)->route_group() && (*i)->route_group() == rg)) {
-			/* this route is a part of the same solo group as the route
-			 * that was changed. Changing that route did change or will
-			 * change all group members appropriately, so we can ignore it
-			 * here
-			 */
-			continue;
+		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+			if ((*i) == route || !solo_propagates_to (*i, rg, group_already_accounted_for)) {
+				continue;
+			}
+			std::map<Route const*, uint32_t>::const_iterator y = _route_feed_index.find ((*i).get ());
+			if (y == _route_feed_index.end () || !in_flow.test (y->second)) {
+				uninvolved.push_back (*i);
+				uninvolved_was_muted.push_back ((*i)->muted_by_others_soloing ());
+			}
 		}
+	}
 
-		in_signal_flow = false;
+	DEBUG_TRACE (DEBUG::Solo, string_compose ("%1: %2 routes in signal flow, %3 uninvolved\n", route->name(), involved.size (), uninvolved.size ()));
 
-		DEBUG_TRACE (DEBUG::Solo, string_compose ("check feed from %1\n", (*i)->name()));
+	for (std::vector<SoloFlowRoute>::iterator inv = involved.begin(); inv != involved.end(); ++inv) {
 
-		if ((*i)->feeds (route, &via_sends_only)) {
-			DEBUG_TRACE (DEBUG::Solo, string_compose ("\tthere is a feed from %1\n", (*i)->name()));
-			if (!via_sends_only) {
+		boost::shared_ptr<Route> const& other (inv->route);
+
+		if (!solo_propagates_to (other, rg, group_already_accounted_for)) {
+			continue;
+		}
+
+		if (inv->feeds) {
+			DEBUG_TRACE (DEBUG::Solo, string_compose ("\tthere is a feed from %1\n", other->name()));
+			if (!inv->feeds_via_sends_only) {
 				if (!route->soloed_by_others_upstream()) {
-					(*i)->solo_control()->mod_solo_by_others_downstream (delta);
+					other->solo_control()->mod_solo_by_others_downstream (delta);
 				} else {
 					DEBUG_TRACE (DEBUG::Solo, "\talready soloed by others upstream\n");
 				}
 			} else {
-				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tthere is a send-only feed from %1\n", (*i)->name()));
+				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tthere is a send-only feed from %1\n", other->name()));
 			}
-			in_signal_flow = true;
-		} else {
-			DEBUG_TRACE (DEBUG::Solo, string_compose ("\tno feed from %1\n", (*i)->name()));
 		}
 
-		DEBUG_TRACE (DEBUG::Solo, string_compose ("check feed to %1\n", (*i)->name()));
-
-		if (route->feeds (*i, &via_sends_only)) {
+		if (inv->fed) {
 			/* propagate solo upstream only if routing other than
 			   sends is involved, but do consider the other route
-			   (*i) to be part of the signal flow even if only
+			   to be part of the signal flow even if only
 			   sends are involved.
 			*/
 			DEBUG_TRACE (DEBUG::Solo, string_compose ("%1 feeds %2 via sends only %3 sboD %4 sboU %5\n",
 			                                          route->name(),
-			                                          (*i)->name(),
-			                                          via_sends_only,
+			                                          other->name(),
+			                                          inv->fed_via_sends_only,
 			                                          route->soloed_by_others_downstream(),
 			                                          route->soloed_by_others_upstream()));
-			if (!via_sends_only) {
+			if (!inv->fed_via_sends_only) {
 				//NB. Triggers Invert Push, which handles soloed by downstream
-				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tmod %1 by %2\n", (*i)->name(), delta));
-				(*i)->solo_control()->mod_solo_by_others_upstream (delta);
+				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tmod %1 by %2\n", other->name(), delta));
+				other->solo_control()->mod_solo_by_others_upstream (delta);
 			} else {
-				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tfeed to %1 ignored, sends-only\n", (*i)->name()));
+				DEBUG_TRACE (DEBUG::Solo, string_compose ("\tfeed to %1 ignored, sends-only\n", other->name()));
 			}
-			in_signal_flow = true;
-		} else {
-			DEBUG_TRACE (DEBUG::Solo, "\tno feed to\n");
-		}
-
-		if (!in_signal_flow) {
-			uninvolved.push_back (*i);
 		}
 	}
 
@@ -3969,11 +4145,16 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 
 	update_route_solo_state (r);
 
-	/* now notify that the mute state of the routes not involved in the signal
-	   pathway of the just-solo-changed route may have altered.
+	/* now notify the routes not involved in the signal pathway of the
+	   just-solo-changed route whose mute state did alter.
 	*/
 
-	for (RouteList::iterator i = uninvolved.begin(); i != uninvolved.end(); ++i) {
+	std::vector<bool>::const_iterator was_muted = uninvolved_was_muted.begin();
+
+	for (RouteList::iterator i = uninvolved.begin(); i != uninvolved.end(); ++i, ++was_muted) {
+		if ((*i)->muted_by_others_soloing () == *was_muted) {
+			continue;
+		}
 		DEBUG_TRACE (DEBUG::Solo, string_compose ("mute change for %1, which neither feeds or is fed by %2\n", (*i)->name(), route->name()));
 		(*i)->act_on_mute ();
 		(*i)->mute_control()->Changed (false, Controllable::NoGroup);
@@ -6034,8 +6215,10 @@ Session::write_one_track (Track& track, framepos_t start, framepos_t end,
 		for (vector<boost::shared_ptr<Source> >::iterator src = srcs.begin(); src != srcs.end(); ++src) {
 			boost::shared_ptr<AudioFileSource> afs = boost::dynamic_pointer_cast<AudioFileSource>(*src);
 
-			if (afs)
+			if (afs) {
+				Source::Lock lm (afs->mutex());
 				afs->done_with_peakfile_writes ();
+			}
 		}
 	}
 
@@ -6156,6 +6339,23 @@ Session::have_rec_disabled_track () const
 }
 
 /** Update the state of our rec-enabled tracks flag */
+void
+Session::queue_pipeline_update ()
+{
+	if (!Config->get_pipelined_processing ()) {
+		return;
+	}
+
+	if (AudioEngine::instance()->in_process_thread ()) {
+		/* rt-controls: handled by ::rt_controls_done() once the
+		 * change is back in the thread that asked for it.
+		 */
+		g_atomic_int_set (&_pipeline_update_pending, 1);
+	} else {
+		resort_routes ();
+	}
+}
+
 void
 Session::update_route_record_state ()
 {
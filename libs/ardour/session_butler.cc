@@ -17,11 +17,19 @@
 
 */
 
+#include <cmath>
+#include <vector>
+
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/stacktrace.h"
 
+#include "ardour/audio_diskstream.h"
+#include "ardour/audio_track.h"
+#include "ardour/audioplaylist.h"
 #include "ardour/butler.h"
+#include "ardour/debug.h"
+#include "ardour/location.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
 #include "ardour/session_event.h"
@@ -121,3 +129,110 @@ Session::capture_load ()
 {
 	return (uint32_t) g_atomic_int_get (&_capture_load);
 }
+
+uint32_t
+Session::playback_buffer_memory () const
+{
+	return (uint32_t) g_atomic_int_get (&_playback_buffer_memory);
+}
+
+uint32_t
+Session::capture_buffer_memory () const
+{
+	return (uint32_t) g_atomic_int_get (&_capture_buffer_memory);
+}
+
+uint32_t
+Session::near_underruns () const
+{
+	return (uint32_t) g_atomic_int_get (&_near_underruns);
+}
+
+/** Distribute the memory that the playback buffers of all audio tracks
+ * would use at the configured buffer size, according to how much data
+ * each track is likely to need: tracks that were not read during the
+ * last few transport runs get a minimal buffer, tracks with dense material
+ * that read fast (varispeed, locates) get up to 4 times the default.
+ *
+ * Called from the butler after the transport stopped.
+ */
+void
+Session::adapt_playback_buffering ()
+{
+	if (!Config->get_adaptive_playback_buffering ()) {
+		return;
+	}
+
+	const framecnt_t nominal  = _butler->audio_diskstream_playback_buffer_size ();
+	const framecnt_t min_size = std::min (nominal, 2 * Diskstream::disk_read_frames ());
+	const framecnt_t max_size = 4 * nominal;
+
+	typedef std::vector<std::pair<boost::shared_ptr<AudioDiskstream>, double> > Demands;
+	Demands demands;
+
+	double     budget = 0;
+	double     total_demand = 0;
+	framecnt_t total_read = 0;
+
+	boost::shared_ptr<RouteList> rl = routes.reader();
+
+	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
+		boost::shared_ptr<AudioTrack> at = boost::dynamic_pointer_cast<AudioTrack> (*i);
+		if (!at) {
+			continue;
+		}
+		boost::shared_ptr<AudioDiskstream> ds = at->audio_diskstream ();
+		const uint32_t n_chan = ds->n_channels().n_audio();
+		if (n_chan == 0) {
+			continue;
+		}
+
+		ds->close_read_run ();
+
+		/* every rolling track reads at about the same rate; those with
+		 * little material in the range they read need less buffer.
+		 */
+		AudioDiskstream::ReadWindow const & w (ds->read_window ());
+		const double demand = w.rate () * (0.1 + w.density ());
+
+		budget += nominal * n_chan;
+		total_demand += demand * n_chan;
+		total_read += w.read ();
+		demands.push_back (std::make_pair (ds, demand));
+	}
+
+	/* wait until, on average, every track has been read for a full buffer */
+	if (demands.empty () || total_read < (framecnt_t) demands.size () * nominal) {
+		return;
+	}
+
+	/* every track gets the minimum, the rest is distributed by demand */
+	double spare = budget;
+	for (Demands::const_iterator d = demands.begin(); d != demands.end(); ++d) {
+		spare -= min_size * d->first->n_channels().n_audio();
+	}
+
+	bool changed = false;
+
+	for (Demands::const_iterator d = demands.begin(); d != demands.end(); ++d) {
+		framecnt_t size = min_size;
+		if (total_demand > 0) {
+			size += spare * d->second / total_demand;
+		}
+		size = std::min (max_size, size);
+
+		const double scale = size / (double) nominal;
+		const double current = d->first->playback_buffer_scale ();
+
+		/* hysteresis: re-allocating buffers means re-reading them */
+		if (fabs (scale - current) > 0.25 * current) {
+			DEBUG_TRACE (DEBUG::Butler, string_compose ("adapt playback buffer of %1 from %2 to %3 frames\n", d->first->name (), d->first->playback_buffer_size (), size));
+			d->first->set_playback_buffer_scale (scale);
+			changed = true;
+		}
+	}
+
+	if (changed) {
+		adjust_playback_buffering ();
+	}
+}
@@ -17,14 +17,18 @@
 
 */
 
-#include <list>
 #include <cerrno>
+#include <cmath>
 
 #include "ardour/amp.h"
 #include "ardour/audio_buffer.h"
 #include "ardour/buffer_set.h"
+#include "ardour/butler.h"
 #include "ardour/click.h"
 #include "ardour/io.h"
+#include "ardour/location.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 #include "ardour/tempo.h"
 #include "ardour/types.h"
@@ -37,12 +41,39 @@ using namespace std;
 using namespace ARDOUR;
 using namespace PBD;
 
-Pool Click::pool ("click", sizeof (Click), 1024);
+/** how far ahead of the playhead the butler queues clicks */
+static framecnt_t
+click_lookahead (framecnt_t sample_rate)
+{
+	return sample_rate;
+}
+
+/** @return true if (@a pos, @a lap) comes before (@a other_pos, @a other_lap) */
+static bool
+click_before (framepos_t pos, guint lap, framepos_t other_pos, guint other_lap)
+{
+	return (gint) (lap - other_lap) < 0 || (lap == other_lap && pos < other_pos);
+}
+
+/** Move (@a pos, @a lap) on by @a distance, wrapping at @a loop_end
+ * to @a loop_start if there is a loop (@a loop_end > @a loop_start).
+ */
+static void
+click_advance (framepos_t& pos, guint& lap, framecnt_t distance, framepos_t loop_start, framepos_t loop_end)
+{
+	pos += distance;
+
+	if (loop_end > loop_start && pos >= loop_end) {
+		const framecnt_t len = loop_end - loop_start;
+		const framecnt_t laps = (pos - loop_end) / len + 1;
+		pos -= laps * len;
+		lap += laps;
+	}
+}
 
 void
 Session::click (framepos_t start, framecnt_t nframes)
 {
-	vector<TempoMap::BBTPoint> points;
 	Sample *buf;
 	framecnt_t click_distance;
 
@@ -71,65 +102,70 @@ Session::click (framepos_t start, framecnt_t nframes)
 	BufferSet& bufs = get_scratch_buffers(ChanCount(DataType::AUDIO, 1));
 	buf = bufs.get_audio(0).data();
 
-	_tempo_map->get_grid (points, start, end);
+	/* start a voice for every click that was queued for this cycle */
 
-	if (distance (points.begin(), points.end()) == 0) {
-		goto run_clicks;
-	}
+	const guint generation = g_atomic_int_get (&_click_generation);
+	const guint lap = g_atomic_int_get (&_click_lap);
 
-	for (vector<TempoMap::BBTPoint>::iterator i = points.begin(); i != points.end(); ++i) {
-		switch ((*i).beat) {
-		case 1:
-			if (click_emphasis_data && Config->get_use_click_emphasis () == true) {
-				clicks.push_back (new Click ((*i).frame, click_emphasis_length, click_emphasis_data));
-			} else if (click_data && Config->get_use_click_emphasis () == false) {
-				clicks.push_back (new Click ((*i).frame, click_length, click_data));
-			}
-			break;
+	while (_click_queue->read_space () > 0) {
+		PBD::RingBuffer<ClickPoint>::rw_vector vec;
+		_click_queue->get_read_vector (&vec);
+		ClickPoint const& cp (vec.buf[0][0]);
 
-		default:
-			if (click_emphasis_data == 0 || (Config->get_use_click_emphasis () == false) || (click_emphasis_data && (*i).beat != 1)) {
-				clicks.push_back (new Click ((*i).frame, click_length, click_data));
-			}
+		if (cp.generation == generation && !click_before (cp.frame, cp.lap, end, lap)) {
+			/* later in this lap, or after the loop start */
 			break;
 		}
-	}
 
-  run_clicks:
-	memset (buf, 0, sizeof (Sample) * nframes);
+		if (cp.generation == generation && cp.lap == lap && cp.frame >= start) {
+			start_click (cp);
+		}
 
-	for (list<Click*>::iterator i = clicks.begin(); i != clicks.end(); ) {
+		/* else: stale (locate, tempo change) or too late */
+		_click_queue->increment_read_idx (1);
+	}
 
-		framecnt_t copy;
-		framecnt_t internal_offset;
-		Click *clk;
+	bool refill = (guint) g_atomic_int_get (&_click_queued_generation) != generation;
 
-		clk = *i;
+	if (!refill) {
+		const gint seq = g_atomic_int_get (&_click_refill_seq);
+		const framepos_t refill_at = _click_refill_at;
+		const guint refill_lap = _click_refill_lap;
+		/* if the butler is updating these, it is busy with the queue anyway */
+		if (!(seq & 1) && g_atomic_int_get (&_click_refill_seq) == seq) {
+			refill = !click_before (end, lap, refill_at, refill_lap);
+		}
+	}
 
-		if (clk->start < start) {
-			internal_offset = 0;
-		} else {
-			internal_offset = clk->start - start;
+	if (refill) {
+		if (g_atomic_int_compare_and_exchange (&_click_refill_requested, 0, 1)) {
+			_butler->summon ();
 		}
+	}
+
+	memset (buf, 0, sizeof (Sample) * nframes);
+
+	for (uint32_t v = 0; v < _n_click_voices; ) {
+
+		Click& clk (_click_voices[v]);
+		const framecnt_t internal_offset = clk.start < start ? 0 : clk.start - start;
 
-		if (nframes < internal_offset) {
-		         /* we've just located or something..
-			    effectively going backwards.
-			    lets get the flock out of here */
-		        break;
+		if (internal_offset >= nframes) {
+			++v;
+			continue;
 		}
 
-		copy = min (clk->duration - clk->offset, nframes - internal_offset);
+		const framecnt_t copy = min (clk.duration - clk.offset, nframes - internal_offset);
 
-		memcpy (buf + internal_offset, &clk->data[clk->offset], copy * sizeof (Sample));
+		mix_buffers_with_gain (buf + internal_offset, &clk.data[clk.offset], copy, clk.gain);
 
-		clk->offset += copy;
+		clk.offset += copy;
 
-		if (clk->offset >= clk->duration) {
-			delete clk;
-			i = clicks.erase (i);
+		if (clk.offset >= clk.duration) {
+			/* voices are not ordered, fill the gap with the last one */
+			_click_voices[v] = _click_voices[--_n_click_voices];
 		} else {
-			++i;
+			++v;
 		}
 	}
 
@@ -137,6 +173,166 @@ Session::click (framepos_t start, framecnt_t nframes)
 	_click_io->copy_to_outputs (bufs, DataType::AUDIO, nframes, 0);
 }
 
+void
+Session::start_click (ClickPoint const& cp)
+{
+	if (_n_click_voices >= max_click_voices) {
+		return;
+	}
+
+	const bool use_emphasis = click_emphasis_data && Config->get_use_click_emphasis ();
+
+	switch (cp.kind) {
+	case ClickPoint::Emphasis:
+		if (use_emphasis) {
+			_click_voices[_n_click_voices++] = Click (cp.frame, click_emphasis_length, click_emphasis_data);
+		} else if (!Config->get_use_click_emphasis ()) {
+			_click_voices[_n_click_voices++] = Click (cp.frame, click_length, click_data);
+		}
+		break;
+	case ClickPoint::Beat:
+		_click_voices[_n_click_voices++] = Click (cp.frame, click_length, click_data);
+		break;
+	case ClickPoint::Subdivision:
+		_click_voices[_n_click_voices++] = Click (cp.frame, click_length, click_data, 0.5);
+		break;
+	}
+}
+
+/** Compute the positions of the upcoming clicks (up to one second ahead
+ * of the playhead) and queue them for the process thread. This keeps
+ * the tempo-map lock and memory allocation out of the realtime thread.
+ *
+ * While looping seamlessly, the clicks after the loop start are queued
+ * before the transport gets to the loop end, so that the first ones
+ * are not lost waiting for the butler after the transport wrapped.
+ */
+void
+Session::queue_clicks ()
+{
+	if (!_clicking || !_click_io) {
+		return;
+	}
+
+	const guint generation = g_atomic_int_get (&_click_generation);
+	const framecnt_t lookahead = click_lookahead (nominal_frame_rate ());
+
+	/* the process thread may wrap around the loop meanwhile */
+	guint lap;
+	framepos_t now;
+	do {
+		lap = g_atomic_int_get (&_click_lap);
+		now = max ((framepos_t) 0, _transport_frame - _worst_track_latency);
+	} while ((guint) g_atomic_int_get (&_click_lap) != lap);
+
+	/* like ::click(), the loop is shifted by the worst track latency */
+	framepos_t loop_start = 0;
+	framepos_t loop_end = 0;
+	Location* loop = _locations->auto_loop_location ();
+
+	if (play_loop && loop && Config->get_seamless_loop ()) {
+		loop_start = max ((framepos_t) 0, loop->start () - _worst_track_latency);
+		loop_end = max ((framepos_t) 0, loop->end () - _worst_track_latency);
+		if (now < loop_start || now >= loop_end) {
+			/* looping is about to end */
+			loop_start = loop_end = 0;
+		}
+	}
+
+	if (generation != _click_fill_generation
+	    || loop_start != _click_fill_loop_start || loop_end != _click_fill_loop_end
+	    || click_before (_click_fill_pos, _click_fill_lap, now, lap)) {
+		/* located, the tempo-map or loop changed, or the transport
+		 * overtook the queue: start over
+		 */
+		_click_fill_generation = generation;
+		_click_fill_loop_start = loop_start;
+		_click_fill_loop_end = loop_end;
+		_click_fill_pos = now;
+		_click_fill_lap = lap;
+		_click_last_beat = -1;
+	}
+
+	framepos_t fill_end = now;
+	guint fill_end_lap = lap;
+	click_advance (fill_end, fill_end_lap, lookahead, loop_start, loop_end);
+
+	const uint32_t subdivisions = max ((uint32_t) 1, Config->get_click_subdivisions ());
+	bool queue_full = false;
+
+	while (!queue_full && click_before (_click_fill_pos, _click_fill_lap, fill_end, fill_end_lap)) {
+
+		/* up to the loop end, or the end of the lookahead in the last lap */
+		const framepos_t seg_end = (_click_fill_lap == fill_end_lap) ? fill_end : loop_end;
+
+		vector<TempoMap::BBTPoint> points;
+		_tempo_map->get_grid (points, _click_fill_pos, seg_end);
+
+		framepos_t pos = seg_end;
+
+		for (vector<TempoMap::BBTPoint>::const_iterator i = points.begin(); i != points.end(); ++i) {
+
+			if ((*i).frame < _click_fill_pos || (*i).frame >= seg_end) {
+				continue;
+			}
+
+			if (_click_queue->write_space () < subdivisions) {
+				/* queue is full, continue from here next time */
+				pos = (*i).frame;
+				queue_full = true;
+				break;
+			}
+
+			ClickPoint cp;
+			cp.generation = generation;
+			cp.lap = _click_fill_lap;
+
+			/* subdivisions of the previous beat */
+			if (_click_last_beat >= 0 && subdivisions > 1) {
+				const double step = ((*i).frame - _click_last_beat) / (double) subdivisions;
+				cp.kind = ClickPoint::Subdivision;
+				for (uint32_t n = 1; n < subdivisions; ++n) {
+					cp.frame = _click_last_beat + (framepos_t) rint (n * step);
+					_click_queue->write (&cp, 1);
+				}
+			}
+
+			cp.frame = (*i).frame;
+			cp.kind = (*i).beat == 1 ? ClickPoint::Emphasis : ClickPoint::Beat;
+			_click_queue->write (&cp, 1);
+
+			_click_last_beat = (*i).frame;
+		}
+
+		_click_fill_pos = pos;
+
+		if (loop_end > loop_start && _click_fill_pos >= loop_end) {
+			/* no subdivisions across the loop end */
+			_click_fill_pos = loop_start;
+			++_click_fill_lap;
+			_click_last_beat = -1;
+		}
+	}
+
+	/* ask for more when half of the lookahead is left, or right away
+	 * if the queue was too short for all of it.
+	 */
+	framepos_t refill_at = now;
+	guint refill_lap = lap;
+
+	if (!queue_full) {
+		click_advance (refill_at, refill_lap, lookahead / 2, loop_start, loop_end);
+	}
+
+	g_atomic_int_inc (&_click_refill_seq);
+	_click_refill_at = refill_at;
+	_click_refill_lap = refill_lap;
+	g_atomic_int_inc (&_click_refill_seq);
+
+	g_atomic_int_set (&_click_queued_generation, generation);
+	g_atomic_int_set (&_click_refill_requested, 0);
+}
+
 void
 Session::setup_click_sounds (Sample** data, Sample const * default_data, framecnt_t* length, framecnt_t default_length, string const & path)
 {
@@ -227,11 +423,16 @@ void
 Session::clear_clicks ()
 {
 	Glib::Threads::RWLock::WriterLock lm (click_lock);
-
-	for (Clicks::iterator i = clicks.begin(); i != clicks.end(); ++i) {
-		delete *i;
-	}
-
-	clicks.clear ();
+	drop_clicks ();
 	_clicks_cleared = _transport_frame;
 }
+
+/** stop all clicks that are playing, and invalidate all queued ones.
+ * Caller must hold the click_lock.
+ */
+void
+Session::drop_clicks ()
+{
+	_n_click_voices = 0;
+	g_atomic_int_inc (&_click_generation);
+}
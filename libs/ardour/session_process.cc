@@ -32,6 +32,7 @@
 #include "ardour/butler.h"
 #include "ardour/cycle_timer.h"
 #include "ardour/debug.h"
+#include "ardour/delivery.h"
 #include "ardour/graph.h"
 #include "ardour/port.h"
 #include "ardour/process_thread.h"
@@ -84,17 +85,20 @@ Session::process (pframes_t nframes)
 	boost::shared_ptr<RouteList> r = routes.reader ();
 	for (RouteList::const_iterator i = r->begin(); i != r->end(); ++i) {
 		if ((*i)->apply_processor_changes_rt()) {
-			_rt_emit_pending = true;
+			g_atomic_int_set (&_rt_emit_pending, 1);
 		}
 	}
-	if (_rt_emit_pending) {
+	if (g_atomic_int_get (&_rt_emit_pending)) {
 		if (!_rt_thread_active) {
 			emit_route_signals ();
 		}
 		if (pthread_mutex_trylock (&_rt_emit_mutex) == 0) {
+			/* clear it while the emit thread is waiting, so that
+			 * requests made after this are not lost.
+			 */
+			g_atomic_int_set (&_rt_emit_pending, 0);
 			pthread_cond_signal (&_rt_emit_cond);
 			pthread_mutex_unlock (&_rt_emit_mutex);
-			_rt_emit_pending = false;
 		}
 	}
 
@@ -140,11 +144,16 @@ Session::no_roll (pframes_t nframes)
 		_click_io->silence (nframes);
 	}
 
+	deliver_pipelined_outputs (nframes);
+
 	ltc_tx_send_time_code_for_cycle (_transport_frame, end_frame, _target_transport_speed, _transport_speed, nframes);
 
-	if (_process_graph) {
+	if (_process_graph && _process_graph->threads_in_use ()) {
 		DEBUG_TRACE(DEBUG::ProcessThreads,"calling graph/no-roll\n");
-		_process_graph->routes_no_roll( nframes, _transport_frame, end_frame, non_realtime_work_pending(), declick);
+		if (_process_graph->routes_no_roll (nframes, _transport_frame, end_frame, non_realtime_work_pending(), declick) < 0) {
+			error << _("Session: error in no roll") << endmsg;
+			ret = -1;
+		}
 	} else {
 		PT_TIMING_CHECK (10);
 		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
@@ -180,7 +189,9 @@ Session::process_routes (pframes_t nframes, bool& need_butler)
 	const framepos_t start_frame = _transport_frame;
 	const framepos_t end_frame = _transport_frame + floor (nframes * _transport_speed);
 
-	if (_process_graph) {
+	deliver_pipelined_outputs (nframes);
+
+	if (_process_graph && _process_graph->threads_in_use ()) {
 		DEBUG_TRACE(DEBUG::ProcessThreads,"calling graph/process-routes\n");
 		if (_process_graph->process_routes (nframes, start_frame, end_frame, declick, need_butler) < 0) {
 			stop_transport ();
@@ -214,6 +225,30 @@ Session::process_routes (pframes_t nframes, bool& need_butler)
 	return 0;
 }
 
+/** Copy what pipelined tracks rendered last cycle to their output ports.
+ *  This must happen before any route that reads from these ports runs,
+ *  and in every cycle: nothing else writes to these ports.
+ */
+void
+Session::deliver_pipelined_outputs (pframes_t nframes)
+{
+	if (!_process_graph) {
+		return;
+	}
+
+	/* this applies changes to the pipelined state */
+	_process_graph->swap_chain ();
+
+	boost::shared_ptr<RouteList> r = routes.reader ();
+
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+		Delivery* main_outs = (*i)->main_outs ().get ();
+		if (main_outs && main_outs->pipelined ()) {
+			main_outs->deliver_pipelined (nframes);
+		}
+	}
+}
+
 /** @param need_butler to be set to true by this method if it needs the butler,
  *  otherwise it must be left alone.
  */
@@ -225,8 +260,14 @@ Session::silent_process_routes (pframes_t nframes, bool& need_butler)
 	const framepos_t start_frame = _transport_frame;
 	const framepos_t end_frame = _transport_frame + lrintf(nframes * _transport_speed);
 
-	if (_process_graph) {
-		_process_graph->silent_process_routes (nframes, start_frame, end_frame, need_butler);
+	deliver_pipelined_outputs (nframes);
+
+	if (_process_graph && _process_graph->threads_in_use ()) {
+		DEBUG_TRACE(DEBUG::ProcessThreads,"calling graph/silent-process-routes\n");
+		if (_process_graph->silent_process_routes (nframes, start_frame, end_frame, need_butler) < 0) {
+			stop_transport ();
+			return -1;
+		}
 	} else {
 		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
 
@@ -257,6 +298,9 @@ Session::get_track_statistics ()
 {
 	float pworst = 1.0f;
 	float cworst = 1.0f;
+	uint64_t pmem = 0;
+	uint64_t cmem = 0;
+	uint32_t near_underruns = 0;
 
 	boost::shared_ptr<RouteList> rl = routes.reader();
 	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
@@ -269,10 +313,19 @@ Session::get_track_statistics ()
 
 		pworst = min (pworst, tr->playback_buffer_load());
 		cworst = min (cworst, tr->capture_buffer_load());
+
+		const uint32_t n_audio = tr->n_channels().n_audio();
+		pmem += tr->playback_buffer_size() * n_audio;
+		cmem += tr->capture_buffer_size() * n_audio;
+
+		near_underruns += tr->near_underruns();
 	}
 
 	g_atomic_int_set (&_playback_load, (uint32_t) floor (pworst * 100.0f));
 	g_atomic_int_set (&_capture_load, (uint32_t) floor (cworst * 100.0f));
+	g_atomic_int_set (&_playback_buffer_memory, (uint32_t) (pmem * sizeof (Sample) / 1024));
+	g_atomic_int_set (&_capture_buffer_memory, (uint32_t) (cmem * sizeof (Sample) / 1024));
+	g_atomic_int_set (&_near_underruns, near_underruns);
 
 	if (actively_recording()) {
 		set_dirty();
@@ -891,6 +944,8 @@ Session::process_audition (pframes_t nframes)
 	SessionEvent* ev;
 	boost::shared_ptr<RouteList> r = routes.reader ();
 
+	deliver_pipelined_outputs (nframes);
+
 	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
 		if (!(*i)->is_auditioner()) {
 			(*i)->silence (nframes);
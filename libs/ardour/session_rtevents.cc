@@ -21,6 +21,7 @@
 #include "pbd/error.h"
 #include "pbd/compose.h"
 
+#include "ardour/audioengine.h"
 #include "ardour/monitor_control.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
@@ -69,6 +70,24 @@ Session::rt_set_controls (boost::shared_ptr<ControlList> cl, double val, Control
 	}
 }
 
+/** Called once rt_set_controls() is done, in the thread that queued the
+ *  change (usually the GUI), or without one in the process thread.
+ */
+void
+Session::rt_controls_done (SessionEvent* ev)
+{
+	Session* s = AudioEngine::instance()->session ();
+
+	if (s && !AudioEngine::instance()->in_process_thread ()) {
+		if (g_atomic_int_compare_and_exchange (&s->_pipeline_update_pending, 1, 0)) {
+			/* re-evaluate which tracks can be pipelined */
+			s->resort_routes ();
+		}
+	}
+
+	delete ev;
+}
+
 void
 Session::clear_all_solo_state (boost::shared_ptr<RouteList> rl)
 {
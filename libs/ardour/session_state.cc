@@ -99,6 +99,7 @@
 #include "ardour/midi_track.h"
 #include "ardour/pannable.h"
 #include "ardour/playlist_factory.h"
+#include "ardour/playlist_render_cache.h"
 #include "ardour/playlist_source.h"
 #include "ardour/port.h"
 #include "ardour/processor.h"
@@ -3772,8 +3773,23 @@ Session::config_changed (std::string p, bool ours)
 
 	} else if (p == "auto-loop") {
 
+	} else if (p == "pipelined-processing") {
+
+		resort_routes ();
+
+	} else if (p == "tape-machine-mode" || p == "monitoring-model") {
+
+		/* may change whether tracks can be pipelined */
+		if (Config->get_pipelined_processing ()) {
+			resort_routes ();
+		}
+
 	} else if (p == "auto-input") {
 
+		if (Config->get_pipelined_processing ()) {
+			resort_routes ();
+		}
+
 		if (Config->get_monitoring_model() == HardwareMonitoring && transport_rolling()) {
 			/* auto-input only makes a difference if we're rolling */
                         set_track_monitor_input_status (!config.get_auto_input());
@@ -3865,6 +3881,10 @@ Session::config_changed (std::string p, bool ours)
 
 		setup_click_sounds (-1);
 
+	} else if (p == "click-subdivisions") {
+
+		clear_clicks ();
+
 	} else if (p == "clicking") {
 
 		if (Config->get_clicking()) {
@@ -3952,6 +3972,8 @@ Session::config_changed (std::string p, bool ours)
 		last_timecode_valid = false;
 	} else if (p == "playback-buffer-seconds") {
 		AudioSource::allocate_working_buffers (frame_rate());
+	} else if (p == "playlist-render-cache-mb") {
+		PlaylistRenderCache::set_max_frames ((framecnt_t) Config->get_playlist_render_cache_mb () * 1048576 / sizeof (Sample));
 	} else if (p == "ltc-source-port") {
 		reconnect_ltc_input ();
 	} else if (p == "ltc-sink-port") {
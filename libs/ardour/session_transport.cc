@@ -546,10 +546,7 @@ Session::non_realtime_locate ()
 
 	_scene_changer->locate (_transport_frame);
 
-	/* XXX: it would be nice to generate the new clicks here (in the non-RT thread)
-	   rather than clearing them so that the RT thread has to spend time constructing
-	   them (in Session::click).
-	 */
+	/* queued clicks are obsolete, the butler will compute new ones */
 	clear_clicks ();
 }
 
@@ -866,6 +863,9 @@ Session::non_realtime_stop (bool abort, int on_entry, bool& finished)
 		if (!Config->get_loop_is_mode()) {
 			unset_play_loop ();
 		}
+		if (!pending_locate_roll) {
+			adapt_playback_buffering ();
+		}
 	}
 
 	PositionChanged (_transport_frame); /* EMIT SIGNAL */
@@ -1191,20 +1191,27 @@ Session::locate (framepos_t target_frame, bool with_roll, bool with_flush, bool
 		add_post_transport_work (todo);
 		need_butler = true;
 
+		if (_locate_start == 0) {
+			/* measure from the first of a series of locates the butler has not caught up with */
+			_locate_start = g_get_monotonic_time ();
+		}
+
 	} else {
 
-		/* this is functionally what clear_clicks() does but with a tentative lock */
+		/* seamless loop: the clicks after the loop start have been
+		 * queued already (see queue_clicks()), move on to them. Clicks
+		 * that are playing carry on from the start of the next cycle.
+		 */
 
 		Glib::Threads::RWLock::WriterLock clickm (click_lock, Glib::Threads::TRY_LOCK);
 
 		if (clickm.locked()) {
-
-			for (Clicks::iterator i = clicks.begin(); i != clicks.end(); ++i) {
-				delete *i;
+			for (uint32_t v = 0; v < _n_click_voices; ++v) {
+				_click_voices[v].start = 0;
 			}
-
-			clicks.clear ();
 		}
+
+		g_atomic_int_inc (&_click_lap);
 	}
 
 	if (with_roll) {
@@ -1641,6 +1648,8 @@ Session::post_transport ()
 
 	if (ptw & PostTransportLocate) {
 
+		note_locate_latency ();
+
 		if (((!config.get_external_sync() && (auto_play_legal && config.get_auto_play())) && !_exporting) || (ptw & PostTransportRoll)) {
 			start_transport ();
 		} else {
@@ -1655,6 +1664,60 @@ Session::post_transport ()
 	set_post_transport_work (PostTransportWork (0));
 }
 
+/** Called from the process thread once the butler has located all tracks */
+void
+Session::note_locate_latency ()
+{
+	if (_locate_start == 0) {
+		return;
+	}
+
+	if (g_atomic_int_compare_and_exchange (&_locate_latency_reset, 1, 0)) {
+		_locates = 0;
+		_locate_latency_total = 0;
+		g_atomic_int_set (&_locate_latency_max, 0);
+	}
+
+	const gint64 elapsed = g_get_monotonic_time () - _locate_start;
+	_locate_start = 0;
+
+	_locates++;
+	_locate_latency_total += elapsed;
+
+	g_atomic_int_set (&_locate_latency_last, (gint) elapsed);
+	g_atomic_int_set (&_locate_latency_mean, (gint) (_locate_latency_total / _locates));
+	if (elapsed > g_atomic_int_get (&_locate_latency_max)) {
+		g_atomic_int_set (&_locate_latency_max, (gint) elapsed);
+	}
+
+	DEBUG_TRACE (DEBUG::Transport, string_compose ("locate took %1 usecs\n", elapsed));
+}
+
+uint32_t
+Session::locate_latency_last () const
+{
+	return (uint32_t) g_atomic_int_get (&_locate_latency_last);
+}
+
+uint32_t
+Session::locate_latency_mean () const
+{
+	return (uint32_t) g_atomic_int_get (&_locate_latency_mean);
+}
+
+uint32_t
+Session::locate_latency_max () const
+{
+	return (uint32_t) g_atomic_int_get (&_locate_latency_max);
+}
+
+/** the statistics are reset by the process thread, with the next locate */
+void
+Session::reset_locate_latency ()
+{
+	g_atomic_int_set (&_locate_latency_reset, 1);
+}
+
 void
 Session::reset_rf_scale (framecnt_t motion)
 {
@@ -29,6 +29,24 @@
 
 #include <sys/stat.h>
 
+#ifdef __linux__
+#include <linux/falloc.h>
+#endif
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_SYS_VFS_H
+#include <sys/vfs.h>
+#endif
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 
@@ -51,6 +69,7 @@ using std::string;
 gain_t* SndFileSource::out_coefficient = 0;
 gain_t* SndFileSource::in_coefficient = 0;
 framecnt_t SndFileSource::xfade_frames = 64;
+bool SndFileSource::_use_mmap = true;
 const Source::Flag SndFileSource::default_writable_flags = Source::Flag (
 		Source::Writable |
 		Source::Removable |
@@ -62,6 +81,13 @@ SndFileSource::SndFileSource (Session& s, const XMLNode& node)
 	, AudioFileSource (s, node)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _preallocated (0)
+	, _map_state (MapUnknown)
+	, _map (0)
+	, _map_length (0)
+	, _map_data (0)
+	, _map_advised (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -86,6 +112,13 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn, Flag flag
 	, AudioFileSource (s, path, Flag (flags & ~(Writable|Removable|RemovableIfEmpty|RemoveAtDestroy)))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _preallocated (0)
+	, _map_state (MapUnknown)
+	, _map (0)
+	, _map_length (0)
+	, _map_data (0)
+	, _map_advised (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -112,6 +145,13 @@ SndFileSource::SndFileSource (Session& s, const string& path, const string& orig
 	, AudioFileSource (s, path, origin, flags, sfmt, hf)
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _preallocated (0)
+	, _map_state (MapUnknown)
+	, _map (0)
+	, _map_length (0)
+	, _map_data (0)
+	, _map_advised (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -215,6 +255,13 @@ SndFileSource::SndFileSource (Session& s, const string& path, int chn)
 	, AudioFileSource (s, path, Flag (0))
 	, _sndfile (0)
 	, _broadcast_info (0)
+	, _fd (-1)
+	, _preallocated (0)
+	, _map_state (MapUnknown)
+	, _map (0)
+	, _map_length (0)
+	, _map_data (0)
+	, _map_advised (0)
 	, _capture_start (false)
 	, _capture_end (false)
 	, file_pos (0)
@@ -253,8 +300,12 @@ void
 SndFileSource::close ()
 {
 	if (_sndfile) {
+		drop_mmap ();
+		release_preallocation ();
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_fd = -1;
+		_preallocated = 0;
 		file_closed ();
 	}
 }
@@ -286,6 +337,10 @@ SndFileSource::open ()
 	}
 
 	_sndfile = sf_open_fd (fd, writable() ? SFM_RDWR : SFM_READ, &_info, true);
+	/* libsndfile owns (and closes) the descriptor, we only keep it
+	 * around to reserve disk-space when capturing, see preallocate()
+	 */
+	_fd = _sndfile ? fd : -1;
 
 	if (_sndfile == 0) {
 		char errbuf[1024];
@@ -309,6 +364,7 @@ SndFileSource::open ()
 #endif
 		sf_close (_sndfile);
 		_sndfile = 0;
+		_fd = -1;
 		return -1;
 	}
 
@@ -445,6 +501,17 @@ SndFileSource::read_unlocked (Sample *dst, framepos_t start, framecnt_t cnt) con
 		memset (dst+file_cnt, 0, sizeof (Sample) * delta);
 	}
 
+	if (file_cnt && _use_mmap && !writable()) {
+
+		if (_map_state == MapUnknown) {
+			setup_mmap ();
+		}
+
+		if (_map_state == Mapped && read_mapped (dst, start, file_cnt)) {
+			return file_cnt;
+		}
+	}
+
 	if (file_cnt) {
 
 		if (sf_seek (_sndfile, (sf_count_t) start, SEEK_SET|SFM_READ) != (sf_count_t) start) {
@@ -513,6 +580,8 @@ SndFileSource::nondestructive_write_unlocked (Sample *data, framecnt_t cnt)
 
 	framepos_t frame_pos = _length;
 
+	preallocate (frame_pos + cnt);
+
 	if (write_float (data, frame_pos, cnt) != cnt) {
 		return 0;
 	}
@@ -520,7 +589,7 @@ SndFileSource::nondestructive_write_unlocked (Sample *data, framecnt_t cnt)
 	update_length (_length + cnt);
 
 	if (_build_peakfiles) {
-		compute_and_write_peaks (data, frame_pos, cnt, true, true);
+		compute_and_write_live_peaks (data, frame_pos, cnt);
 	}
 
 	return cnt;
@@ -607,7 +676,7 @@ SndFileSource::destructive_write_unlocked (Sample* data, framecnt_t cnt)
 	update_length (file_pos + cnt);
 
 	if (_build_peakfiles) {
-		compute_and_write_peaks (data, file_pos, cnt, true, true);
+		compute_and_write_live_peaks (data, file_pos, cnt);
 	}
 
 	file_pos += cnt;
@@ -664,6 +733,17 @@ SndFileSource::flush ()
 	sf_write_sync (_sndfile);
 }
 
+void
+SndFileSource::mark_streaming_write_completed (const Lock& lock)
+{
+	AudioFileSource::mark_streaming_write_completed (lock);
+
+	/* the take is over and nothing more will be appended, but the file
+	 * may stay open for a long time (until the session is closed).
+	 */
+	release_preallocation ();
+}
+
 int
 SndFileSource::setup_broadcast_info (framepos_t /*when*/, struct tm& now, time_t /*tnow*/)
 {
@@ -711,6 +791,399 @@ SndFileSource::set_header_timeline_position ()
 	}
 }
 
+/** size in bytes of a single sample on disk (uncompressed formats only) */
+static size_t
+sample_bytes_on_disk (int format)
+{
+	switch (format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+		return 1;
+	case SF_FORMAT_PCM_16:
+		return 2;
+	case SF_FORMAT_PCM_24:
+		return 3;
+	case SF_FORMAT_DOUBLE:
+		return 8;
+	default:
+		return 4;
+	}
+}
+
+/** Reserve disk space for the file to grow to at least @a end frames.
+ *
+ * Appending small blocks to dozens of files at once badly fragments them.
+ * While capturing, extents are allocated well ahead of the write position
+ * in large steps instead. The file-size is not changed (libsndfile is
+ * oblivious to this); any space that was not used is released when the
+ * take ends (mark_streaming_write_completed()) or in close().
+ */
+void
+SndFileSource::preallocate (framepos_t end)
+{
+#if defined __linux__ && defined FALLOC_FL_KEEP_SIZE
+	if (_fd < 0 || end <= _preallocated) {
+		return;
+	}
+
+	/* 1M frames: ~11 sec at 96kHz, 4MB for 32bit float */
+	const framecnt_t step = 1048576;
+	const size_t bps = sample_bytes_on_disk (_info.format);
+	const framepos_t reserve = ((end / step) + 1) * step;
+
+	/* the header is not accounted for, allow for a generous one */
+	if (fallocate (_fd, FALLOC_FL_KEEP_SIZE, 0, (off_t) (65536 + reserve * bps)) != 0) {
+		if (_preallocated == 0) {
+			/* not supported by the filesystem, don't try again */
+			_fd = -1;
+		}
+		return;
+	}
+
+	_preallocated = reserve;
+#else
+	(void) end;
+#endif
+}
+
+void
+SndFileSource::release_preallocation ()
+{
+#if defined __linux__ && defined FALLOC_FL_PUNCH_HOLE
+	if (_fd < 0 || _preallocated == 0) {
+		return;
+	}
+
+	struct stat st;
+	if (fstat (_fd, &st) == 0) {
+		const off_t reserved = 65536 + _preallocated * sample_bytes_on_disk (_info.format);
+		if (reserved > st.st_size) {
+			fallocate (_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, st.st_size, reserved - st.st_size);
+		}
+	}
+	_preallocated = 0;
+#endif
+}
+
+#if !defined PLATFORM_WINDOWS && defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+static uint32_t
+read_le32 (unsigned char const* p)
+{
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/** @return the file-position of the sample-data of a RIFF, RF64 or W64
+ * file, found by walking the chunks of its header, or -1.
+ */
+static off_t
+riff_data_offset (int fd, int major_format)
+{
+	unsigned char hdr[40];
+
+	if (pread (fd, hdr, sizeof (hdr), 0) != sizeof (hdr)) {
+		return -1;
+	}
+
+	if (major_format == SF_FORMAT_W64) {
+
+		/* chunks start with a 16 byte GUID, the first four bytes of
+		 * which are the ASCII name, followed by a 64 bit size that
+		 * includes the 24 byte chunk header. Chunks are aligned to 8
+		 * bytes.
+		 */
+
+		if (memcmp (hdr, "riff", 4) || memcmp (hdr + 24, "wave", 4)) {
+			return -1;
+		}
+
+		off_t pos = 40;
+
+		while (pread (fd, hdr, 24, pos) == 24) {
+			if (!memcmp (hdr, "data", 4)) {
+				return pos + 24;
+			}
+			const uint64_t size = (uint64_t) read_le32 (hdr + 16) | ((uint64_t) read_le32 (hdr + 20) << 32);
+			if (size < 24) {
+				return -1;
+			}
+			pos += (size + 7) & ~((uint64_t) 7);
+		}
+
+		return -1;
+	}
+
+	/* RIFF and RF64: 4 byte names and 32 bit sizes, chunks are padded to
+	 * an even size. The size of an RF64 data chunk is in its ds64 chunk,
+	 * but we stop at the data chunk anyway.
+	 */
+
+	if ((memcmp (hdr, "RIFF", 4) && memcmp (hdr, "RF64", 4)) || memcmp (hdr + 8, "WAVE", 4)) {
+		return -1;
+	}
+
+	off_t pos = 12;
+
+	while (pread (fd, hdr, 8, pos) == 8) {
+		if (!memcmp (hdr, "data", 4)) {
+			return pos + 8;
+		}
+		const uint32_t size = read_le32 (hdr + 4);
+		pos += 8 + (off_t) size + (size & 1);
+	}
+
+	return -1;
+}
+
+/** @return true if @a fd refers to a file on a local filesystem. Files on
+ * network (and FUSE) filesystems can be truncated by other hosts, and
+ * accessing a mapping beyond the end of the file raises SIGBUS.
+ */
+static bool
+on_local_filesystem (int fd)
+{
+#if defined __linux__ && defined HAVE_SYS_VFS_H
+	static const unsigned long remote[] = {
+		0x6969,     /* NFS */
+		0x517b,     /* SMB */
+		0xff534d42, /* CIFS */
+		0xfe534d42, /* SMB2 */
+		0x65735546, /* FUSE */
+		0x73757245, /* CODA */
+		0x5346414f, /* AFS */
+		0x00c36400, /* CEPH */
+		0x01021997, /* 9P */
+	};
+
+	struct statfs sfs;
+
+	if (fstatfs (fd, &sfs) != 0) {
+		return false;
+	}
+
+	for (size_t n = 0; n < sizeof (remote) / sizeof (remote[0]); ++n) {
+		if ((unsigned long) sfs.f_type == remote[n]) {
+			return false;
+		}
+	}
+
+	return true;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+	struct statfs sfs;
+	return fstatfs (fd, &sfs) == 0 && (sfs.f_flags & MNT_LOCAL);
+#else
+	(void) fd;
+	return false;
+#endif
+}
+
+#endif
+
+/** Map files that will not be modified anymore into memory, if the
+ * sample-data can be used directly: little-endian float, 16 or 24 bit
+ * PCM in a RIFF-style container (which is what Ardour itself writes).
+ * Reads are then a (converting) copy from the page-cache instead of a
+ * read(2) into libsndfile's buffer followed by a conversion.
+ *
+ * Only files on local filesystems are mapped, see read_mapped() for
+ * files that are truncated nevertheless.
+ */
+void
+SndFileSource::setup_mmap () const
+{
+	_map_state = MapUnsupported;
+
+#if !defined PLATFORM_WINDOWS && defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if (!_sndfile || _fd < 0 || sizeof (void*) < 8) {
+		/* don't exhaust the address-space of 32bit systems */
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+	case SF_FORMAT_WAV:
+	case SF_FORMAT_WAVEX:
+	case SF_FORMAT_W64:
+#ifdef HAVE_RF64_RIFF
+	case SF_FORMAT_RF64:
+#endif
+		break;
+	default:
+		return;
+	}
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_FLOAT:
+	case SF_FORMAT_PCM_16:
+	case SF_FORMAT_PCM_24:
+		break;
+	default:
+		return;
+	}
+
+	if ((_info.format & SF_FORMAT_ENDMASK) == SF_ENDIAN_BIG || _length == 0) {
+		return;
+	}
+
+	if (!on_local_filesystem (_fd)) {
+		return;
+	}
+
+	const off_t data_offset = riff_data_offset (_fd, _info.format & SF_FORMAT_TYPEMASK);
+	const size_t data_length = _length * _info.channels * sample_bytes_on_disk (_info.format);
+
+	struct stat st;
+	if (data_offset <= 0 || fstat (_fd, &st) != 0 || (off_t) (data_offset + data_length) > st.st_size) {
+		return;
+	}
+
+	void* addr = mmap (0, st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+	if (addr == MAP_FAILED) {
+		return;
+	}
+
+	_map = (char*) addr;
+	_map_length = st.st_size;
+	_map_data = _map + data_offset;
+	_map_advised = 0;
+
+	/* sanity check: the mapping must decode to what libsndfile reads,
+	 * at the start and at the end of the data (where a wrong offset
+	 * shows even if the file starts with silence).
+	 */
+	const framecnt_t n_check = std::min (_length, (framecnt_t) 256);
+	const framepos_t check_pos[2] = { 0, _length - n_check };
+	Sample mapped[256];
+	Sample* ref = get_interleave_buffer (n_check * _info.channels);
+	bool match = true;
+
+	for (int c = 0; match && c < 2; ++c) {
+
+		match = read_mapped (mapped, check_pos[c], n_check)
+			&& sf_seek (_sndfile, check_pos[c], SEEK_SET|SFM_READ) == check_pos[c]
+			&& sf_readf_float (_sndfile, ref, n_check) == n_check;
+
+		for (framecnt_t n = 0; match && n < n_check; ++n) {
+			match = mapped[n] == ref[n * _info.channels + _channel];
+		}
+	}
+
+	if (!match) {
+		if (_map) {
+			munmap (_map, _map_length);
+		}
+		_map = 0;
+		_map_length = 0;
+		_map_data = 0;
+		_map_state = MapUnsupported;
+		return;
+	}
+
+	_map_state = Mapped;
+#endif
+}
+
+void
+SndFileSource::drop_mmap ()
+{
+#ifndef PLATFORM_WINDOWS
+	if (_map) {
+		munmap (_map, _map_length);
+	}
+#endif
+	_map = 0;
+	_map_length = 0;
+	_map_data = 0;
+	_map_advised = 0;
+	_map_state = MapUnknown;
+}
+
+/** Convert @a cnt frames starting at @a start from the memory-mapped file.
+ * The loops are simple enough for the compiler to vectorize them for
+ * the mono case.
+ *
+ * @return false if the file has been truncated since it was mapped. The
+ * mapping is dropped then, and the caller has to read via libsndfile.
+ */
+bool
+SndFileSource::read_mapped (Sample* dst, framepos_t start, framecnt_t cnt) const
+{
+	const uint32_t nchn = _info.channels;
+	const size_t frame_bytes = nchn * sample_bytes_on_disk (_info.format);
+	const size_t read_end = (_map_data - _map) + (start + cnt) * frame_bytes;
+
+#ifndef PLATFORM_WINDOWS
+	/* touching pages beyond the end of the file raises SIGBUS; one
+	 * fstat(2) per read is cheap compared to the copy.
+	 */
+	struct stat st;
+
+	if (fstat (_fd, &st) != 0 || (off_t) read_end > st.st_size) {
+		munmap (_map, _map_length);
+		_map = 0;
+		_map_length = 0;
+		_map_data = 0;
+		_map_state = MapUnsupported;
+		return false;
+	}
+#endif
+
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+	case SF_FORMAT_FLOAT:
+		{
+			const char* src = _map_data + (start * nchn + _channel) * sizeof (float);
+			if (nchn == 1) {
+				memcpy (dst, src, cnt * sizeof (float));
+			} else {
+				for (framecnt_t n = 0; n < cnt; ++n, src += nchn * sizeof (float)) {
+					memcpy (&dst[n], src, sizeof (float));
+				}
+			}
+		}
+		break;
+	case SF_FORMAT_PCM_16:
+		{
+			const char* src = _map_data + (start * nchn + _channel) * 2;
+			for (framecnt_t n = 0; n < cnt; ++n, src += nchn * 2) {
+				int16_t v;
+				memcpy (&v, src, 2);
+				dst[n] = v * (1.f / 32768.f);
+			}
+		}
+		break;
+	case SF_FORMAT_PCM_24:
+		{
+			const unsigned char* src = (const unsigned char*) _map_data + (start * nchn + _channel) * 3;
+			for (framecnt_t n = 0; n < cnt; ++n, src += nchn * 3) {
+				const int32_t v = (int32_t) (((uint32_t) src[0] << 8) | ((uint32_t) src[1] << 16) | ((uint32_t) src[2] << 24));
+				dst[n] = v * (1.f / 2147483648.f);
+			}
+		}
+		break;
+	default:
+		assert (0);
+		break;
+	}
+
+#ifndef PLATFORM_WINDOWS
+	/* reads are sequential (butler, export); keep the kernel reading
+	 * a window ahead of them. The window is renewed when less than
+	 * half of it is left, or after a seek backwards.
+	 */
+	const size_t page = 4096;
+	const size_t window = std::max ((size_t) 1048576, 4 * cnt * frame_bytes);
+
+	if (_map_advised < read_end + window / 2 || _map_advised > read_end + window) {
+		const size_t from = read_end & ~(page - 1);
+		if (from < _map_length) {
+			madvise (_map + from, std::min (window, _map_length - from), MADV_WILLNEED);
+		}
+		_map_advised = from + window;
+	}
+#endif
+
+	return true;
+}
+
 framecnt_t
 SndFileSource::write_float (Sample* data, framepos_t frame_pos, framecnt_t cnt)
 {
@@ -116,4 +116,62 @@ x86_sse_avx_find_peaks(const float* buf, uint32_t nframes, float *min, float *ma
 	_mm256_zeroupper ();
 }
 
+/* see x86_sse_mix_buffers_with_fade() */
+template<bool with_lower, bool with_envelope>
+static void
+avx_mix_with_fade (float* dst, const float* src, const float* fade, const float* lower, const float* envelope, uint32_t nframes, float gain)
+{
+	const __m256 g = _mm256_set1_ps (gain);
+
+	while (nframes >= 8) {
+		__m256 s = _mm256_loadu_ps (src);
+		__m256 d = _mm256_loadu_ps (dst);
+
+		if (with_envelope) {
+			s = _mm256_mul_ps (s, _mm256_mul_ps (_mm256_loadu_ps (envelope), g));
+			envelope += 8;
+		} else {
+			s = _mm256_mul_ps (s, g);
+		}
+
+		s = _mm256_mul_ps (s, _mm256_loadu_ps (fade));
 
+		if (with_lower) {
+			d = _mm256_mul_ps (d, _mm256_loadu_ps (lower));
+			lower += 8;
+		}
+
+		_mm256_storeu_ps (dst, _mm256_add_ps (d, s));
+
+		dst += 8;
+		src += 8;
+		fade += 8;
+		nframes -= 8;
+	}
+
+	// zero upper 128 bit of 256 bit ymm register to avoid penalties using non-AVX instructions
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		float s = with_envelope ? *src * (*envelope++ * gain) : *src * gain;
+		*dst = (with_lower ? *dst * *lower++ : *dst) + s * *fade;
+		++dst;
+		++src;
+		++fade;
+		--nframes;
+	}
+}
+
+void
+x86_sse_avx_mix_buffers_with_fade (float* dst, const float* src, const float* fade, const float* lower, const float* envelope, uint32_t nframes, float gain)
+{
+	if (lower && envelope) {
+		avx_mix_with_fade<true, true> (dst, src, fade, lower, envelope, nframes, gain);
+	} else if (lower) {
+		avx_mix_with_fade<true, false> (dst, src, fade, lower, envelope, nframes, gain);
+	} else if (envelope) {
+		avx_mix_with_fade<false, true> (dst, src, fade, lower, envelope, nframes, gain);
+	} else {
+		avx_mix_with_fade<false, false> (dst, src, fade, lower, envelope, nframes, gain);
+	}
+}
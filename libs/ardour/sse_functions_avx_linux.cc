@@ -49,6 +49,12 @@ x86_sse_avx_copy_vector (float * dst, const float * src, uint32_t nframes)
 	default_copy_vector (dst, src, nframes);
 }
 
+void
+x86_sse_avx_mix_buffers_with_fade (float * dst, const float * src, const float * fade, const float * lower, const float * envelope, uint32_t nframes, float gain)
+{
+	default_mix_buffers_with_fade (dst, src, fade, lower, envelope, nframes, gain);
+}
+
 void
 x86_sse_avx_find_peaks (const float * buf, uint32_t nsamples, float *min, float *max)
 {
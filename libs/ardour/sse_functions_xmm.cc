@@ -115,5 +115,62 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 	_mm_store_ss(max, work);
 }
 
+/* dst = dst * lower + src * (envelope * gain) * fade, with the
+ * variants selected at compile time. The buffers are parts of
+ * playlist read buffers at arbitrary offsets, so no alignment is assumed.
+ */
+template<bool with_lower, bool with_envelope>
+static void
+sse_mix_with_fade (float* dst, const float* src, const float* fade, const float* lower, const float* envelope, uint32_t nframes, float gain)
+{
+	const __m128 g = _mm_set1_ps (gain);
+
+	while (nframes >= 4) {
+		__m128 s = _mm_loadu_ps (src);
+		__m128 d = _mm_loadu_ps (dst);
+
+		if (with_envelope) {
+			s = _mm_mul_ps (s, _mm_mul_ps (_mm_loadu_ps (envelope), g));
+			envelope += 4;
+		} else {
+			s = _mm_mul_ps (s, g);
+		}
 
+		s = _mm_mul_ps (s, _mm_loadu_ps (fade));
+
+		if (with_lower) {
+			d = _mm_mul_ps (d, _mm_loadu_ps (lower));
+			lower += 4;
+		}
+
+		_mm_storeu_ps (dst, _mm_add_ps (d, s));
+
+		dst += 4;
+		src += 4;
+		fade += 4;
+		nframes -= 4;
+	}
 
+	while (nframes > 0) {
+		float s = with_envelope ? *src * (*envelope++ * gain) : *src * gain;
+		*dst = (with_lower ? *dst * *lower++ : *dst) + s * *fade;
+		++dst;
+		++src;
+		++fade;
+		--nframes;
+	}
+}
+
+void
+x86_sse_mix_buffers_with_fade (float* dst, const float* src, const float* fade, const float* lower, const float* envelope, uint32_t nframes, float gain)
+{
+	if (lower && envelope) {
+		sse_mix_with_fade<true, true> (dst, src, fade, lower, envelope, nframes, gain);
+	} else if (lower) {
+		sse_mix_with_fade<true, false> (dst, src, fade, lower, envelope, nframes, gain);
+	} else if (envelope) {
+		sse_mix_with_fade<false, true> (dst, src, fade, lower, envelope, nframes, gain);
+	} else {
+		sse_mix_with_fade<false, false> (dst, src, fade, lower, envelope, nframes, gain);
+	}
+}
@@ -0,0 +1,93 @@
+#include "ardour/audio_diskstream.h"
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "adaptive_buffering_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AdaptiveBufferingTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/** Overlapping regions must count once, and only within the range asked for */
+void
+AdaptiveBufferingTest::coveredLengthTest ()
+{
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (0), _playlist->covered_length (0, 1000));
+
+	/* _r[] are 100 frames long */
+	_playlist->add_region (_r[0], 0);
+	_playlist->add_region (_r[1], 50);
+	_playlist->add_region (_r[2], 60);
+	_playlist->add_region (_r[3], 400);
+
+	/* [0, 160) and [400, 500) */
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (260), _playlist->covered_length (0, 1000));
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (110), _playlist->covered_length (100, 450));
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (0), _playlist->covered_length (200, 400));
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (10), _playlist->covered_length (490, 2000));
+
+	/* a region inside another one adds nothing */
+	_playlist->add_region (_r[4], 20);
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (260), _playlist->covered_length (0, 1000));
+}
+
+/** The rate is frames read per frame rolled over all runs in the window */
+void
+AdaptiveBufferingTest::readRateTest ()
+{
+	AudioDiskstream::ReadWindow w;
+
+	CPPUNIT_ASSERT_EQUAL (0.0, w.rate ());
+
+	/* normal speed */
+	w.add (48000, 48000, 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, w.rate (), 1e-9);
+
+	/* twice the speed for the same time */
+	w.add (96000, 48000, 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.5, w.rate (), 1e-9);
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (144000), w.read ());
+
+	/* a track that was rolled but never needed a refill */
+	AudioDiskstream::ReadWindow idle;
+	idle.add (0, 48000, 0);
+	CPPUNIT_ASSERT_EQUAL (0.0, idle.rate ());
+}
+
+/** The density is weighted by the time spent rolling */
+void
+AdaptiveBufferingTest::readDensityTest ()
+{
+	AudioDiskstream::ReadWindow w;
+
+	CPPUNIT_ASSERT_EQUAL (0.0, w.density ());
+
+	w.add (1000, 3000, 1.0);
+	w.add (1000, 1000, 0.0);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.75, w.density (), 1e-9);
+}
+
+/** Only the last ReadWindow::size runs count */
+void
+AdaptiveBufferingTest::windowTest ()
+{
+	AudioDiskstream::ReadWindow w;
+
+	w.add (4000, 1000, 1.0);
+
+	for (uint32_t n = 0; n < AudioDiskstream::ReadWindow::size - 1; ++n) {
+		w.add (1000, 1000, 0.5);
+	}
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (7.0 / 4, w.rate (), 1e-9);
+
+	/* this pushes out the first run */
+	w.add (1000, 1000, 0.5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, w.rate (), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5, w.density (), 1e-9);
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (4000), w.read ());
+
+	w.clear ();
+	CPPUNIT_ASSERT_EQUAL (0.0, w.rate ());
+	CPPUNIT_ASSERT_EQUAL (framecnt_t (0), w.read ());
+}
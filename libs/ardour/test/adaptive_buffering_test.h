@@ -0,0 +1,17 @@
+#include "audio_region_test.h"
+
+class AdaptiveBufferingTest : public AudioRegionTest
+{
+	CPPUNIT_TEST_SUITE (AdaptiveBufferingTest);
+	CPPUNIT_TEST (coveredLengthTest);
+	CPPUNIT_TEST (readRateTest);
+	CPPUNIT_TEST (readDensityTest);
+	CPPUNIT_TEST (windowTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void coveredLengthTest ();
+	void readRateTest ();
+	void readDensityTest ();
+	void windowTest ();
+};
@@ -0,0 +1,182 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <vector>
+
+#include "ardour/audio_diskstream.h"
+#include "ardour/audio_track.h"
+#include "ardour/audiofilesource.h"
+#include "ardour/butler.h"
+#include "ardour/playlist.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/region_factory.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+#include "ardour/source_factory.h"
+
+#include "audio_diskstream_seek_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AudioDiskstreamSeekTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+void
+AudioDiskstreamSeekTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	/* locate requests are session events, queued from this thread */
+	if (!SessionEvent::has_per_thread_pool ()) {
+		SessionEvent::create_per_thread_pool ("seek test", 64);
+	}
+
+	_located = false;
+	_session->Located.connect_same_thread (_located_connection, boost::bind (&AudioDiskstreamSeekTest::located, this));
+}
+
+void
+AudioDiskstreamSeekTest::tearDown ()
+{
+	_located_connection.disconnect ();
+	TestNeedingSession::tearDown ();
+}
+
+void
+AudioDiskstreamSeekTest::located ()
+{
+	/* called from the process thread, once the butler has been told to locate the tracks */
+	Glib::Threads::Mutex::Lock lm (_located_lock);
+	_located = true;
+	_located_cond.signal ();
+}
+
+/** Locate the way the transport does: the process thread handles the request,
+ *  and the butler moves the tracks. Returns once the butler is done.
+ */
+void
+AudioDiskstreamSeekTest::locate (framepos_t pos)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_located_lock);
+		_located = false;
+		_session->request_locate (pos, false);
+		while (!_located) {
+			_located_cond.wait (_located_lock);
+		}
+	}
+
+	_session->butler()->wait_until_finished ();
+	CPPUNIT_ASSERT_EQUAL (pos, _session->transport_frame ());
+}
+
+void
+AudioDiskstreamSeekTest::bufferedSeekTest ()
+{
+	const framecnt_t sr = _session->frame_rate ();
+	const framecnt_t len = 30 * sr;
+
+	/* a ramp, so that every sample tells where it was read from */
+	boost::shared_ptr<AudioFileSource> src = boost::dynamic_pointer_cast<AudioFileSource> (
+		SourceFactory::createWritable (DataType::AUDIO, *_session, "seek.wav", false, sr));
+	CPPUNIT_ASSERT (src);
+
+	vector<Sample> ramp (len);
+	for (framecnt_t i = 0; i < len; ++i) {
+		ramp[i] = (float) i / len;
+	}
+	src->write (&ramp[0], len);
+	{
+		Source::Lock lm (src->mutex ());
+		src->mark_streaming_write_completed (lm);
+	}
+
+	list<boost::shared_ptr<AudioTrack> > tracks = _session->new_audio_track (1, 2, 0, 1, "seek", PresentationInfo::max_order);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, tracks.size ());
+	boost::shared_ptr<AudioTrack> track = tracks.front ();
+	boost::shared_ptr<AudioDiskstream> ds = track->audio_diskstream ();
+
+	PropertyList plist;
+	plist.add (Properties::start, 0);
+	plist.add (Properties::length, len);
+	track->playlist ()->add_region (RegionFactory::create (boost::dynamic_pointer_cast<Source> (src), plist), 0);
+
+	const float history = Config->get_audio_playback_history_seconds ();
+	Config->set_audio_playback_history_seconds (1.0);
+
+	/* let the butler pick up the new region, whatever it had buffered before */
+	locate (sr);
+
+	AudioDiskstream::reset_seek_stats ();
+
+	/* the first locate has to fill the buffers from scratch */
+	locate (10 * sr);
+	AudioDiskstream::SeekStats s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, s.seeks);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, s.buffered);
+
+	/* a short jump forward lands in what is already buffered */
+	locate (10 * sr + sr / 2);
+	s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.seeks);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, s.buffered);
+
+	/* jumping back lands in what was skipped over, which is kept as history */
+	const framepos_t back = 10 * sr + sr / 4;
+	const framecnt_t cnt = sr / 10;
+
+	locate (back);
+	s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 3, s.seeks);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.buffered);
+
+	vector<Sample> from_history (cnt);
+	CPPUNIT_ASSERT_EQUAL (cnt, ds->peek_playback_buffer (&from_history[0], cnt));
+
+	/* nothing far ahead was ever buffered */
+	locate (20 * sr);
+	s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 4, s.seeks);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.buffered);
+
+	/* and what is before the buffered range has to be read again */
+	locate (back);
+	s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 5, s.seeks);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.buffered);
+	CPPUNIT_ASSERT (s.max_usecs >= 0);
+
+	vector<Sample> cold (cnt);
+	CPPUNIT_ASSERT_EQUAL (cnt, ds->peek_playback_buffer (&cold[0], cnt));
+
+	/* the retained history holds exactly what a fresh read returns */
+	for (framecnt_t i = 0; i < cnt; ++i) {
+		CPPUNIT_ASSERT_EQUAL (cold[i], from_history[i]);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (ramp[back], cold[0], 1e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (ramp[back + cnt - 1], cold[cnt - 1], 1e-6);
+
+	/* without retained history, buffers are always refilled */
+	Config->set_audio_playback_history_seconds (0);
+	locate (back + sr / 10);
+	s = AudioDiskstream::seek_stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, s.buffered);
+
+	Config->set_audio_playback_history_seconds (history);
+}
@@ -0,0 +1,46 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <glibmm/threads.h>
+
+#include "pbd/signals.h"
+#include "ardour/types.h"
+
+#include "test_needing_session.h"
+
+class AudioDiskstreamSeekTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (AudioDiskstreamSeekTest);
+	CPPUNIT_TEST (bufferedSeekTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void bufferedSeekTest ();
+
+private:
+	void locate (ARDOUR::framepos_t);
+	void located ();
+
+	Glib::Threads::Mutex _located_lock;
+	Glib::Threads::Cond _located_cond;
+	bool _located;
+	PBD::ScopedConnection _located_connection;
+};
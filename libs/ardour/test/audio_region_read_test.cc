@@ -81,6 +81,34 @@ AudioRegionReadTest::readTest ()
 
 	_ar[0]->read_at (buf, mbuf, gbuf, P + 128, 256, 0);
 	check_staircase (buf, 128, 256);
+
+	/* Reads which start within the fade in must see the same fade as one read of the whole fade */
+
+	for (int i = 0; i < N; ++i) {
+		buf[i] = 0;
+	}
+
+	_ar[0]->read_at (buf, mbuf, gbuf, P, 20, 0);
+	_ar[0]->read_at (buf + 20, mbuf, gbuf, P + 20, 236, 0);
+	for (int i = 0; i < 64; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (float (i * i / 63.0), buf[i], 1e-4);
+	}
+	for (int i = 64; i < P; ++i) {
+		CPPUNIT_ASSERT_EQUAL (i, int (buf[i]));
+	}
+
+	/* A changed fade must be used by the next read */
+
+	_ar[0]->set_fade_in_length (128);
+
+	for (int i = 0; i < N; ++i) {
+		buf[i] = 0;
+	}
+
+	_ar[0]->read_at (buf, mbuf, gbuf, P, 256, 0);
+	for (int i = 0; i < 128; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (float (i * i / 127.0), buf[i], 1e-3);
+	}
 }
 
 void
@@ -0,0 +1,144 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <glibmm/miscutils.h>
+
+#include "ardour/audiosource.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/source_factory.h"
+#include "audio_source_peaks_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AudioSourcePeaksTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const framecnt_t length = 64 * 1024;
+static const framecnt_t fpp = 256;
+
+boost::shared_ptr<AudioSource>
+AudioSourcePeaksTest::create_source (string const & name)
+{
+	string const path = Glib::build_filename (new_test_output_dir ("audio_source_peaks"), name);
+	boost::shared_ptr<AudioSource> src = boost::dynamic_pointer_cast<AudioSource> (
+		SourceFactory::createWritable (DataType::AUDIO, *_session, path, false, get_test_sample_rate ()));
+	CPPUNIT_ASSERT (src);
+	return src;
+}
+
+/** write a ramp in odd-sized chunks, as capture would */
+void
+AudioSourcePeaksTest::write (boost::shared_ptr<AudioSource> src)
+{
+	Sample buf[1000];
+	framecnt_t done = 0;
+
+	while (done < length) {
+		const framecnt_t cnt = min ((framecnt_t) 1000, length - done);
+		for (framecnt_t i = 0; i < cnt; ++i) {
+			buf[i] = (done + i) / (float) length;
+		}
+		CPPUNIT_ASSERT_EQUAL (cnt, src->write (buf, cnt));
+		done += cnt;
+	}
+}
+
+void
+AudioSourcePeaksTest::check_peaks (boost::shared_ptr<AudioSource> src)
+{
+	const framecnt_t npeaks = length / fpp;
+	PeakData peaks[npeaks];
+
+	CPPUNIT_ASSERT_EQUAL (0, src->read_peaks (peaks, npeaks, 0, length, fpp));
+
+	for (framecnt_t n = 0; n < npeaks; ++n) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL ((n * fpp) / (float) length, peaks[n].min, 1e-6);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL ((n * fpp + fpp - 1) / (float) length, peaks[n].max, 1e-6);
+	}
+}
+
+void
+AudioSourcePeaksTest::record (bool live)
+{
+	const bool was_live = Config->get_live_peaks_in_own_thread ();
+	const bool built = AudioSource::get_build_peakfiles ();
+
+	Config->set_live_peaks_in_own_thread (live);
+	AudioSource::set_build_peakfiles (true);
+
+	boost::shared_ptr<AudioSource> src = create_source (live ? "live.wav" : "record.wav");
+
+	/* as AudioDiskstream::use_new_write_source() does */
+	src->prepare_for_live_peaks ();
+
+	write (src);
+
+	{
+		/* as AudioDiskstream::reset_write_sources() does at the end of a take */
+		Source::Lock lm (src->mutex ());
+		src->mark_streaming_write_completed (lm);
+		src->done_with_peakfile_writes ();
+	}
+
+	check_peaks (src);
+
+	AudioSource::set_build_peakfiles (built);
+	Config->set_live_peaks_in_own_thread (was_live);
+}
+
+void
+AudioSourcePeaksTest::recordTest ()
+{
+	record (false);
+}
+
+void
+AudioSourcePeaksTest::liveRecordTest ()
+{
+	record (true);
+}
+
+void
+AudioSourcePeaksTest::buildTest ()
+{
+	const bool built = AudioSource::get_build_peakfiles ();
+	AudioSource::set_build_peakfiles (false);
+
+	boost::shared_ptr<AudioSource> src = create_source ("build.wav");
+
+	write (src);
+
+	{
+		Source::Lock lm (src->mutex ());
+		src->mark_streaming_write_completed (lm);
+	}
+
+	/* there is no peakfile yet, so this computes peaks from the data on
+	 * disk and finalizes the peakfile
+	 */
+	AudioSource::set_build_peakfiles (true);
+	AudioSource::set_build_missing_peakfiles (true);
+
+	CPPUNIT_ASSERT_EQUAL (0, src->setup_peakfile ());
+
+	check_peaks (src);
+
+	AudioSource::set_build_missing_peakfiles (false);
+	AudioSource::set_build_peakfiles (built);
+}
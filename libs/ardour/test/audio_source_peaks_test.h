@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <boost/shared_ptr.hpp>
+
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class AudioSource;
+}
+
+class AudioSourcePeaksTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (AudioSourcePeaksTest);
+	CPPUNIT_TEST (recordTest);
+	CPPUNIT_TEST (liveRecordTest);
+	CPPUNIT_TEST (buildTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void recordTest ();
+	void liveRecordTest ();
+	void buildTest ();
+
+private:
+	boost::shared_ptr<ARDOUR::AudioSource> create_source (std::string const &);
+	void write (boost::shared_ptr<ARDOUR::AudioSource>);
+	void check_peaks (boost::shared_ptr<ARDOUR::AudioSource>);
+	void record (bool live);
+};
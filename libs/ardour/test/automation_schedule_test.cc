@@ -0,0 +1,301 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <limits>
+
+#include <boost/bind.hpp>
+
+#include "ardour/automation_control.h"
+#include "ardour/automation_list.h"
+#include "ardour/automation_schedule.h"
+#include "automation_schedule_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AutomationScheduleTest);
+CPPUNIT_TEST_SUITE_REGISTRATION (AutomationScheduleRunTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static const double before_all = -numeric_limits<double>::max ();
+static const double after_all = numeric_limits<double>::max ();
+
+void
+AutomationScheduleTest::emptyTest ()
+{
+	AutomationList list (Evoral::Parameter (GainAutomation));
+	AutomationSchedule::Segment s;
+
+	AutomationSchedule::find_segment (list, 1000, s);
+
+	CPPUNIT_ASSERT_EQUAL (before_all, s.from);
+	CPPUNIT_ASSERT_EQUAL (after_all, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (list.default_value (), s.value);
+
+	/* a single point applies everywhere */
+
+	list.fast_simple_add (100, 0.5);
+
+	AutomationSchedule::find_segment (list, 0, s);
+	CPPUNIT_ASSERT_EQUAL (before_all, s.from);
+	CPPUNIT_ASSERT_EQUAL (100.0, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (0.5, s.value);
+
+	AutomationSchedule::find_segment (list, 100, s);
+	CPPUNIT_ASSERT_EQUAL (100.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (after_all, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (0.5, s.value);
+}
+
+void
+AutomationScheduleTest::linearTest ()
+{
+	AutomationList list (Evoral::Parameter (GainAutomation));
+	AutomationSchedule::Segment s;
+
+	list.set_interpolation (Evoral::ControlList::Linear);
+	list.fast_simple_add (100, 0.5);
+	list.fast_simple_add (200, 0.5);
+	list.fast_simple_add (300, 1.0);
+
+	AutomationSchedule::find_segment (list, 150, s);
+	CPPUNIT_ASSERT_EQUAL (100.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (0.5, s.value);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (list.eval (150), s.value, 1e-9);
+
+	/* a ramp */
+	AutomationSchedule::find_segment (list, 200, s);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (300.0, s.to);
+	CPPUNIT_ASSERT (!s.constant);
+
+	AutomationSchedule::find_segment (list, 299.5, s);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.from);
+	CPPUNIT_ASSERT (!s.constant);
+
+	AutomationSchedule::find_segment (list, 300, s);
+	CPPUNIT_ASSERT_EQUAL (300.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (after_all, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (1.0, s.value);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (list.eval (1000), s.value, 1e-9);
+}
+
+void
+AutomationScheduleTest::discreteTest ()
+{
+	AutomationList list (Evoral::Parameter (GainAutomation));
+	AutomationSchedule::Segment s;
+
+	list.set_interpolation (Evoral::ControlList::Discrete);
+	list.fast_simple_add (100, 0.0);
+	list.fast_simple_add (200, 1.0);
+	list.fast_simple_add (300, 0.0);
+
+	AutomationSchedule::find_segment (list, 199, s);
+	CPPUNIT_ASSERT_EQUAL (100.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (0.0, s.value);
+
+	AutomationSchedule::find_segment (list, 200, s);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (300.0, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (1.0, s.value);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (list.eval (250), s.value, 1e-9);
+}
+
+void
+AutomationScheduleTest::curvedTest ()
+{
+	AutomationList list (Evoral::Parameter (GainAutomation));
+	AutomationSchedule::Segment s;
+
+	list.set_interpolation (Evoral::ControlList::Curved);
+	list.fast_simple_add (100, 0.0);
+	list.fast_simple_add (200, 1.0);
+	list.fast_simple_add (300, 1.0);
+	list.fast_simple_add (400, 0.0);
+
+	/* equal values, but a curve may still go through other values */
+	AutomationSchedule::find_segment (list, 250, s);
+	CPPUNIT_ASSERT_EQUAL (200.0, s.from);
+	CPPUNIT_ASSERT_EQUAL (300.0, s.to);
+	CPPUNIT_ASSERT (!s.constant);
+
+	AutomationSchedule::find_segment (list, 50, s);
+	CPPUNIT_ASSERT_EQUAL (100.0, s.to);
+	CPPUNIT_ASSERT (s.constant);
+	CPPUNIT_ASSERT_EQUAL (0.0, s.value);
+}
+
+/** A control in automation playback, with a list that is 0.5 from 0 to
+ * 1000, ramps up to 1.0 at 2000 and stays there.
+ */
+struct PlaybackControl
+{
+	PlaybackControl (Session& s)
+		: sets (0)
+	{
+		const Evoral::Parameter param (GainAutomation);
+		boost::shared_ptr<AutomationList> list (new AutomationList (param));
+
+		list->set_interpolation (Evoral::ControlList::Linear);
+		list->fast_simple_add (0, 0.5);
+		list->fast_simple_add (1000, 0.5);
+		list->fast_simple_add (2000, 1.0);
+		list->set_automation_state (Play);
+
+		control.reset (new AutomationControl (s, param, ParameterDescriptor (param), list));
+		control->Changed.connect_same_thread (connection, boost::bind (&PlaybackControl::changed, this));
+
+		vector<boost::shared_ptr<AutomationControl> > controls;
+		controls.push_back (control);
+		schedule.set_controls (controls);
+	}
+
+	void changed () { ++sets; }
+
+	boost::shared_ptr<AutomationControl> control;
+	AutomationSchedule schedule;
+	PBD::ScopedConnection connection;
+	int sets;
+};
+
+void
+AutomationScheduleRunTest::runTest ()
+{
+	PlaybackControl pc (*_session);
+
+	/* a constant segment is set once */
+	for (double t = 0; t < 1000; t += 100) {
+		pc.schedule.run (t);
+	}
+
+	CPPUNIT_ASSERT_EQUAL (1, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5, pc.control->user_double (), 1e-6);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, pc.schedule.stats ().evaluations);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 9, pc.schedule.stats ().skipped);
+
+	/* a ramp is set every time */
+	pc.schedule.run (1500);
+	pc.schedule.run (1600);
+
+	CPPUNIT_ASSERT_EQUAL (3, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.8, pc.control->user_double (), 1e-6);
+
+	/* after the last point, once again */
+	pc.schedule.run (2000);
+	pc.schedule.run (3000);
+
+	CPPUNIT_ASSERT_EQUAL (4, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, pc.control->user_double (), 1e-6);
+
+	double when;
+	CPPUNIT_ASSERT (!pc.schedule.next_event (3000, 4000, when));
+	CPPUNIT_ASSERT (pc.schedule.next_event (100, 1100, when));
+	CPPUNIT_ASSERT_EQUAL (1000.0, when);
+}
+
+void
+AutomationScheduleRunTest::listChangedTest ()
+{
+	PlaybackControl pc (*_session);
+
+	pc.schedule.run (100);
+	pc.schedule.run (200);
+	CPPUNIT_ASSERT_EQUAL (1, pc.sets);
+
+	/* editing the list makes the schedule look at it again: [0, 1000)
+	 * is now a ramp from 0.5 to 0.25
+	 */
+	Evoral::ControlList::iterator i = pc.control->list ()->begin ();
+	++i;
+	pc.control->list ()->modify (i, 1000, 0.25);
+
+	pc.schedule.run (300);
+	CPPUNIT_ASSERT_EQUAL (2, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.425, pc.control->user_double (), 1e-6);
+
+	/* and so does changing the interpolation: [0, 1000) is 0.5 again */
+	pc.control->list ()->set_interpolation (Evoral::ControlList::Discrete);
+
+	pc.schedule.run (600);
+	pc.schedule.run (700);
+	CPPUNIT_ASSERT_EQUAL (3, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5, pc.control->user_double (), 1e-6);
+}
+
+void
+AutomationScheduleRunTest::invalidateTest ()
+{
+	PlaybackControl pc (*_session);
+
+	pc.schedule.run (100);
+	pc.schedule.invalidate ();
+	pc.schedule.run (200);
+	pc.schedule.run (300);
+
+	CPPUNIT_ASSERT_EQUAL (2, pc.sets);
+
+	/* leaving and re-entering playback sets the value again, too */
+	pc.control->alist ()->set_automation_state (Off);
+	pc.schedule.run (400);
+	pc.control->alist ()->set_automation_state (Play);
+	pc.schedule.run (500);
+
+	CPPUNIT_ASSERT_EQUAL (3, pc.sets);
+}
+
+void
+AutomationScheduleRunTest::frozenTest ()
+{
+	PlaybackControl pc (*_session);
+
+	pc.schedule.run (100);
+	CPPUNIT_ASSERT_EQUAL (1, pc.sets);
+
+	/* freezing a list alone does not change it */
+	pc.control->list ()->freeze ();
+
+	pc.schedule.run (200);
+	pc.schedule.run (300);
+	CPPUNIT_ASSERT_EQUAL (1, pc.sets);
+
+	/* but edits while it is frozen are picked up right away: [0, 1000)
+	 * is now a ramp from 0.5 to 0.25
+	 */
+	Evoral::ControlList::iterator i = pc.control->list ()->begin ();
+	++i;
+	pc.control->list ()->modify (i, 1000, 0.25);
+
+	pc.schedule.run (300);
+	CPPUNIT_ASSERT_EQUAL (2, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.425, pc.control->user_double (), 1e-6);
+
+	pc.control->list ()->thaw ();
+
+	pc.schedule.run (600);
+	CPPUNIT_ASSERT_EQUAL (3, pc.sets);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.35, pc.control->user_double (), 1e-6);
+}
@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "test_needing_session.h"
+
+class AutomationScheduleTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (AutomationScheduleTest);
+	CPPUNIT_TEST (emptyTest);
+	CPPUNIT_TEST (linearTest);
+	CPPUNIT_TEST (discreteTest);
+	CPPUNIT_TEST (curvedTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void emptyTest ();
+	void linearTest ();
+	void discreteTest ();
+	void curvedTest ();
+};
+
+class AutomationScheduleRunTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (AutomationScheduleRunTest);
+	CPPUNIT_TEST (runTest);
+	CPPUNIT_TEST (listChangedTest);
+	CPPUNIT_TEST (invalidateTest);
+	CPPUNIT_TEST (frozenTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void runTest ();
+	void listChangedTest ();
+	void invalidateTest ();
+	void frozenTest ();
+};
@@ -0,0 +1,123 @@
+#include "ardour/audio_diskstream.h"
+#include "ardour/audio_track.h"
+#include "ardour/butler.h"
+#include "ardour/midi_track.h"
+#include "ardour/session.h"
+#include "ardour/session_event.h"
+
+#include "butler_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ButlerTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+void
+ButlerTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	/* locate requests are session events, queued from this thread */
+	if (!SessionEvent::has_per_thread_pool ()) {
+		SessionEvent::create_per_thread_pool ("butler test", 64);
+	}
+
+	_located = false;
+	_session->Located.connect_same_thread (_located_connection, boost::bind (&ButlerTest::located, this));
+}
+
+void
+ButlerTest::tearDown ()
+{
+	_located_connection.disconnect ();
+	TestNeedingSession::tearDown ();
+}
+
+void
+ButlerTest::located ()
+{
+	Glib::Threads::Mutex::Lock lm (_located_lock);
+	_located = true;
+	_located_cond.signal ();
+}
+
+/** Locate through the session and wait until the butler has refilled
+ *  the tracks and paused.
+ */
+void
+ButlerTest::locate (framepos_t pos)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_located_lock);
+		_located = false;
+		_session->request_locate (pos, false);
+		while (!_located) {
+			_located_cond.wait (_located_lock);
+		}
+	}
+
+	_session->butler()->wait_until_finished ();
+}
+
+/** Refills are queued in order of the time left until each track's
+ *  playback buffer runs dry, MIDI tracks included.
+ */
+void
+ButlerTest::urgencyTest ()
+{
+	/* created in the opposite order of their urgency */
+	boost::shared_ptr<AudioTrack> large = _session->new_audio_track (1, 2, 0, 1, "large", PresentationInfo::max_order).front ();
+	boost::shared_ptr<AudioTrack> small = _session->new_audio_track (1, 2, 0, 1, "small", PresentationInfo::max_order).front ();
+	boost::shared_ptr<MidiTrack> midi = _session->new_midi_track (
+		ChanCount (DataType::MIDI, 1), ChanCount (DataType::MIDI, 1),
+		boost::shared_ptr<PluginInfo> (), 0, 0, 1, "midi", PresentationInfo::max_order).front ();
+
+	/* buffers are only resized while the butler is not using them */
+	_session->butler()->wait_until_finished ();
+
+	large->audio_diskstream()->set_playback_buffer_scale (2.0);
+	small->audio_diskstream()->set_playback_buffer_scale (0.1);
+	large->adjust_playback_buffering ();
+	small->adjust_playback_buffering ();
+
+	CPPUNIT_ASSERT (small->playback_buffer_size () < large->playback_buffer_size ());
+
+	/* fill all buffers from scratch */
+	locate (_session->frame_rate ());
+
+	const framecnt_t m = midi->playback_frames_buffered ();
+	const framecnt_t s = small->playback_frames_buffered ();
+	const framecnt_t l = large->playback_frames_buffered ();
+
+	/* MIDI reads ahead by less than even the smallest audio buffer */
+	CPPUNIT_ASSERT (m > 0);
+	CPPUNIT_ASSERT (m < s);
+	CPPUNIT_ASSERT (s < l);
+
+	Butler* butler = _session->butler ();
+	butler->queue_disk_work (_session->get_routes ());
+
+	vector<boost::shared_ptr<Track> > order;
+	vector<framecnt_t> deadlines;
+
+	for (vector<Butler::DiskWork>::const_iterator i = butler->_disk_work.begin(); i != butler->_disk_work.end(); ++i) {
+		if (i->type != Butler::DiskWork::Refill) {
+			continue;
+		}
+		if (i->track == large || i->track == small || i->track == midi) {
+			order.push_back (i->track);
+			deadlines.push_back (i->deadline);
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, order.size ());
+	CPPUNIT_ASSERT (order[0] == midi);
+	CPPUNIT_ASSERT (order[1] == small);
+	CPPUNIT_ASSERT (order[2] == large);
+
+	/* while stopped, the deadline is what is buffered */
+	CPPUNIT_ASSERT_EQUAL (m, deadlines[0]);
+	CPPUNIT_ASSERT_EQUAL (s, deadlines[1]);
+	CPPUNIT_ASSERT_EQUAL (l, deadlines[2]);
+}
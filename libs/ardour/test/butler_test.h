@@ -0,0 +1,28 @@
+#include <glibmm/threads.h>
+
+#include "pbd/signals.h"
+#include "ardour/types.h"
+
+#include "test_needing_session.h"
+
+class ButlerTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (ButlerTest);
+	CPPUNIT_TEST (urgencyTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void urgencyTest ();
+
+private:
+	void locate (ARDOUR::framepos_t);
+	void located ();
+
+	Glib::Threads::Mutex _located_lock;
+	Glib::Threads::Cond _located_cond;
+	bool _located;
+	PBD::ScopedConnection _located_connection;
+};
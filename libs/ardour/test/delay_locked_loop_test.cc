@@ -0,0 +1,272 @@
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "ardour/delay_locked_loop.h"
+
+#include "delay_locked_loop_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (DelayLockedLoopTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+namespace {
+
+/* Offline simulation of a slave chasing a timecode stream:
+ * the stream is a list of event timestamps (in samples), e.g. the
+ * arrival times of MTC quarter-frames or MIDI clock ticks.
+ */
+typedef std::vector<double> Stream;
+
+struct SimResult {
+	SimResult () : lock (-1), corrections (0), speed_rms (0) {}
+	int    lock;        ///< events until the speed stays within tolerance
+	int    corrections; ///< events after lock outside the 0.1% speed deadzone
+	double speed_rms;   ///< speed error during the second half of the stream
+};
+
+/* 25fps MTC quarter frames at 48kHz */
+const double qtr = 48000.0 / 100.0;
+
+void
+make_stream (Stream& s, size_t n, double speed, double jitter, unsigned int seed = 1)
+{
+	s.clear ();
+	srand (seed);
+	for (size_t i = 0; i < n; ++i) {
+		const double noise = jitter * (2.0 * rand () / (double) RAND_MAX - 1.0);
+		s.push_back (10000 + i * qtr / speed + noise);
+	}
+}
+
+SimResult
+simulate (DelayLockedLoop& dll, Stream const& s, Stream const& speed, double tolerance)
+{
+	SimResult r;
+	double err2 = 0;
+	size_t cnt = 0;
+
+	dll.init (s[0], qtr);
+
+	for (size_t i = 1; i < s.size (); ++i) {
+		dll.update_at (s[i]);
+		const double spd = qtr / dll.period ();
+		const bool ok = fabs (spd - speed[i]) <= tolerance * speed[i];
+
+		if (!ok) {
+			r.lock = -1;
+		} else if (r.lock < 0) {
+			r.lock = i;
+		}
+		if (r.lock >= 0 && fabs (spd - 1.0) > 0.001) {
+			++r.corrections;
+		}
+		if (i > s.size () / 2) {
+			err2 += (spd - speed[i]) * (spd - speed[i]);
+			++cnt;
+		}
+	}
+	r.speed_rms = sqrt (err2 / cnt);
+	return r;
+}
+
+SimResult
+simulate (DelayLockedLoop& dll, Stream const& s, double speed, double tolerance)
+{
+	return simulate (dll, s, Stream (s.size (), speed), tolerance);
+}
+
+/* same bandwidth as the MTC quarter-frame DLL */
+const double mtc_omega = DelayLockedLoop::omega (0.5, qtr / 48000.0);
+
+}
+
+void
+DelayLockedLoopTest::initTest ()
+{
+	DelayLockedLoop dll;
+	CPPUNIT_ASSERT (!dll.initialized ());
+
+	dll.set_omega (mtc_omega);
+	dll.init (1000, qtr);
+	CPPUNIT_ASSERT (dll.initialized ());
+	CPPUNIT_ASSERT_EQUAL (1000.0, dll.t0 ());
+	CPPUNIT_ASSERT_EQUAL (1000.0 + qtr, dll.t1 ());
+	CPPUNIT_ASSERT_EQUAL (qtr, dll.e2 ());
+
+	/* a perfectly regular source does not move the loop */
+	for (int i = 1; i < 1000; ++i) {
+		dll.update_at (1000 + i * qtr);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (qtr, dll.period (), 1e-9);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, dll.ratio (qtr), 1e-12);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 999, dll.n_updates ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0, dll.jitter (), 1e-9);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.0, dll.error_max (), 1e-9);
+}
+
+void
+DelayLockedLoopTest::acquisitionTest ()
+{
+	Stream s;
+
+	for (unsigned int seed = 1; seed < 20; ++seed) {
+		make_stream (s, 5000, 1.01, 10, seed);
+
+		DelayLockedLoop plain;
+		plain.set_omega (mtc_omega);
+		const SimResult a = simulate (plain, s, 1.01, 0.002);
+
+		DelayLockedLoop fast;
+		fast.set_omega (mtc_omega);
+		fast.set_acquisition (4.0, ceil (3.0 / mtc_omega));
+		const SimResult b = simulate (fast, s, 1.01, 0.002);
+
+		CPPUNIT_ASSERT (a.lock > 0);
+		CPPUNIT_ASSERT (b.lock > 0);
+		CPPUNIT_ASSERT (b.lock < a.lock);
+
+		/* once settled, the loop is the same */
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (a.speed_rms, b.speed_rms, 1e-9);
+	}
+
+	/* a source running at nominal speed: the wider bandwidth does not
+	 * cause additional speed changes after locking.
+	 */
+	make_stream (s, 5000, 1.0, 2);
+
+	DelayLockedLoop plain;
+	plain.set_omega (mtc_omega);
+	const SimResult a = simulate (plain, s, 1.0, 0.001);
+
+	DelayLockedLoop fast;
+	fast.set_omega (mtc_omega);
+	fast.set_acquisition (4.0, ceil (3.0 / mtc_omega));
+	const SimResult b = simulate (fast, s, 1.0, 0.001);
+
+	CPPUNIT_ASSERT (b.lock <= a.lock);
+	CPPUNIT_ASSERT (b.corrections <= a.corrections);
+}
+
+void
+DelayLockedLoopTest::jitterTest ()
+{
+	Stream s;
+	const double jitter = 24; // +- 0.5ms
+
+	make_stream (s, 20000, 1.0, jitter);
+
+	DelayLockedLoop dll;
+	dll.set_omega (mtc_omega);
+	dll.init (s[0], qtr);
+
+	for (size_t i = 1; i < 1000; ++i) {
+		dll.update_at (s[i]);
+	}
+
+	dll.reset_stats ();
+
+	for (size_t i = 1000; i < s.size (); ++i) {
+		dll.update_at (s[i]);
+	}
+
+	/* uniform distribution: sigma = jitter / sqrt(3).
+	 * The loop-error also contains the (small) tracking error.
+	 */
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) (s.size () - 1000), dll.n_updates ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (jitter / sqrt (3.0), dll.jitter (), 0.15 * jitter / sqrt (3.0));
+	CPPUNIT_ASSERT (fabs (dll.error_mean ()) < 1.0);
+	CPPUNIT_ASSERT (dll.error_max () < 1.5 * jitter);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1.0, dll.ratio (qtr), 0.005);
+}
+
+void
+DelayLockedLoopTest::trackingTest ()
+{
+	/* the source slows down to 95%, half way through */
+	Stream s;
+	Stream speed;
+	double t = 10000;
+
+	for (size_t i = 0; i < 10000; ++i) {
+		const double spd = i < 5000 ? 1.0 : 0.95;
+		s.push_back (t);
+		speed.push_back (spd);
+		t += qtr / spd;
+	}
+
+	DelayLockedLoop dll;
+	dll.set_omega (mtc_omega);
+	dll.set_acquisition (4.0, ceil (3.0 / mtc_omega));
+
+	const SimResult r = simulate (dll, s, speed, 0.001);
+
+	CPPUNIT_ASSERT (r.lock > 5000);
+	/* the nominal bandwidth of 0.5 Hz settles within 2 seconds (200 quarter frames) */
+	CPPUNIT_ASSERT (r.lock < 5200);
+	CPPUNIT_ASSERT (r.speed_rms < 0.01);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.95, qtr / dll.period (), 1e-6);
+	/* and stays in phase */
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (t - qtr / 0.95, dll.t0 (), 0.01);
+}
+
+void
+DelayLockedLoopTest::recordedStreamTest ()
+{
+	/* Offline replay of a recorded stream: a text file with one event
+	 * timestamp (in samples) per line, e.g. MTC quarter-frames captured
+	 * with `ARDOUR_DEBUG=MTC`.
+	 * ARDOUR_DLL_STREAM=<file> [ARDOUR_DLL_PERIOD=<samples>] test_delay_locked_loop
+	 */
+	const char* path = getenv ("ARDOUR_DLL_STREAM");
+	if (!path) {
+		return;
+	}
+
+	ifstream f (path);
+	CPPUNIT_ASSERT (f.good ());
+
+	Stream s;
+	double ts;
+	while (f >> ts) {
+		s.push_back (ts);
+	}
+	CPPUNIT_ASSERT (s.size () > 2);
+
+	double period = (s.back () - s.front ()) / (s.size () - 1);
+	if (getenv ("ARDOUR_DLL_PERIOD")) {
+		period = atof (getenv ("ARDOUR_DLL_PERIOD"));
+	}
+
+	const double omega = DelayLockedLoop::omega (0.5, period / 48000.0);
+
+	for (int acquire = 0; acquire < 2; ++acquire) {
+		DelayLockedLoop dll;
+		dll.set_omega (omega);
+		if (acquire) {
+			dll.set_acquisition (4.0, ceil (3.0 / omega));
+		}
+		dll.init (s[0], period);
+
+		int lock = -1;
+		for (size_t i = 1; i < s.size (); ++i) {
+			dll.update_at (s[i]);
+			if (fabs (dll.ratio (period) - 1.0) > 0.002) {
+				lock = -1;
+			} else if (lock < 0) {
+				lock = i;
+			}
+		}
+
+		cout << endl << path << (acquire ? " (acquisition)" : "")
+		     << ": events " << s.size ()
+		     << " lock " << lock
+		     << " ratio " << dll.ratio (period)
+		     << " jitter " << dll.jitter ()
+		     << " max err " << dll.error_max ()
+		     << endl;
+	}
+}
@@ -0,0 +1,20 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class DelayLockedLoopTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (DelayLockedLoopTest);
+	CPPUNIT_TEST (initTest);
+	CPPUNIT_TEST (acquisitionTest);
+	CPPUNIT_TEST (jitterTest);
+	CPPUNIT_TEST (trackingTest);
+	CPPUNIT_TEST (recordedStreamTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void initTest ();
+	void acquisitionTest ();
+	void jitterTest ();
+	void trackingTest ();
+	void recordedStreamTest ();
+};
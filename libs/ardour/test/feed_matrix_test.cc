@@ -0,0 +1,337 @@
+#include <vector>
+
+#include "ardour/audio_track.h"
+#include "ardour/feed_matrix.h"
+#include "ardour/io.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+#include "ardour/solo_control.h"
+
+#include "feed_matrix_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (FeedMatrixTest);
+CPPUNIT_TEST_SUITE_REGISTRATION (FeedMatrixSessionTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+void
+FeedMatrixTest::basicTest ()
+{
+	/* 0 -> 1 -> 2, 3 unconnected */
+	FeedMatrix m;
+	m.reset (4);
+	m.add (0, 1, false);
+	m.add (1, 2, false);
+	m.close ();
+
+	bool sends_only = true;
+	CPPUNIT_ASSERT (m.feeds (0, 1, &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+	CPPUNIT_ASSERT (m.feeds (0, 2, &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+	CPPUNIT_ASSERT (m.feeds (1, 2));
+
+	CPPUNIT_ASSERT (!m.feeds (2, 0));
+	CPPUNIT_ASSERT (!m.feeds (1, 0));
+	CPPUNIT_ASSERT (!m.feeds (0, 3));
+	CPPUNIT_ASSERT (!m.feeds (3, 0));
+	CPPUNIT_ASSERT (!m.feeds (0, 0));
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, m.downstream (0).count ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, m.upstream (2).count ());
+	CPPUNIT_ASSERT (m.upstream (2).test (0));
+	CPPUNIT_ASSERT (m.upstream (2).test (1));
+	CPPUNIT_ASSERT (m.upstream (3).none ());
+	CPPUNIT_ASSERT (m.downstream (3).none ());
+
+	m.reset (4);
+	m.close ();
+	CPPUNIT_ASSERT (!m.feeds (0, 1));
+}
+
+void
+FeedMatrixTest::sendsTest ()
+{
+	/* 0 -(send)-> 1 -> 2
+	 * 0 ---------> 3 -(send)-> 2
+	 * 4 -(send)-> 2, 4 -> 5 -> 2
+	 */
+	FeedMatrix m;
+	m.reset (6);
+	m.add (0, 1, true);
+	m.add (1, 2, false);
+	m.add (0, 3, false);
+	m.add (3, 2, true);
+	m.add (4, 2, true);
+	m.add (4, 5, false);
+	m.add (5, 2, false);
+	m.close ();
+
+	bool sends_only = false;
+	CPPUNIT_ASSERT (m.feeds (0, 1, &sends_only));
+	CPPUNIT_ASSERT (sends_only);
+	CPPUNIT_ASSERT (m.feeds (0, 3, &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+
+	/* every path from 0 to 2 involves a send */
+	CPPUNIT_ASSERT (m.feeds (0, 2, &sends_only));
+	CPPUNIT_ASSERT (sends_only);
+	CPPUNIT_ASSERT (!m.downstream_audible (0).test (2));
+	CPPUNIT_ASSERT (m.downstream (0).test (2));
+
+	/* the direct send is shadowed by 4 -> 5 -> 2 */
+	CPPUNIT_ASSERT (m.feeds (4, 2, &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+	CPPUNIT_ASSERT (m.upstream_audible (2).test (4));
+	CPPUNIT_ASSERT (!m.upstream_audible (2).test (0));
+
+	/* adding an edge via sends does not downgrade an existing one */
+	m.reset (2);
+	m.add (0, 1, false);
+	m.add (0, 1, true);
+	m.close ();
+	CPPUNIT_ASSERT (m.feeds (0, 1, &sends_only));
+	CPPUNIT_ASSERT (!sends_only);
+}
+
+void
+FeedMatrixTest::feedbackTest ()
+{
+	/* 0 -> 1 -> 2 -> 0, 2 -> 3 */
+	FeedMatrix m;
+	m.reset (4);
+	m.add (0, 1, false);
+	m.add (1, 2, false);
+	m.add (2, 0, false);
+	m.add (2, 3, false);
+	m.close ();
+
+	for (uint32_t i = 0; i < 3; ++i) {
+		for (uint32_t j = 0; j < 4; ++j) {
+			CPPUNIT_ASSERT (m.feeds (i, j));
+		}
+	}
+	CPPUNIT_ASSERT (m.downstream (3).none ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.upstream (3).count ());
+}
+
+namespace {
+
+/* A synthetic 1000 route session:
+ *
+ *   880 tracks, 10 each into one of 88 busses,
+ *   88 busses, 4 each into one of 22 group busses,
+ *   22 group busses into the master bus,
+ *   every track with an aux-send to one of 9 FX busses,
+ *   9 FX busses into the master bus.
+ */
+enum {
+	n_tracks = 880,
+	n_busses = 88,
+	n_groups = 22,
+	n_fx = 9,
+	n_routes = n_tracks + n_busses + n_groups + n_fx + 1
+};
+
+struct Edge {
+	Edge (uint32_t f, uint32_t t, bool s) : from (f), to (t), sends_only (s) {}
+	uint32_t from;
+	uint32_t to;
+	bool sends_only;
+};
+
+void
+large_graph (vector<Edge>& edges)
+{
+	const uint32_t bus0    = n_tracks;
+	const uint32_t group0  = bus0 + n_busses;
+	const uint32_t fx0     = group0 + n_groups;
+	const uint32_t master  = fx0 + n_fx;
+
+	for (uint32_t t = 0; t < n_tracks; ++t) {
+		edges.push_back (Edge (t, bus0 + t / 10, false));
+		edges.push_back (Edge (t, fx0 + t % n_fx, true));
+	}
+	for (uint32_t b = 0; b < n_busses; ++b) {
+		edges.push_back (Edge (bus0 + b, group0 + b / 4, false));
+	}
+	for (uint32_t g = 0; g < n_groups; ++g) {
+		edges.push_back (Edge (group0 + g, master, false));
+	}
+	for (uint32_t f = 0; f < n_fx; ++f) {
+		edges.push_back (Edge (fx0 + f, master, false));
+	}
+}
+
+/* reference: depth-first search from every node */
+void
+reach (vector<vector<Edge> > const& out, uint32_t from, vector<int>& seen, bool audible_only)
+{
+	for (vector<Edge>::const_iterator e = out[from].begin(); e != out[from].end(); ++e) {
+		if (audible_only && e->sends_only) {
+			continue;
+		}
+		if (!seen[e->to]) {
+			seen[e->to] = 1;
+			reach (out, e->to, seen, audible_only);
+		}
+	}
+}
+
+}
+
+void
+FeedMatrixTest::largeGraphTest ()
+{
+	vector<Edge> edges;
+	large_graph (edges);
+
+	FeedMatrix m;
+	m.reset (n_routes);
+	for (vector<Edge>::const_iterator e = edges.begin(); e != edges.end(); ++e) {
+		m.add (e->from, e->to, e->sends_only);
+	}
+	m.close ();
+
+	/* compare with a graph search */
+	vector<vector<Edge> > out (n_routes);
+	for (vector<Edge>::const_iterator e = edges.begin(); e != edges.end(); ++e) {
+		out[e->from].push_back (*e);
+	}
+
+	for (uint32_t i = 0; i < n_routes; i += 7) {
+		vector<int> all (n_routes, 0);
+		vector<int> audible (n_routes, 0);
+		reach (out, i, all, false);
+		reach (out, i, audible, true);
+		for (uint32_t j = 0; j < n_routes; ++j) {
+			bool sends_only;
+			CPPUNIT_ASSERT_EQUAL ((bool) all[j], m.feeds (i, j, &sends_only));
+			if (all[j]) {
+				CPPUNIT_ASSERT_EQUAL (!audible[j], sends_only);
+			}
+		}
+	}
+
+	/* the signal flow of every track: its bus, group bus, FX bus and master */
+	for (uint32_t t = 0; t < n_tracks; ++t) {
+		FeedMatrix::Set in_flow (m.upstream (t) | m.downstream (t));
+		CPPUNIT_ASSERT_EQUAL ((size_t) 4, in_flow.count ());
+	}
+}
+
+/* connect the first output of @a from to the first input of @a to */
+static void
+connect (boost::shared_ptr<Route> from, boost::shared_ptr<Route> to)
+{
+	CPPUNIT_ASSERT_EQUAL (0, from->output ()->connect (from->output ()->audio (0), to->input ()->audio (0)->name (), 0));
+}
+
+void
+FeedMatrixSessionTest::setUp ()
+{
+	/* only the connections made by the tests, nothing asynchronous */
+	_input_auto_connect = Config->get_input_auto_connect ();
+	_output_auto_connect = Config->get_output_auto_connect ();
+	Config->set_input_auto_connect (AutoConnectOption (0));
+	Config->set_output_auto_connect (AutoConnectOption (0));
+
+	TestNeedingSession::setUp ();
+
+	_solo_changes = 0;
+	_session->SoloChanged.connect_same_thread (_solo_connection, boost::bind (&FeedMatrixSessionTest::solo_changed, this));
+}
+
+void
+FeedMatrixSessionTest::tearDown ()
+{
+	_solo_connection.disconnect ();
+	TestNeedingSession::tearDown ();
+
+	Config->set_input_auto_connect (_input_auto_connect);
+	Config->set_output_auto_connect (_output_auto_connect);
+}
+
+/** set solo on @a r and check that the session has handled it */
+void
+FeedMatrixSessionTest::solo (boost::shared_ptr<Route> r, bool yn)
+{
+	const uint32_t before = _solo_changes;
+	r->solo_control ()->set_value (yn ? 1.0 : 0.0, Controllable::NoGroup);
+	CPPUNIT_ASSERT_EQUAL (before + 1, _solo_changes);
+}
+
+void
+FeedMatrixSessionTest::soloTest ()
+{
+	list<boost::shared_ptr<AudioTrack> > tracks = _session->new_audio_track (1, 1, 0, 2, "solo", PresentationInfo::max_order);
+	RouteList busses = _session->new_audio_route (1, 1, 0, 1, "bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, tracks.size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, busses.size ());
+
+	boost::shared_ptr<Route> t1 = tracks.front ();
+	boost::shared_ptr<Route> t2 = tracks.back ();
+	boost::shared_ptr<Route> bus = busses.front ();
+
+	/* t1 -> bus */
+	connect (t1, bus);
+	_session->resort_routes ();
+
+	solo (t1, true);
+
+	CPPUNIT_ASSERT (t1->self_soloed ());
+	CPPUNIT_ASSERT (bus->soloed_by_others_upstream ());
+	CPPUNIT_ASSERT (!t2->soloed ());
+	/* see Session::update_route_solo_state */
+	CPPUNIT_ASSERT (_session->soloing ());
+
+	solo (t1, false);
+
+	CPPUNIT_ASSERT (!t1->soloed ());
+	CPPUNIT_ASSERT (!bus->soloed ());
+	CPPUNIT_ASSERT (!_session->soloing ());
+
+	/* soloing the bus solos what feeds it */
+	solo (bus, true);
+
+	CPPUNIT_ASSERT (t1->soloed_by_others_downstream ());
+	CPPUNIT_ASSERT (!t2->soloed ());
+	CPPUNIT_ASSERT (_session->soloing ());
+
+	solo (bus, false);
+
+	CPPUNIT_ASSERT (!t1->soloed ());
+	CPPUNIT_ASSERT (!_session->soloing ());
+}
+
+void
+FeedMatrixSessionTest::feedbackTest ()
+{
+	list<boost::shared_ptr<AudioTrack> > tracks = _session->new_audio_track (1, 1, 0, 2, "feedback", PresentationInfo::max_order);
+	RouteList busses = _session->new_audio_route (1, 1, 0, 1, "bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+	boost::shared_ptr<Route> t1 = tracks.front ();
+	boost::shared_ptr<Route> t2 = tracks.back ();
+	boost::shared_ptr<Route> bus = busses.front ();
+
+	/* t1 -> bus -> t2 -> bus: the route graph cannot be sorted */
+	connect (t1, bus);
+	connect (bus, t2);
+	connect (t2, bus);
+	_session->resort_routes ();
+
+	/* solo still follows the connections */
+	solo (t2, true);
+
+	CPPUNIT_ASSERT (bus->soloed_by_others_upstream ());
+	CPPUNIT_ASSERT (t1->soloed_by_others_downstream ());
+	CPPUNIT_ASSERT (_session->soloing ());
+
+	solo (t2, false);
+
+	CPPUNIT_ASSERT (!bus->soloed ());
+	CPPUNIT_ASSERT (!t1->soloed ());
+	CPPUNIT_ASSERT (!_session->soloing ());
+}
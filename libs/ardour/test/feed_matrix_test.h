@@ -0,0 +1,47 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "pbd/signals.h"
+#include "ardour/types.h"
+
+#include "test_needing_session.h"
+
+class FeedMatrixTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (FeedMatrixTest);
+	CPPUNIT_TEST (basicTest);
+	CPPUNIT_TEST (sendsTest);
+	CPPUNIT_TEST (feedbackTest);
+	CPPUNIT_TEST (largeGraphTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void basicTest ();
+	void sendsTest ();
+	void feedbackTest ();
+	void largeGraphTest ();
+};
+
+class FeedMatrixSessionTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (FeedMatrixSessionTest);
+	CPPUNIT_TEST (soloTest);
+	CPPUNIT_TEST (feedbackTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void soloTest ();
+	void feedbackTest ();
+
+private:
+	void solo (boost::shared_ptr<ARDOUR::Route>, bool);
+	void solo_changed () { ++_solo_changes; }
+
+	uint32_t _solo_changes;
+	PBD::ScopedConnection _solo_connection;
+	ARDOUR::AutoConnectOption _input_auto_connect;
+	ARDOUR::AutoConnectOption _output_auto_connect;
+};
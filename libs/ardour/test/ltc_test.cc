@@ -0,0 +1,372 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <ltc.h>
+
+#include "ltc_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (LTCTest);
+
+using namespace std;
+
+namespace {
+
+/* The LTC waveform as libltc computes it sample by sample, used as
+ * reference for the encoder's precomputed transitions.
+ */
+struct ReferenceEncoder {
+	ReferenceEncoder (double sample_rate, double fps, double dBFS, double rise_time)
+		: samples_per_clock (sample_rate / (fps * 80.0))
+		, sample_remainder (0.5)
+		, state (false)
+	{
+		const unsigned char diff = ((unsigned char) rint (127.0 * pow (10, dBFS / 20.0))) & 0x7f;
+		lo = 128 - diff;
+		hi = 128 + diff;
+		tcf = rise_time > 0 ? 1.0 - exp (-1.0 / (sample_rate * rise_time / 2000000.0 / exp (1.0))) : 0;
+	}
+
+	void add (int n) {
+		const ltcsnd_sample_t tgtval = state ? hi : lo;
+		const size_t off = out.size ();
+		out.resize (off + n);
+		ltcsnd_sample_t* wave = &out[off];
+		if (tcf > 0) {
+			ltcsnd_sample_t val = 128;
+			const int m = (n + 1) >> 1;
+			for (int i = 0; i < m; ++i) {
+				val = val + tcf * (tgtval - val);
+				wave[n - i - 1] = wave[i] = val;
+			}
+		} else {
+			memset (wave, tgtval, n);
+		}
+	}
+
+	void edge (double len) {
+		const int n = (int) (len + sample_remainder);
+		sample_remainder = len + sample_remainder - n;
+		state = !state;
+		add (n);
+	}
+
+	void encode_frame (LTCFrame const& f, double speed) {
+		const double spc = samples_per_clock * fabs (speed);
+		for (int byte = 0; byte < 10; ++byte) {
+			const unsigned char c = ((unsigned char const*) &f)[byte];
+			for (int bit = 0; bit < 8; ++bit) {
+				const unsigned char b = speed < 0 ? (128 >> bit) : (1 << bit);
+				if (c & b) {
+					edge (spc / 2.0);
+					edge (spc / 2.0);
+				} else {
+					edge (spc);
+				}
+			}
+		}
+	}
+
+	double samples_per_clock;
+	double sample_remainder;
+	double tcf;
+	bool state;
+	ltcsnd_sample_t lo;
+	ltcsnd_sample_t hi;
+	vector<ltcsnd_sample_t> out;
+};
+
+void
+encode (LTCEncoder* e, vector<ltcsnd_sample_t>& out, double speed = 1.0)
+{
+	for (int byte = 0; byte < 10; ++byte) {
+		CPPUNIT_ASSERT_EQUAL (0, ltc_encoder_encode_byte (e, byte, speed));
+	}
+	int n;
+	ltcsnd_sample_t* buf = ltc_encoder_get_bufptr (e, &n, 1);
+	out.insert (out.end (), buf, buf + n);
+}
+
+void
+to_float (vector<ltcsnd_sample_t> const& in, vector<float>& out)
+{
+	out.resize (in.size ());
+	for (size_t i = 0; i < in.size (); ++i) {
+		out[i] = (in[i] - 128) / 128.f;
+	}
+}
+
+void
+set_time (LTCEncoder* e, int h, int m, int s, int f)
+{
+	SMPTETimecode tc;
+	memset (&tc, 0, sizeof (tc));
+	strcpy (tc.timezone, "+0000");
+	tc.hours = h;
+	tc.mins = m;
+	tc.secs = s;
+	tc.frame = f;
+	ltc_encoder_set_timecode (e, &tc);
+}
+
+int
+frame_number (LTCFrame const& f, int fps)
+{
+	SMPTETimecode tc;
+	LTCFrame copy (f);
+	ltc_frame_to_time (&tc, &copy, 0);
+	return ((tc.hours * 60 + tc.mins) * 60 + tc.secs) * fps + tc.frame;
+}
+
+}
+
+void
+LTCTest::encoderTest ()
+{
+	const double rates[]  = { 44100, 48000, 96000 };
+	const double fps[]    = { 24, 25, 30000.0 / 1001.0, 30 };
+	const double rise[]   = { 0, 25, 40, 1000 };
+	const double volume[] = { -3, -18 };
+	const double speed[]  = { 1.0, 0.5, -1.0, 2.5 };
+
+	for (size_t r = 0; r < sizeof (rates) / sizeof (double); ++r) {
+	for (size_t f = 0; f < sizeof (fps) / sizeof (double); ++f) {
+	for (size_t t = 0; t < sizeof (rise) / sizeof (double); ++t) {
+	for (size_t v = 0; v < sizeof (volume) / sizeof (double); ++v) {
+	for (size_t s = 0; s < sizeof (speed) / sizeof (double); ++s) {
+
+		LTCEncoder* e = ltc_encoder_create (rates[r], fps[f], f == 1 ? LTC_TV_625_50 : LTC_TV_525_60, 0);
+		ltc_encoder_set_bufsize (e, rates[r], 1.0);
+		ltc_encoder_set_volume (e, volume[v]);
+		ltc_encoder_set_filter (e, rise[t]);
+
+		ReferenceEncoder ref (rates[r], fps[f], volume[v], rise[t]);
+		vector<ltcsnd_sample_t> out;
+
+		for (int n = 0; n < 30; ++n) {
+			LTCFrame frame;
+			ltc_encoder_get_frame (e, &frame);
+			ref.encode_frame (frame, speed[s]);
+			encode (e, out, speed[s]);
+			ltc_encoder_inc_timecode (e);
+		}
+
+		CPPUNIT_ASSERT_EQUAL (ref.out.size (), out.size ());
+		CPPUNIT_ASSERT (ref.out == out);
+
+		ltc_encoder_free (e);
+	}
+	}
+	}
+	}
+	}
+}
+
+void
+LTCTest::decoderTest ()
+{
+	const double rate = 48000;
+	const int fps = 25;
+	const int n_frames = 200;
+
+	LTCEncoder* e = ltc_encoder_create (rate, fps, LTC_TV_625_50, 0);
+	set_time (e, 1, 0, 0, 0);
+
+	vector<ltcsnd_sample_t> sig;
+	for (int n = 0; n < n_frames; ++n) {
+		encode (e, sig);
+		ltc_encoder_inc_timecode (e);
+	}
+	ltc_encoder_free (e);
+
+	vector<float> fsig;
+	to_float (sig, fsig);
+
+	/* decode the 8 bit and the float signal, using irregular block sizes */
+	LTCDecoder* d8 = ltc_decoder_create (rate / fps, 8);
+	LTCDecoder* df = ltc_decoder_create (rate / fps, 8);
+
+	vector<LTCFrameExt> f8;
+	vector<LTCFrameExt> ff;
+	LTCFrameExt frame;
+	size_t off = 0;
+	unsigned int seed = 1;
+
+	while (off < sig.size ()) {
+		seed = seed * 1103515245 + 12345;
+		size_t n = 1 + (seed >> 16) % 4096;
+		if (off + n > sig.size ()) {
+			n = sig.size () - off;
+		}
+		ltc_decoder_write (d8, &sig[off], n, off);
+		ltc_decoder_write_float (df, &fsig[off], n, off);
+		off += n;
+		while (ltc_decoder_read (d8, &frame)) {
+			f8.push_back (frame);
+		}
+		while (ltc_decoder_read (df, &frame)) {
+			ff.push_back (frame);
+		}
+	}
+
+	ltc_decoder_free (d8);
+	ltc_decoder_free (df);
+
+	/* the first frame is needed to sync */
+	CPPUNIT_ASSERT (f8.size () >= n_frames - 1);
+	CPPUNIT_ASSERT_EQUAL (f8.size (), ff.size ());
+
+	const int first = frame_number (f8[0].ltc, fps);
+	const double spf = rate / fps;
+
+	for (size_t i = 0; i < f8.size (); ++i) {
+		CPPUNIT_ASSERT (memcmp (&f8[i].ltc, &ff[i].ltc, sizeof (LTCFrame)) == 0);
+		CPPUNIT_ASSERT_EQUAL (f8[i].off_start, ff[i].off_start);
+		CPPUNIT_ASSERT_EQUAL (f8[i].off_end, ff[i].off_end);
+
+		const int n = frame_number (f8[i].ltc, fps);
+		CPPUNIT_ASSERT_EQUAL (first + (int) i, n);
+
+		/* and it was found where it was encoded */
+		const double start = (n - 3600 * fps) * spf;
+		CPPUNIT_ASSERT (fabs (f8[i].off_start - start) < 2);
+		CPPUNIT_ASSERT (fabs (f8[i].off_end - (start + spf - 1)) < 2);
+	}
+}
+
+/* What the libltc decoder (as vendored, before any changes) finds in the
+ * signal generated by referenceDecodeTest(): frame number relative to
+ * 01:00:00:00 at 29.97 fps, start and end offset.
+ */
+static const struct { int frame; ltc_off_t start; ltc_off_t end; } reference_decode[] = {
+	{ 1, 1787, 3258 },
+	{ 2, 3259, 4729 },
+	{ 3, 4730, 6201 },
+	{ 4, 6202, 7672 },
+	{ 5, 7673, 9144 },
+	{ 6, 9145, 10572 },
+	{ 7, 10573, 11997 },
+	{ 8, 11998, 13427 },
+	{ 9, 13428, 14854 },
+	{ 10, 14855, 16279 },
+};
+
+void
+LTCTest::referenceDecodeTest ()
+{
+	/* filtered, quiet, 29.97 fps at 44.1kHz, with leading silence and a
+	 * speed change half way, so that frames do not start at round offsets.
+	 */
+	const double rate = 44100;
+	const double fps = 30000.0 / 1001.0;
+
+	LTCEncoder* e = ltc_encoder_create (rate, fps, LTC_TV_525_60, 0);
+	set_time (e, 1, 0, 0, 0);
+	ltc_encoder_set_volume (e, -18);
+	ltc_encoder_set_filter (e, 40);
+
+	vector<ltcsnd_sample_t> sig (317, 128);
+	for (int n = 0; n < 12; ++n) {
+		encode (e, sig, n < 6 ? 1.0 : 0.97);
+		ltc_encoder_inc_timecode (e);
+	}
+	ltc_encoder_free (e);
+
+	vector<float> fsig;
+	to_float (sig, fsig);
+
+	const size_t n_ref = sizeof (reference_decode) / sizeof (reference_decode[0]);
+
+	/* the 8 bit signal as is, and the float signal the way LTC_Slave
+	 * converts it, rounding to the nearest 8 bit value.
+	 */
+	for (int pass = 0; pass < 2; ++pass) {
+		LTCDecoder* d = ltc_decoder_create (1471, 8);
+		const size_t block = pass ? 512 : 1024;
+		vector<LTCFrameExt> frames;
+		LTCFrameExt frame;
+		ltcsnd_sample_t tmp[1024];
+
+		for (size_t off = 0; off < sig.size (); off += block) {
+			const size_t n = min (block, sig.size () - off);
+			for (size_t i = 0; i < n; ++i) {
+				if (pass) {
+					const int snd = (int) rint ((127.0 * fsig[off + i]) + 128.0);
+					tmp[i] = (ltcsnd_sample_t) (snd & 0xff);
+				} else {
+					tmp[i] = sig[off + i];
+				}
+			}
+			ltc_decoder_write (d, tmp, n, off);
+			while (ltc_decoder_read (d, &frame)) {
+				frames.push_back (frame);
+			}
+		}
+		ltc_decoder_free (d);
+
+		CPPUNIT_ASSERT_EQUAL (n_ref, frames.size ());
+
+		for (size_t i = 0; i < n_ref; ++i) {
+			CPPUNIT_ASSERT_EQUAL (reference_decode[i].frame, frame_number (frames[i].ltc, 30) - 3600 * 30);
+			CPPUNIT_ASSERT_EQUAL (reference_decode[i].start, frames[i].off_start);
+			CPPUNIT_ASSERT_EQUAL (reference_decode[i].end, frames[i].off_end);
+		}
+	}
+}
+
+void
+LTCTest::multiStreamTest ()
+{
+	/* independent encoders/decoders generating and chasing LTC at different
+	 * frame rates and offsets, processed in blocks, as a session would.
+	 */
+	const double rate = 48000;
+	const int fps[] = { 24, 25, 30, 30 };
+	const int start_secs[] = { 10, 20, 30, 3600 };
+	const int n_streams = 4;
+	const size_t block = 512;
+
+	LTCEncoder* enc[n_streams];
+	LTCDecoder* dec[n_streams];
+	vector<ltcsnd_sample_t> pending[n_streams];
+	vector<int> decoded[n_streams];
+
+	for (int s = 0; s < n_streams; ++s) {
+		enc[s] = ltc_encoder_create (rate, fps[s], fps[s] == 25 ? LTC_TV_625_50 : LTC_TV_525_60, 0);
+		set_time (enc[s], start_secs[s] / 3600, (start_secs[s] / 60) % 60, start_secs[s] % 60, 0);
+		dec[s] = ltc_decoder_create (rate / fps[s], 8);
+	}
+
+	vector<float> buf (block);
+
+	for (size_t pos = 0; pos < rate * 4; pos += block) {
+		for (int s = 0; s < n_streams; ++s) {
+			while (pending[s].size () < block) {
+				encode (enc[s], pending[s]);
+				ltc_encoder_inc_timecode (enc[s]);
+			}
+			for (size_t i = 0; i < block; ++i) {
+				buf[i] = (pending[s][i] - 128) / 128.f;
+			}
+			pending[s].erase (pending[s].begin (), pending[s].begin () + block);
+
+			ltc_decoder_write_float (dec[s], &buf[0], block, pos);
+
+			LTCFrameExt frame;
+			while (ltc_decoder_read (dec[s], &frame)) {
+				decoded[s].push_back (frame_number (frame.ltc, fps[s]));
+			}
+		}
+	}
+
+	for (int s = 0; s < n_streams; ++s) {
+		/* 4 seconds, minus the first frame to sync and the last one in flight */
+		CPPUNIT_ASSERT ((int) decoded[s].size () >= 4 * fps[s] - 2);
+		CPPUNIT_ASSERT (decoded[s][0] <= start_secs[s] * fps[s] + 1);
+		for (size_t i = 1; i < decoded[s].size (); ++i) {
+			CPPUNIT_ASSERT_EQUAL (decoded[s][i - 1] + 1, decoded[s][i]);
+		}
+		ltc_encoder_free (enc[s]);
+		ltc_decoder_free (dec[s]);
+	}
+}
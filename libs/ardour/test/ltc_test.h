@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class LTCTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (LTCTest);
+	CPPUNIT_TEST (encoderTest);
+	CPPUNIT_TEST (decoderTest);
+	CPPUNIT_TEST (referenceDecodeTest);
+	CPPUNIT_TEST (multiStreamTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void encoderTest ();
+	void decoderTest ();
+	void referenceDecodeTest ();
+	void multiStreamTest ();
+};
@@ -0,0 +1,185 @@
+#include <vector>
+
+#include "ardour/playlist_render_cache.h"
+
+#include "playlist_render_cache_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRenderCacheTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+fill (vector<Sample>& buf, framepos_t start)
+{
+	for (size_t i = 0; i < buf.size (); ++i) {
+		buf[i] = (start + i) * 1e-6;
+	}
+}
+
+static bool
+check (vector<Sample> const& buf, framepos_t start)
+{
+	for (size_t i = 0; i < buf.size (); ++i) {
+		if (buf[i] != (Sample) ((start + i) * 1e-6)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+PlaylistRenderCacheTest::readWriteTest ()
+{
+	PlaylistRenderCache cache;
+	PlaylistRenderCache::set_max_frames (PlaylistRenderCache::block_frames * 16);
+
+	/* spans a block boundary */
+	const framepos_t start = PlaylistRenderCache::block_frames - 1000;
+	vector<Sample> in (4000);
+	vector<Sample> out (4000);
+	fill (in, start);
+
+	CPPUNIT_ASSERT (!cache.read (&out[0], start, out.size (), 0));
+
+	cache.write (&in[0], start, in.size (), 0, cache.generation ());
+	cache.flush ();
+
+	CPPUNIT_ASSERT (cache.read (&out[0], start, out.size (), 0));
+	CPPUNIT_ASSERT (check (out, start));
+
+	/* a part of what was written */
+	vector<Sample> part (500);
+	CPPUNIT_ASSERT (cache.read (&part[0], start + 100, part.size (), 0));
+	CPPUNIT_ASSERT (check (part, start + 100));
+
+	/* other channel, and partially outside of what was written */
+	CPPUNIT_ASSERT (!cache.read (&out[0], start, out.size (), 1));
+	CPPUNIT_ASSERT (!cache.read (&out[0], start + 100, out.size (), 0));
+
+	/* a contiguous write extends the cached part of the block */
+	vector<Sample> more (1000);
+	fill (more, start + in.size ());
+	cache.write (&more[0], start + in.size (), more.size (), 0, cache.generation ());
+	cache.flush ();
+	CPPUNIT_ASSERT (cache.read (&out[0], start + 100, out.size (), 0));
+	CPPUNIT_ASSERT (check (out, start + 100));
+
+	PlaylistRenderCache::Stats s = cache.stats ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 3, s.hits);
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 2, s.blocks);
+}
+
+void
+PlaylistRenderCacheTest::invalidateTest ()
+{
+	PlaylistRenderCache cache;
+	PlaylistRenderCache::set_max_frames (PlaylistRenderCache::block_frames * 16);
+
+	const framecnt_t bf = PlaylistRenderCache::block_frames;
+	vector<Sample> in (bf * 3);
+	vector<Sample> out (bf);
+	fill (in, 0);
+
+	cache.write (&in[0], 0, in.size (), 0, cache.generation ());
+	cache.flush ();
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 3, cache.stats ().blocks);
+
+	/* only the middle block is affected */
+	cache.invalidate (Evoral::Range<framepos_t> (bf + 10, bf + 20));
+
+	CPPUNIT_ASSERT (cache.read (&out[0], 0, bf, 0));
+	CPPUNIT_ASSERT (!cache.read (&out[0], bf, bf, 0));
+	CPPUNIT_ASSERT (cache.read (&out[0], 2 * bf, bf, 0));
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 2, cache.stats ().blocks);
+
+	cache.clear ();
+	CPPUNIT_ASSERT (!cache.read (&out[0], 0, bf, 0));
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 0, cache.stats ().blocks);
+}
+
+void
+PlaylistRenderCacheTest::generationTest ()
+{
+	PlaylistRenderCache cache;
+	PlaylistRenderCache::set_max_frames (PlaylistRenderCache::block_frames * 16);
+
+	vector<Sample> in (1024);
+	vector<Sample> out (1024);
+	fill (in, 0);
+
+	/* something changed while this data was rendered */
+	const uint32_t g = cache.generation ();
+	cache.invalidate (Evoral::Range<framepos_t> (50000, 60000));
+	cache.write (&in[0], 0, in.size (), 0, g);
+	cache.flush ();
+
+	CPPUNIT_ASSERT (!cache.read (&out[0], 0, out.size (), 0));
+
+	/* nothing is kept when the cache has no space */
+	PlaylistRenderCache::set_max_frames (0);
+	cache.write (&in[0], 0, in.size (), 0, cache.generation ());
+	cache.flush ();
+	CPPUNIT_ASSERT (!cache.read (&out[0], 0, out.size (), 0));
+}
+
+void
+PlaylistRenderCacheTest::budgetTest ()
+{
+	/* the limit applies to the caches of all playlists together */
+	const framecnt_t bf = PlaylistRenderCache::block_frames;
+	PlaylistRenderCache::set_max_frames (bf * 2);
+
+	PlaylistRenderCache a;
+	PlaylistRenderCache b;
+
+	vector<Sample> in (bf * 2);
+	vector<Sample> out (bf);
+	fill (in, 0);
+
+	a.write (&in[0], 0, in.size (), 0, a.generation ());
+	a.flush ();
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 2, a.stats ().blocks);
+
+	b.write (&in[0], 0, bf, 0, b.generation ());
+	b.flush ();
+	CPPUNIT_ASSERT (!b.read (&out[0], 0, bf, 0));
+
+	/* space that is given up by one cache can be used by another */
+	a.clear ();
+	CPPUNIT_ASSERT (!a.read (&out[0], 0, bf, 0));
+
+	b.write (&in[0], 0, bf, 0, b.generation ());
+	b.flush ();
+	CPPUNIT_ASSERT (b.read (&out[0], 0, bf, 0));
+	CPPUNIT_ASSERT (check (out, 0));
+}
+
+void
+PlaylistRenderCacheTest::stopWriterTest ()
+{
+	PlaylistRenderCache cache;
+	PlaylistRenderCache::set_max_frames (PlaylistRenderCache::block_frames * 16);
+
+	vector<Sample> in (PlaylistRenderCache::block_frames * 2);
+	vector<Sample> out (in.size ());
+	fill (in, 0);
+
+	/* what is queued when the writer is stopped is still stored */
+	cache.write (&in[0], 0, in.size (), 0, cache.generation ());
+	PlaylistRenderCache::stop_writer_thread ();
+
+	CPPUNIT_ASSERT (cache.read (&out[0], 0, out.size (), 0));
+	CPPUNIT_ASSERT (check (out, 0));
+
+	/* and the next write starts it again */
+	fill (in, in.size ());
+	cache.write (&in[0], in.size (), in.size (), 0, cache.generation ());
+	cache.flush ();
+
+	CPPUNIT_ASSERT (cache.read (&out[0], in.size (), out.size (), 0));
+	CPPUNIT_ASSERT (check (out, in.size ()));
+
+	PlaylistRenderCache::stop_writer_thread ();
+	PlaylistRenderCache::stop_writer_thread ();
+}
@@ -0,0 +1,20 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PlaylistRenderCacheTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (PlaylistRenderCacheTest);
+	CPPUNIT_TEST (readWriteTest);
+	CPPUNIT_TEST (invalidateTest);
+	CPPUNIT_TEST (generationTest);
+	CPPUNIT_TEST (budgetTest);
+	CPPUNIT_TEST (stopWriterTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void readWriteTest ();
+	void invalidateTest ();
+	void generationTest ();
+	void budgetTest ();
+	void stopWriterTest ();
+};
@@ -0,0 +1,663 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/* Runs a curated set of libardour performance scenarios on the Dummy
+ * backend and reports per-scenario timings (and DSP load, where it
+ * applies) as JSON. Optionally compares against a stored baseline and
+ * exits non-zero if any scenario got slower than the given threshold.
+ *
+ *   benchmark [--json <file>] [--baseline <file>] [--threshold <percent>]
+ *             [--filter <substring>] [--sessions <dir>]
+ */
+
+#include <getopt.h>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <glibmm/miscutils.h>
+#include <glibmm/timer.h>
+
+#include "pbd/compose.h"
+#include "pbd/failed_constructor.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/audioplaylist.h"
+#include "ardour/audioregion.h"
+#include "ardour/audio_track.h"
+#include "ardour/interthread_info.h"
+#include "ardour/io.h"
+#include "ardour/monitor_control.h"
+#include "ardour/playlist_factory.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/region_factory.h"
+#include "ardour/runtime_functions.h"
+#include "ardour/session.h"
+#include "ardour/sndfilesource.h"
+#include "ardour/solo_control.h"
+#include "ardour/source_factory.h"
+#include "ardour/tempo.h"
+#include "ardour/utils.h"
+
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+struct Result {
+	Result () : iterations (0), total_ms (0), mean_us (0), min_us (0), max_us (0), dsp_load (-1), dsp_load_max (-1) {}
+
+	string   name;
+	uint64_t iterations;
+	double   total_ms;
+	double   mean_us;
+	double   min_us;
+	double   max_us;
+	double   dsp_load;     ///< mean DSP load in percent, < 0: not applicable
+	double   dsp_load_max;
+};
+
+static vector<Result> results;
+static string filter;
+
+static bool
+wanted (string const& name)
+{
+	return filter.empty () || name.find (filter) != string::npos;
+}
+
+/** time @param iterations calls of @param f */
+static void
+run (string const& name, uint64_t iterations, boost::function<void()> f)
+{
+	if (!wanted (name)) {
+		return;
+	}
+
+	Result r;
+	r.name = name;
+	r.iterations = iterations;
+	r.min_us = HUGE_VAL;
+
+	const gint64 start = g_get_monotonic_time ();
+	for (uint64_t i = 0; i < iterations; ++i) {
+		const gint64 t0 = g_get_monotonic_time ();
+		f ();
+		const double dt = g_get_monotonic_time () - t0;
+		r.min_us = min (r.min_us, dt);
+		r.max_us = max (r.max_us, dt);
+	}
+	r.total_ms = (g_get_monotonic_time () - start) / 1000.0;
+	r.mean_us = iterations > 0 ? 1000.0 * r.total_ms / iterations : 0;
+
+	cerr << string_compose ("%1: %2 iterations, mean %3 us\n", name, iterations, r.mean_us);
+	results.push_back (r);
+}
+
+/** let the engine run (with the transport rolling, unless @param roll is false),
+ *  and sample its DSP load
+ */
+static void
+measure_dsp_load (string const& name, Session* session, double seconds, bool roll = true)
+{
+	if (!wanted (name)) {
+		return;
+	}
+
+	AudioEngine* engine = AudioEngine::instance ();
+	const double period_us = 1e6 * engine->samples_per_cycle () / (double) engine->sample_rate ();
+
+	session->request_locate (0);
+	if (roll) {
+		session->request_transport_speed (1.0);
+	}
+	Glib::usleep (500000); // settle
+
+	Result r;
+	r.name = name;
+	r.min_us = HUGE_VAL;
+
+	double sum = 0;
+	r.dsp_load_max = 0;
+	const uint64_t samples = max (1.0, seconds * 100);
+
+	for (uint64_t i = 0; i < samples; ++i) {
+		Glib::usleep (10000);
+		const double load = engine->get_dsp_load ();
+		sum += load;
+		r.dsp_load_max = max (r.dsp_load_max, load);
+		r.min_us = min (r.min_us, load * period_us / 100.0);
+		r.max_us = max (r.max_us, load * period_us / 100.0);
+	}
+
+	session->request_stop ();
+	Glib::usleep (100000);
+
+	r.iterations = samples;
+	r.dsp_load = sum / samples;
+	r.mean_us = r.dsp_load * period_us / 100.0;
+	r.total_ms = seconds * 1000.0;
+
+	cerr << string_compose ("%1: DSP load %2%% (max %3%%)\n", name, r.dsp_load, r.dsp_load_max);
+	results.push_back (r);
+}
+
+/* DSP kernels
+ *
+ * The kernels run over the same buffers many times, so the data must stay
+ * in a normal range: denormals (or infinities) would time the FPU's slow
+ * path instead of the kernel.
+ */
+
+static void
+apply_gain_alternating (Sample* buf, pframes_t n)
+{
+	/* 0.5 and 2 are exact, the data neither decays nor drifts */
+	static bool up = false;
+	apply_gain_to_buffer (buf, n, up ? 2.0f : 0.5f);
+	up = !up;
+}
+
+static void
+dsp_kernels ()
+{
+	const pframes_t n = 1024;
+	Sample* a = new Sample[n];
+	Sample* b = new Sample[n];
+	gain_t* fade_in = new gain_t[n];
+	gain_t* fade_out = new gain_t[n];
+
+	for (pframes_t i = 0; i < n; ++i) {
+		a[i] = sinf (i * 0.01f);
+		b[i] = cosf (i * 0.01f);
+		fade_in[i] = (i + 1) / (float) n;
+		fade_out[i] = 1.0f - fade_in[i];
+	}
+
+	float peak = 0;
+
+	run ("dsp.mix_buffers_with_gain", 100000, boost::bind (mix_buffers_with_gain, a, b, n, 0.5f));
+	run ("dsp.mix_buffers_no_gain", 100000, boost::bind (mix_buffers_no_gain, a, b, n));
+	run ("dsp.apply_gain_to_buffer", 100000, boost::bind (apply_gain_alternating, a, n));
+	run ("dsp.compute_peak", 100000, boost::bind (compute_peak, b, n, peak));
+	run ("dsp.copy_vector", 100000, boost::bind (copy_vector, a, b, n));
+	/* a crossfade into b, which converges to b rather than growing */
+	run ("dsp.mix_buffers_with_fade", 100000, boost::bind (mix_buffers_with_fade, a, b, fade_in, fade_out, (gain_t*) 0, n, 1.0f));
+
+	delete [] a;
+	delete [] b;
+	delete [] fade_in;
+	delete [] fade_out;
+}
+
+/* tempo map */
+
+static volatile double sink;
+
+static void
+beat_at_frame (TempoMap& m, framecnt_t sr)
+{
+	for (framepos_t f = 0; f < 600 * sr; f += sr) {
+		sink = m.beat_at_frame (f);
+	}
+}
+
+static void
+frame_at_beat (TempoMap& m)
+{
+	for (double b = 0; b < 1200; b += 2) {
+		sink = m.frame_at_beat (b);
+	}
+}
+
+static void
+bbt_at_frame (TempoMap& m, framecnt_t sr)
+{
+	for (framepos_t f = 0; f < 600 * sr; f += sr) {
+		sink = m.bbt_at_frame (f).bars;
+	}
+}
+
+static void
+tempo_conversions (TempoMap& map, framecnt_t sr)
+{
+	run ("tempo.beat_at_frame", 1000, boost::bind (&beat_at_frame, boost::ref (map), sr));
+	run ("tempo.frame_at_beat", 1000, boost::bind (&frame_at_beat, boost::ref (map)));
+	run ("tempo.bbt_at_frame", 1000, boost::bind (&bbt_at_frame, boost::ref (map), sr));
+}
+
+/* playlist read, bounce and save on a generated session */
+
+static boost::shared_ptr<Source>
+create_source (Session* session, string const& path, framecnt_t len)
+{
+	boost::shared_ptr<Source> src = SourceFactory::createWritable (DataType::AUDIO, *session, path, false, session->frame_rate ());
+	boost::shared_ptr<SndFileSource> s = boost::dynamic_pointer_cast<SndFileSource> (src);
+	assert (s);
+
+	const framecnt_t chunk = 8192;
+	Sample buf[chunk];
+	for (framecnt_t pos = 0; pos < len; pos += chunk) {
+		for (framecnt_t i = 0; i < chunk; ++i) {
+			buf[i] = 0.5f * sinf ((pos + i) * 0.01f);
+		}
+		s->write (buf, chunk);
+	}
+
+	Source::Lock lm (s->mutex ());
+	s->mark_streaming_write_completed (lm);
+	return src;
+}
+
+static void
+read_playlist (boost::shared_ptr<AudioPlaylist> pl, framecnt_t len)
+{
+	const framecnt_t chunk = 8192;
+	Sample dst[chunk];
+	Sample mix[chunk];
+	float gain[chunk];
+
+	for (framepos_t pos = 0; pos < len; pos += chunk) {
+		pl->read (dst, mix, gain, pos, chunk, 0);
+	}
+}
+
+static void
+read_source (boost::shared_ptr<AudioSource> src, framecnt_t len)
+{
+	const framecnt_t chunk = 8192;
+	Sample dst[chunk];
+
+	for (framepos_t pos = 0; pos < len; pos += chunk) {
+		src->read (dst, pos, chunk);
+	}
+}
+
+static void
+bounce (boost::shared_ptr<AudioTrack> track, framecnt_t len)
+{
+	InterThreadInfo itt;
+	track->bounce_range (0, len, itt, boost::shared_ptr<Processor> (), false);
+}
+
+static void
+save (Session* session)
+{
+	session->save_state ("");
+}
+
+static void
+generated_session ()
+{
+	const string dir = Glib::build_filename (new_test_output_dir ("benchmark"), "bench");
+	Session* session = load_session (dir, "bench");
+
+	const framecnt_t sr = session->frame_rate ();
+	const framecnt_t len = 60 * sr;
+
+	tempo_conversions (session->tempo_map (), sr);
+
+	boost::shared_ptr<Source> src = create_source (session, Glib::build_filename (dir, "bench.wav"), len);
+
+	/* source reads: libsndfile vs. memory-mapped (only used once the file is complete) */
+	boost::dynamic_pointer_cast<FileSource> (src)->mark_immutable ();
+	SndFileSource::set_use_mmap (false);
+	run ("source.read.sndfile", 10, boost::bind (&read_source, boost::dynamic_pointer_cast<AudioSource> (src), len));
+	SndFileSource::set_use_mmap (true);
+	run ("source.read.mmap", 10, boost::bind (&read_source, boost::dynamic_pointer_cast<AudioSource> (src), len));
+
+	/* a comp-like playlist: many short overlapping regions with fades */
+	boost::shared_ptr<AudioPlaylist> pl = boost::dynamic_pointer_cast<AudioPlaylist> (PlaylistFactory::create (DataType::AUDIO, *session, "bench"));
+	const framecnt_t rlen = sr / 2;
+
+	for (framepos_t pos = 0; pos + rlen < len; pos += rlen * 3 / 4) {
+		PropertyList plist;
+		plist.add (Properties::start, pos);
+		plist.add (Properties::length, rlen);
+		boost::shared_ptr<AudioRegion> r = boost::dynamic_pointer_cast<AudioRegion> (RegionFactory::create (src, plist));
+		r->set_fade_in_length (rlen / 4);
+		r->set_fade_out_length (rlen / 4);
+		pl->add_region (r, pos);
+	}
+
+	run ("playlist.read", 10, boost::bind (&read_playlist, pl, len));
+
+	/* tracks for bounce and process */
+	list<boost::shared_ptr<AudioTrack> > tracks = session->new_audio_track (1, 2, 0, 32, "bench", PresentationInfo::max_order);
+
+	for (list<boost::shared_ptr<AudioTrack> >::iterator t = tracks.begin (); t != tracks.end (); ++t) {
+		PropertyList plist;
+		plist.add (Properties::start, 0);
+		plist.add (Properties::length, len);
+		(*t)->playlist ()->add_region (RegionFactory::create (src, plist), 0);
+	}
+
+	if (!tracks.empty ()) {
+		run ("export.bounce", 3, boost::bind (&bounce, tracks.front (), 10 * sr));
+	}
+
+	measure_dsp_load ("session.process.bench", session, 3);
+
+	run ("session.save.bench", 10, boost::bind (&save, session));
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+}
+
+/* input monitoring with the transport stopped: every track runs no_roll(),
+ * either serially in the process thread or in parallel on the process graph
+ */
+
+static void
+stopped_monitoring (uint32_t n_tracks, int32_t processor_usage, string const& mode)
+{
+	const string name = string_compose ("session.monitor.stopped.%1tracks.%2", n_tracks, mode);
+
+	if (!wanted (name)) {
+		return;
+	}
+
+	/* the process graph is only created with a session, depending on the number of DSP threads */
+	const int32_t old_usage = Config->get_processor_usage ();
+	Config->set_processor_usage (processor_usage);
+
+	const string sname = string_compose ("monitor-%1", mode);
+	const string dir = Glib::build_filename (new_test_output_dir ("benchmark"), sname);
+	Session* session = load_session (dir, sname);
+
+	list<boost::shared_ptr<AudioTrack> > tracks = session->new_audio_track (1, 2, 0, n_tracks, "mon", PresentationInfo::max_order);
+
+	for (list<boost::shared_ptr<AudioTrack> >::iterator t = tracks.begin (); t != tracks.end (); ++t) {
+		(*t)->monitoring_control ()->set_value (MonitorInput, Controllable::NoGroup);
+	}
+
+	cerr << string_compose ("%1: %2 tracks, %3 DSP thread(s)\n", name, tracks.size (), how_many_dsp_threads ());
+
+	measure_dsp_load (name, session, 3, false);
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+
+	Config->set_processor_usage (old_usage);
+}
+
+/* solo on a large session: 880 tracks into 88 busses, into 22 group
+ * busses, into the master bus (1000 routes including master).
+ */
+
+static void
+toggle_solo (boost::shared_ptr<Route> r)
+{
+	r->solo_control ()->set_value (1.0, Controllable::NoGroup);
+	r->solo_control ()->set_value (0.0, Controllable::NoGroup);
+}
+
+static void
+connect_first (boost::shared_ptr<Route> from, boost::shared_ptr<Route> to)
+{
+	from->output ()->connect (from->output ()->audio (0), to->input ()->audio (0)->name (), 0);
+}
+
+static void
+large_session_solo ()
+{
+	const string name = "session.solo.1000routes";
+
+	if (!wanted (name)) {
+		return;
+	}
+
+	/* only the connections made below */
+	const AutoConnectOption old_in = Config->get_input_auto_connect ();
+	const AutoConnectOption old_out = Config->get_output_auto_connect ();
+	Config->set_input_auto_connect (AutoConnectOption (0));
+	Config->set_output_auto_connect (AutoConnectOption (0));
+
+	const string dir = Glib::build_filename (new_test_output_dir ("benchmark"), "solo");
+	Session* session = load_session (dir, "solo");
+
+	list<boost::shared_ptr<AudioTrack> > tracks = session->new_audio_track (1, 1, 0, 880, "solo", PresentationInfo::max_order);
+	RouteList busses = session->new_audio_route (1, 1, 0, 88, "bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+	RouteList groups = session->new_audio_route (1, 1, 0, 22, "group", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+	vector<boost::shared_ptr<Route> > b (busses.begin (), busses.end ());
+	vector<boost::shared_ptr<Route> > g (groups.begin (), groups.end ());
+	uint32_t n = 0;
+
+	for (list<boost::shared_ptr<AudioTrack> >::iterator t = tracks.begin (); t != tracks.end (); ++t, ++n) {
+		connect_first (*t, b[(n / 10) % b.size ()]);
+	}
+	for (n = 0; n < b.size (); ++n) {
+		connect_first (b[n], g[(n / 4) % g.size ()]);
+	}
+	for (n = 0; n < g.size (); ++n) {
+		connect_first (g[n], session->master_out ());
+	}
+	session->resort_routes ();
+
+	cerr << string_compose ("%1: %2 routes\n", name, session->get_routes ()->size ());
+
+	run (name, 20, boost::bind (&toggle_solo, boost::static_pointer_cast<Route> (tracks.front ())));
+
+	AudioEngine::instance ()->remove_session ();
+	delete session;
+
+	Config->set_input_auto_connect (old_in);
+	Config->set_output_auto_connect (old_out);
+}
+
+/* bundled sessions */
+
+static Session* loaded_session = 0;
+
+static void
+load (string const& dir, string const& name)
+{
+	AudioEngine::instance ()->remove_session ();
+	delete loaded_session;
+	loaded_session = load_session (dir, name);
+}
+
+static void
+bundled_sessions (string const& dir)
+{
+	const char* names[] = { "0tracks", "32tracks", 0 };
+
+	for (int i = 0; names[i]; ++i) {
+		const string sdir = Glib::build_filename (dir, names[i]);
+		const string load_name = string_compose ("session.load.%1", names[i]);
+		const string process_name = string_compose ("session.process.%1", names[i]);
+
+		if (!wanted (load_name) && !wanted (process_name)) {
+			continue;
+		}
+
+		try {
+			run (load_name, 3, boost::bind (&load, sdir, names[i]));
+			if (!loaded_session) {
+				loaded_session = load_session (sdir, names[i]);
+			}
+		} catch (failed_constructor& e) {
+			cerr << string_compose ("cannot load session %1\n", sdir);
+			continue;
+		}
+
+		measure_dsp_load (process_name, loaded_session, 3);
+
+		AudioEngine::instance ()->remove_session ();
+		delete loaded_session;
+		loaded_session = 0;
+	}
+}
+
+/* output */
+
+static void
+write_json (ostream& o)
+{
+	o << "{\n  \"scenarios\": [\n";
+	for (vector<Result>::const_iterator i = results.begin (); i != results.end (); ++i) {
+		/* one scenario per line, see read_baseline() */
+		o << string_compose ("    { \"name\": \"%1\", \"iterations\": %2, \"total_ms\": %3, \"mean_us\": %4, \"min_us\": %5, \"max_us\": %6",
+		                     i->name, i->iterations, i->total_ms, i->mean_us, i->min_us, i->max_us);
+		if (i->dsp_load >= 0) {
+			o << string_compose (", \"dsp_load\": %1, \"dsp_load_max\": %2", i->dsp_load, i->dsp_load_max);
+		}
+		o << " }" << (i + 1 == results.end () ? "" : ",") << "\n";
+	}
+	o << "  ]\n}\n";
+}
+
+static bool
+json_value (string const& line, string const& key, string& value)
+{
+	const string k = "\"" + key + "\": ";
+	string::size_type p = line.find (k);
+	if (p == string::npos) {
+		return false;
+	}
+	p += k.length ();
+	if (line[p] == '"') {
+		string::size_type e = line.find ('"', p + 1);
+		value = line.substr (p + 1, e - p - 1);
+	} else {
+		string::size_type e = line.find_first_of (",}", p);
+		value = line.substr (p, e - p);
+	}
+	return true;
+}
+
+static map<string, double>
+read_baseline (string const& path)
+{
+	map<string, double> b;
+	ifstream f (path.c_str ());
+	string line;
+	while (getline (f, line)) {
+		string name, mean;
+		if (json_value (line, "name", name) && json_value (line, "mean_us", mean)) {
+			b[name] = atof (mean.c_str ());
+		}
+	}
+	return b;
+}
+
+static int
+compare (map<string, double> const& baseline, double threshold)
+{
+	int regressions = 0;
+
+	for (vector<Result>::const_iterator i = results.begin (); i != results.end (); ++i) {
+		map<string, double>::const_iterator b = baseline.find (i->name);
+		if (b == baseline.end () || b->second <= 0) {
+			continue;
+		}
+		const double change = 100.0 * (i->mean_us - b->second) / b->second;
+		const bool regressed = change > threshold;
+		cerr << string_compose ("%1 %2: %3 us -> %4 us (%5%6%%)\n",
+		                        regressed ? "REGRESSION" : "ok        ",
+		                        i->name, b->second, i->mean_us, change > 0 ? "+" : "", change);
+		if (regressed) {
+			++regressions;
+		}
+	}
+
+	return regressions;
+}
+
+int
+main (int argc, char* argv[])
+{
+	string json_file;
+	string baseline_file;
+	string sessions_dir = "../libs/ardour/test/profiling/sessions";
+	double threshold = 10.0;
+
+	const struct option longopts[] = {
+		{ "json", 1, 0, 'j' },
+		{ "baseline", 1, 0, 'b' },
+		{ "threshold", 1, 0, 't' },
+		{ "filter", 1, 0, 'f' },
+		{ "sessions", 1, 0, 's' },
+		{ 0, 0, 0, 0 }
+	};
+
+	int c;
+	while ((c = getopt_long (argc, argv, "j:b:t:f:s:", longopts, 0)) != -1) {
+		switch (c) {
+		case 'j':
+			json_file = optarg;
+			break;
+		case 'b':
+			baseline_file = optarg;
+			break;
+		case 't':
+			threshold = atof (optarg);
+			break;
+		case 'f':
+			filter = optarg;
+			break;
+		case 's':
+			sessions_dir = optarg;
+			break;
+		default:
+			cerr << "Usage: " << argv[0] << " [--json <file>] [--baseline <file>] [--threshold <percent>] [--filter <name>] [--sessions <dir>]\n";
+			exit (EXIT_FAILURE);
+		}
+	}
+
+	ARDOUR::init (false, true, localedir);
+	create_and_start_dummy_backend ();
+
+	dsp_kernels ();
+	generated_session ();
+	stopped_monitoring (200, 1, "serial");
+	stopped_monitoring (200, 0, "parallel");
+	large_session_solo ();
+	bundled_sessions (sessions_dir);
+
+	stop_and_destroy_backend ();
+
+	if (json_file.empty ()) {
+		write_json (cout);
+	} else {
+		ofstream f (json_file.c_str ());
+		write_json (f);
+	}
+
+	if (!baseline_file.empty ()) {
+		const int regressions = compare (read_baseline (baseline_file), threshold);
+		if (regressions > 0) {
+			cerr << string_compose ("%1 scenario(s) regressed by more than %2%%\n", regressions, threshold);
+			ARDOUR::cleanup ();
+			return 1;
+		}
+	}
+
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -16,6 +16,7 @@
     Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 #include "pbd/error.h"
+#include "pbd/rt_monitor.h"
 
 #include "ardour/amp.h"
 #include "ardour/debug.h"
@@ -45,6 +46,7 @@ Track::Track (Session& sess, string name, PresentationInfo::Flag flag, TrackMode
 	: Route (sess, name, flag, default_type)
         , _saved_meter_point (_meter_point)
         , _mode (mode)
+        , _near_underruns (0)
 {
 	_freeze_record.state = NoFreeze;
         _declickable = true;
@@ -204,6 +206,44 @@ Track::can_record()
 	return will_record;
 }
 
+bool
+Track::can_be_pipelined () const
+{
+	MonitorChoice const m (_monitoring_control->monitoring_choice ());
+
+	if (!active () || _record_enable_control->get_value () || (m & MonitorInput)) {
+		return false;
+	}
+
+	/* with auto-input, auto-monitoring listens to the input while the
+	 * transport is stopped (see ::monitoring_state()), which must not be
+	 * delayed. Session::config_changed() handles changes to these.
+	 */
+
+	if (!(m & MonitorDisk) && _session.config.get_auto_input () && !Config->get_tape_machine_mode ()
+	    && Config->get_monitoring_model () == SoftwareMonitoring) {
+		return false;
+	}
+
+	if (_output->n_ports().n_audio() == 0 || _output->n_ports().n_midi() != 0) {
+		return false;
+	}
+
+	/* sends, inserts and the monitor-section's listen send deliver
+	 * in the same cycle, bypassing the output ports.
+	 */
+
+	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+
+	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		if (boost::dynamic_pointer_cast<IOProcessor> (*i) && *i != _main_outs) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 int
 Track::prep_record_enabled (bool yn)
 {
@@ -358,6 +398,7 @@ Track::no_roll (pframes_t nframes, framepos_t start_frame, framepos_t end_frame,
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		return 0;
 	}
 
@@ -490,6 +531,7 @@ Track::silent_roll (pframes_t nframes, framepos_t /*start_frame*/, framepos_t /*
 {
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock, Glib::Threads::TRY_LOCK);
 	if (!lm.locked()) {
+		PBD::RTMonitor::note_event (PBD::RTMonitor::LockWait);
 		framecnt_t playback_distance = _diskstream->calculate_playback_distance(nframes);
 		if (can_internal_playback_seek(playback_distance)) {
 			internal_playback_seek(playback_distance);
@@ -610,6 +652,24 @@ Track::capture_buffer_load () const
 	return _diskstream->capture_buffer_load ();
 }
 
+framecnt_t
+Track::playback_buffer_size () const
+{
+	return _diskstream->playback_buffer_size ();
+}
+
+framecnt_t
+Track::capture_buffer_size () const
+{
+	return _diskstream->capture_buffer_size ();
+}
+
+framecnt_t
+Track::playback_frames_buffered () const
+{
+	return _diskstream->playback_frames_buffered ();
+}
+
 int
 Track::do_refill ()
 {
@@ -19,6 +19,8 @@
 #ifndef __CANVAS_CURVE_H__
 #define __CANVAS_CURVE_H__
 
+#include <vector>
+
 #include "canvas/visibility.h"
 
 #include "canvas/interpolated_curve.h"
@@ -51,12 +53,16 @@ class LIBCANVAS_API Curve : public PolyItem, public InterpolatedCurve
     void set_fill_mode (CurveFill cf) { curve_fill = cf; }
 
   private:
-    Points samples;
-    Points::size_type n_samples;
+    /* interpolated samples, (points_per_segment - 1) per segment plus the
+     * final point. Segments are interpolated on demand when rendered.
+     */
+    mutable Points samples;
+    mutable std::vector<bool> segment_interpolated;
     uint32_t points_per_segment;
     CurveFill curve_fill;
 
     void interpolate ();
+    void interpolate_segments (Points::size_type first, Points::size_type last) const;
 };
 
 }
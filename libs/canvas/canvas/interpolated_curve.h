@@ -136,6 +136,50 @@ protected:
 		}
 	}
 
+	/**
+	 * Calculate the interpolation of a single segment of an open curve,
+	 * from coordinates[segment] to coordinates[segment + 1]. The result is
+	 * identical to the corresponding points_per_segment points returned by
+	 * interpolate(), which allows to interpolate only those segments that
+	 * are actually needed.
+	 *
+	 * @param coordinates The list of original straight line points, at least 3.
+	 * @param segment index of the segment, less than coordinates.size() - 1
+	 * @param results points_per_segment points are appended to this list
+	 */
+	static void
+		interpolate_segment (const Points& coordinates, Points::size_type segment, uint32_t points_per_segment, SplineType curve_type, Points& results)
+	{
+		if (points_per_segment < 2 || coordinates.size() < 3) {
+			return;
+		}
+
+		const Points::size_type n = coordinates.size() - 1;
+		Points vertices (4);
+
+		vertices[1] = coordinates[segment];
+		vertices[2] = coordinates[segment + 1];
+
+		// extrapolate the first and last segments for control points, as interpolate() does
+		if (segment > 0) {
+			vertices[0] = coordinates[segment - 1];
+		} else {
+			const double dx = coordinates[1].x - coordinates[0].x;
+			const double dy = coordinates[1].y - coordinates[0].y;
+			vertices[0] = Duple (coordinates[0].x - dx, coordinates[0].y - dy);
+		}
+
+		if (segment + 2 <= n) {
+			vertices[3] = coordinates[segment + 2];
+		} else {
+			const double dx = coordinates[n].x - coordinates[n - 1].x;
+			const double dy = coordinates[n].y - coordinates[n - 1].y;
+			vertices[3] = Duple (coordinates[n].x + dx, coordinates[n].y + dy);
+		}
+
+		_interpolate (vertices, 0, points_per_segment, curve_type, results);
+	}
+
 private:
 	/**
 	 * Calculate the same values but introduces the ability to "parameterize" the t
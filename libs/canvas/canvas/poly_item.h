@@ -40,10 +40,14 @@ public:
         void dump (std::ostream&) const;
 
 protected:
-	void render_path (Rect const &, Cairo::RefPtr<Cairo::Context>) const;
+	void render_path (Rect const &, Cairo::RefPtr<Cairo::Context>, bool clip_to_area = true) const;
         void render_curve (Rect const &, Cairo::RefPtr<Cairo::Context>, Points const &, Points const &) const;
 
+	bool visible_span (Rect const & area, Points::size_type& first, Points::size_type& last) const;
+
 	Points _points;
+	/** true if the x-coordinates of _points never decrease */
+	bool   _x_monotonic;
 };
 
 }
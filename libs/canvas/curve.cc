@@ -29,7 +29,6 @@ using std::max;
 
 Curve::Curve (Canvas* c)
 	: PolyItem (c)
-	, n_samples (0)
 	, points_per_segment (16)
 	, curve_fill (None)
 {
@@ -37,7 +36,6 @@ Curve::Curve (Canvas* c)
 
 Curve::Curve (Item* parent)
 	: PolyItem (parent)
-	, n_samples (0)
 	, points_per_segment (16)
 	, curve_fill (None)
 {
@@ -75,12 +73,41 @@ Curve::set (Points const& p)
 	interpolate ();
 }
 
+/** Discard all interpolated samples. They are re-computed lazily,
+ * for visible segments only, by render().
+ */
 void
 Curve::interpolate ()
 {
 	samples.clear ();
-	InterpolatedCurve::interpolate (_points, points_per_segment, CatmullRomCentripetal, false, samples);
-	n_samples = samples.size();
+	segment_interpolated.clear ();
+
+	if (_points.size() < 3 || points_per_segment < 2) {
+		return;
+	}
+
+	const Points::size_type n_segments = _points.size() - 1;
+
+	samples.resize (n_segments * (points_per_segment - 1) + 1);
+	segment_interpolated.resize (n_segments, false);
+}
+
+void
+Curve::interpolate_segments (Points::size_type first, Points::size_type last) const
+{
+	const Points::size_type stride = points_per_segment - 1;
+	Points r;
+
+	for (Points::size_type seg = first; seg < last; ++seg) {
+		if (segment_interpolated[seg]) {
+			continue;
+		}
+		r.clear ();
+		InterpolatedCurve::interpolate_segment (_points, seg, points_per_segment, CatmullRomCentripetal, r);
+		assert (r.size() == points_per_segment);
+		std::copy (r.begin(), r.end(), samples.begin() + seg * stride);
+		segment_interpolated[seg] = true;
+	}
 }
 
 void
@@ -95,11 +122,9 @@ Curve::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) const
 	assert (d);
 	Rect draw = d.get ();
 
-	/* Our approach is to always draw n_segments across our total size.
-	 *
-	 * This is very inefficient if we are asked to only draw a small
-	 * section of the curve. For now we rely on cairo clipping to help
-	 * with this.
+	/* Only the segments that intersect the drawing area are interpolated
+	 * and drawn (if the curve is monotonic in x, which is the common
+	 * case). Cairo clipping takes care of the rest.
 	 */
 
 
@@ -174,22 +199,33 @@ Curve::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) const
 			draw.x1 = w2.x;
 		}
 
-		/* find left and right-most sample */
-		Duple window_space;
-		Points::size_type left = 0;
-		Points::size_type right = n_samples;
-
-		for (Points::size_type idx = 0; idx < n_samples - 1; ++idx) {
-			left = idx;
-			window_space = item_to_window (Duple (samples[idx].x, 0.0));
-			if (window_space.x >= draw.x0) break;
-		}
-		for (Points::size_type idx = n_samples; idx > left + 1; --idx) {
-			window_space = item_to_window (Duple (samples[idx].x, 0.0));
-			if (window_space.x <= draw.x1) break;
-			right = idx;
+		if (samples.empty ()) {
+			context->restore ();
+			return;
 		}
 
+		/* find the segments that span the drawing area. Catmull-Rom
+		 * segments may overshoot their end-points, so add one more
+		 * segment on either side.
+		 */
+		Points::size_type first;
+		Points::size_type last;
+
+		visible_span (draw, first, last);
+
+		const Points::size_type last_point = _points.size() - 1;
+
+		first = first > 0 ? first - 1 : 0;
+		last = min (last + 1, last_point);
+
+		interpolate_segments (first, last);
+
+		const Points::size_type stride = points_per_segment - 1;
+		const Points::size_type left = first * stride;
+		const Points::size_type right = last * stride + 1;
+
+		Duple window_space;
+
 		/* draw line between samples */
 		window_space = item_to_window (Duple (samples[left].x, samples[left].y));
 		context->move_to (window_space.x, window_space.y);
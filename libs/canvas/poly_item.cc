@@ -29,11 +29,13 @@ using namespace ArdourCanvas;
 
 PolyItem::PolyItem (Canvas* c)
 	: Item (c)
+	, _x_monotonic (true)
 {
 }
 
 PolyItem::PolyItem (Item* parent)
 	: Item (parent)
+	, _x_monotonic (true)
 {
 }
 
@@ -69,24 +71,71 @@ PolyItem::compute_bounding_box () const
 	_bounding_box_dirty = false;
 }
 
+static bool
+x_less (Duple const & a, Duple const & b)
+{
+	return a.x < b.x;
+}
+
+/** Find the range of points that needs to be rendered to cover @param area
+ * (in window coordinates): the last point left of the area, up to the first
+ * point right of it, so that segments crossing the area's edges are included.
+ *
+ * Only items whose points are sorted by x can be clipped this way, for any
+ * other item the full range is returned.
+ *
+ * @return true if there is at least one segment to render.
+ */
+bool
+PolyItem::visible_span (Rect const & area, Points::size_type& first, Points::size_type& last) const
+{
+	const Points::size_type npoints = _points.size();
+
+	first = 0;
+	last = npoints > 0 ? npoints - 1 : 0;
+
+	if (npoints < 2 || !_x_monotonic) {
+		return npoints > 1;
+	}
+
+	/* line joins and caps may extend beyond the points */
+	const Rect r = window_to_item (area.expand (_outline_width + 1.0));
+
+	Points::const_iterator i = std::upper_bound (_points.begin(), _points.end(), Duple (r.x0, 0), x_less);
+	if (i != _points.begin()) {
+		first = (i - _points.begin()) - 1;
+	}
+
+	i = std::lower_bound (_points.begin() + first, _points.end(), Duple (r.x1, 0), x_less);
+	if (i != _points.end()) {
+		last = i - _points.begin();
+	}
+
+	return first < last;
+}
+
 void
-PolyItem::render_path (Rect const & /* area */, Cairo::RefPtr<Cairo::Context> context) const
+PolyItem::render_path (Rect const & area, Cairo::RefPtr<Cairo::Context> context, bool clip_to_area) const
 {
 	if (_points.size() < 2) {
 		return;
 	}
 
-	Points::const_iterator i = _points.begin();
-	Duple c (item_to_window (Duple (i->x, i->y)));
+	Points::size_type first = 0;
+	Points::size_type last = _points.size() - 1;
+
+	if (clip_to_area) {
+		visible_span (area, first, last);
+	}
+
+	Duple c (item_to_window (_points[first]));
 	const double pixel_adjust = (_outline_width == 1.0 ? 0.5 : 0.0);
 
 	context->move_to (c.x + pixel_adjust, c.y + pixel_adjust);
-	++i;
 
-	while (i != _points.end()) {
-		c = item_to_window (Duple (i->x, i->y));
+	for (Points::size_type n = first + 1; n <= last; ++n) {
+		c = item_to_window (_points[n]);
 		context->line_to (c.x + pixel_adjust, c.y + pixel_adjust);
-		++i;
 	}
 }
 
@@ -98,21 +147,24 @@ PolyItem::render_curve (Rect const & area, Cairo::RefPtr<Cairo::Context> context
 		return;
 	}
 
-	Points::const_iterator cp1 = first_control_points.begin();
-	Points::const_iterator cp2 = second_control_points.begin();
-	Points::const_iterator p = _points.begin();
+	Points::size_type first;
+	Points::size_type last;
+
+	visible_span (area, first, last);
+
 	const double pixel_adjust = (_outline_width == 1.0 ? 0.5 : 0.0);
 
-	Duple c = item_to_window (Duple (p->x, p->y));
+	Duple c = item_to_window (_points[first]);
 	context->move_to (c.x + pixel_adjust, c.y + pixel_adjust);
-	++p;
 
-	while (p != _points.end()) {
+	/* segment n-1 runs from point n-1 to n, using control points n-1 */
+
+	for (Points::size_type n = first + 1; n <= last; ++n) {
 
-		Duple c1 = item_to_window (Duple (cp1->x, cp1->y));
-		Duple c2 = item_to_window (Duple (cp2->x, cp2->y));
+		Duple c1 = item_to_window (first_control_points[n-1]);
+		Duple c2 = item_to_window (second_control_points[n-1]);
 
-		c = item_to_window (Duple (p->x, p->y));
+		c = item_to_window (_points[n]);
 
 		context->curve_to (c1.x + pixel_adjust,
 				   c1.y + pixel_adjust,
@@ -120,10 +172,6 @@ PolyItem::render_curve (Rect const & area, Cairo::RefPtr<Cairo::Context> context
 				   c2.y + pixel_adjust,
 				   c.x + pixel_adjust,
 				   c.y + pixel_adjust);
-
-		++cp1;
-		++cp2;
-		++p;
 	}
 }
 
@@ -136,6 +184,14 @@ PolyItem::set (Points const & points)
 
 		_points = points;
 
+		_x_monotonic = true;
+		for (Points::size_type n = 1; n < _points.size(); ++n) {
+			if (_points[n].x < _points[n-1].x) {
+				_x_monotonic = false;
+				break;
+			}
+		}
+
 		_bounding_box_dirty = true;
 		end_change ();
 	}
@@ -47,7 +47,8 @@ void
 Polygon::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) const
 {
 	if (_outline || _fill) {
-		render_path (area, context);
+		/* a closed shape cannot be clipped to the visible points */
+		render_path (area, context, false);
 
 		if (!_points.empty ()) {
 			/* close path */
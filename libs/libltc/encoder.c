@@ -25,6 +25,32 @@
 
 #include "ltc/encoder.h"
 
+/**
+ * compute the filtered transitions used by addvalues()
+ */
+static int compute_rise(ltcsnd_sample_t *rise, double tcf, ltcsnd_sample_t tgtval) {
+	ltcsnd_sample_t val = SAMPLE_CENTER;
+	int i;
+	for (i = 0; i < LTC_RISE_TABLE_SIZE; ++i) {
+		const ltcsnd_sample_t next = val + tcf * (tgtval - val);
+		rise[i] = next;
+		if (i > 0 && next == val) {
+			return i + 1;
+		}
+		val = next;
+	}
+	return LTC_RISE_TABLE_SIZE;
+}
+
+void encoder_update_rise(LTCEncoder *e) {
+	if (e->filter_const > 0) {
+		e->rise_hi_len = compute_rise(e->rise_hi, e->filter_const, e->enc_hi);
+		e->rise_lo_len = compute_rise(e->rise_lo, e->filter_const, e->enc_lo);
+	} else {
+		e->rise_hi_len = e->rise_lo_len = 0;
+	}
+}
+
 /**
  * add values to the output buffer
  */
@@ -49,13 +75,23 @@ static int addvalues(LTCEncoder *e, int n) {
 		 * here we need half-of it. (0.000020 sec)
 		 *
 		 * e->cutoff = 1.0 -exp( -1.0 / (sample_rate * .000020 / exp(1.0)) );
+		 *
+		 * The transition is symmetric: the first half is taken from
+		 * the precomputed table (see encoder_update_rise), mirrored
+		 * at the end, and the value the filter settled at fills the
+		 * rest.
 		 */
+		const ltcsnd_sample_t * const rise = e->state ? e->rise_hi : e->rise_lo;
+		const int rise_len = e->state ? e->rise_hi_len : e->rise_lo_len;
+		const int m = (n+1)>>1;
+		const int k = m < rise_len ? m : rise_len;
 		int i;
-		ltcsnd_sample_t val = SAMPLE_CENTER;
-		int m = (n+1)>>1;
-		for (i = 0 ; i < m ; i++) {
-			val = val + tcf * (tgtval - val);
-			wave[n-i-1] = wave[i] = val;
+		for (i = 0 ; i < k ; i++) {
+			wave[n-i-1] = rise[i];
+		}
+		memcpy(wave, rise, k);
+		if (n > 2 * k) {
+			memset(wave + k, rise[k-1], n - 2 * k);
 		}
 	} else {
 		/* perfect square wave */
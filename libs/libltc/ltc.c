@@ -213,6 +213,7 @@ int ltc_encoder_set_volume(LTCEncoder *e, double dBFS) {
 	ltcsnd_sample_t diff = ((ltcsnd_sample_t) pp)&0x7f;
 	e->enc_lo = SAMPLE_CENTER - diff;
 	e->enc_hi = SAMPLE_CENTER + diff;
+	encoder_update_rise(e);
 	return 0;
 }
 
@@ -229,6 +230,8 @@ void ltc_encoder_set_filter(LTCEncoder *e, double rise_time) {
 		e->filter_const = 0;
 	else
 		e->filter_const = 1.0 - exp( -1.0 / (e->sample_rate * rise_time / 2000000.0 / exp(1.0)) );
+
+	encoder_update_rise(e);
 }
 
 int ltc_encoder_set_bufsize(LTCEncoder *e, double sample_rate, double fps) {
@@ -23,6 +23,10 @@
 #define SAMPLE_CENTER 128 // unsigned 8 bit.
 #endif
 
+/* every filter step moves the value by at least one until it settles,
+ * so there are at most 256 distinct values */
+#define LTC_RISE_TABLE_SIZE 257
+
 struct LTCEncoder {
 	double fps;
 	double sample_rate;
@@ -42,6 +46,15 @@ struct LTCEncoder {
 	double sample_remainder;
 
 	LTCFrame f;
+
+	/* precomputed first half of a filtered transition to enc_hi and
+	 * enc_lo. The last value of each is the one the filter settles at.
+	 */
+	ltcsnd_sample_t rise_hi[LTC_RISE_TABLE_SIZE];
+	ltcsnd_sample_t rise_lo[LTC_RISE_TABLE_SIZE];
+	int rise_hi_len;
+	int rise_lo_len;
 };
 
 int encode_byte(LTCEncoder *e, int byte, double speed);
+void encoder_update_rise(LTCEncoder *e);
@@ -41,7 +41,16 @@ EventLoop::ThreadRequestBufferList EventLoop::thread_buffer_requests;
 EventLoop::RequestBufferSuppliers EventLoop::request_buffer_suppliers;
 
 EventLoop::EventLoop (string const& name)
-	: _name (name)
+	: _stats_dispatched (0)
+	, _stats_dropped (0)
+	, _stats_invalidated (0)
+	, _stats_queue_depth (0)
+	, _stats_max_queue_depth (0)
+	, _stats_total_dispatched (0)
+	, _stats_total_dropped (0)
+	, _stats_total_invalidated (0)
+	, _stats_last_query (g_get_monotonic_time ())
+	, _name (name)
 {
 }
 
@@ -88,16 +97,83 @@ EventLoop::invalidate_request (void* data)
 
         if (ir->event_loop) {
 		Glib::Threads::Mutex::Lock lm (ir->event_loop->slot_invalidation_mutex());
-		for (list<BaseRequestObject*>::iterator i = ir->requests.begin(); i != ir->requests.end(); ++i) {
-			(*i)->valid = false;
-			(*i)->invalidation = 0;
+		ir->invalidate ();
+		if (ir->in_use ()) {
+			/* queued requests still refer to it, the event loop
+			 * will delete it after those have been handled.
+			 */
+			ir->event_loop->trash.push_back (ir);
+		} else {
+			delete ir;
 		}
+        } else {
+		/* never used to queue a request */
 		delete ir;
-        }
+	}
 
         return 0;
 }
 
+void
+EventLoop::empty_trash ()
+{
+	/* called with slot_invalidation_mutex() held */
+	for (list<InvalidationRecord*>::iterator i = trash.begin(); i != trash.end();) {
+		if (!(*i)->in_use ()) {
+			delete *i;
+			i = trash.erase (i);
+		} else {
+			++i;
+		}
+	}
+}
+
+void
+EventLoop::note_queue_depth (uint32_t depth)
+{
+	g_atomic_int_set (&_stats_queue_depth, depth);
+	if ((gint) depth > g_atomic_int_get (&_stats_max_queue_depth)) {
+		g_atomic_int_set (&_stats_max_queue_depth, depth);
+	}
+}
+
+EventLoop::RequestStats
+EventLoop::get_request_stats ()
+{
+	RequestStats rs;
+
+	const gint dispatched = g_atomic_int_and (&_stats_dispatched, 0);
+	_stats_total_dispatched  += dispatched;
+	_stats_total_dropped     += g_atomic_int_and (&_stats_dropped, 0);
+	_stats_total_invalidated += g_atomic_int_and (&_stats_invalidated, 0);
+
+	const gint64 now = g_get_monotonic_time ();
+	if (now > _stats_last_query) {
+		rs.requests_per_second = dispatched * 1e6 / (double) (now - _stats_last_query);
+	}
+	_stats_last_query = now;
+
+	rs.dispatched      = _stats_total_dispatched;
+	rs.dropped         = _stats_total_dropped;
+	rs.invalidated     = _stats_total_invalidated;
+	rs.queue_depth     = g_atomic_int_get (&_stats_queue_depth);
+	rs.max_queue_depth = g_atomic_int_get (&_stats_max_queue_depth);
+	return rs;
+}
+
+void
+EventLoop::reset_request_stats ()
+{
+	g_atomic_int_set (&_stats_dispatched, 0);
+	g_atomic_int_set (&_stats_dropped, 0);
+	g_atomic_int_set (&_stats_invalidated, 0);
+	g_atomic_int_set (&_stats_max_queue_depth, 0);
+	_stats_total_dispatched = 0;
+	_stats_total_dropped = 0;
+	_stats_total_invalidated = 0;
+	_stats_last_query = g_get_monotonic_time ();
+}
+
 vector<EventLoop::ThreadBufferMapping>
 EventLoop::get_request_buffers_for_target_thread (const std::string& target_thread)
 {
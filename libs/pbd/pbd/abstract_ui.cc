@@ -64,6 +64,7 @@ Glib::Threads::Private<typename AbstractUI<R>::RequestBuffer> AbstractUI<R>::per
 template <typename RequestObject>
 AbstractUI<RequestObject>::AbstractUI (const string& name)
 	: BaseUI (name)
+	, _dispatch_depth (0)
 {
 	void (AbstractUI<RequestObject>::*pmf)(pthread_t,string,uint32_t) = &AbstractUI<RequestObject>::register_thread;
 
@@ -162,6 +163,7 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 
 		if (vec.len[0] == 0) {
 			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: no space in per thread pool for request of type %2\n", event_loop_name(), rt));
+			note_request_dropped ();
 			return 0;
 		}
 
@@ -169,6 +171,7 @@ AbstractUI<RequestObject>::get_request (RequestType rt)
 
 		vec.buf[0]->type = rt;
 		vec.buf[0]->valid = true;
+		vec.buf[0]->invalidation = 0;
 		return vec.buf[0];
 	}
 
@@ -191,15 +194,49 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 	RequestBufferMapIterator i;
 	RequestBufferVector vec;
 
-	/* check all registered per-thread buffers first */
+	/* requests may run a recursive main event loop that will itself
+	 * call handle_ui_requests. Only the outermost call may delete dead
+	 * request buffers, since an outer call may still be iterating over
+	 * them.
+	 */
+	const bool outermost = (++_dispatch_depth == 1);
+
+	/* take a snapshot of all registered per-thread buffers. The map lock
+	 * is only held for this, not while dispatching: new buffers are only
+	 * ever added by other threads, and only this thread removes them.
+	 */
+
+	std::vector<RequestBuffer*> buffers;
+
+	{
+		Glib::Threads::Mutex::Lock lm (request_buffer_map_lock);
+		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 check %2 request buffers for requests\n", event_loop_name(), request_buffers.size()));
+		buffers.reserve (request_buffers.size());
+		for (i = request_buffers.begin(); i != request_buffers.end(); ++i) {
+			buffers.push_back (i->second);
+		}
+	}
 
-	request_buffer_map_lock.lock ();
+	uint32_t pending = 0;
+
+	for (typename std::vector<RequestBuffer*>::const_iterator b = buffers.begin(); b != buffers.end(); ++b) {
+		pending += (*b)->read_space ();
+	}
 
-	DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 check %2 request buffers for requests\n", event_loop_name(), request_buffers.size()));
+	note_queue_depth (pending);
 
-	for (i = request_buffers.begin(); i != request_buffers.end(); ++i) {
+	for (typename std::vector<RequestBuffer*>::const_iterator b = buffers.begin(); b != buffers.end(); ++b) {
+
+		RequestBuffer* rbuf = *b;
+
+		/* drain in batches: handle at most the requests that were
+		 * queued when we started, so that a single busy thread cannot
+		 * starve all others.
+		 */
 
-		while (true) {
+		size_t batch = rbuf->read_space ();
+
+		while (batch-- > 0) {
 
 			/* we must process requests 1 by 1 because
 			 * the request may run a recursive main
@@ -211,106 +248,99 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 			 * the condition before we called it.
 			 */
 
-			i->second->get_read_vector (&vec);
+			rbuf->get_read_vector (&vec);
 
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 reading requests from RB[%2] @ %5, requests = %3 + %4\n",
-			                                                     event_loop_name(), std::distance (request_buffers.begin(), i), vec.len[0], vec.len[1], i->second));
+			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1 reading requests from RB @ %4, requests = %2 + %3\n",
+			                                                     event_loop_name(), vec.len[0], vec.len[1], rbuf));
 
 			if (vec.len[0] == 0) {
 				break;
-			} else {
-				if (vec.buf[0]->valid) {
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, unlocking before calling\n", event_loop_name()));
-					request_buffer_map_lock.unlock ();
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, calling ::do_request()\n", event_loop_name()));
-					do_request (vec.buf[0]);
-
-					/* if the request was CallSlot, then we need to ensure that we reset the functor in the request, in case it
-					 * held a shared_ptr<>. Failure to do so can lead to dangling references to objects passed to PBD::Signals.
-					 *
-					 * Note that this method (::handle_ui_requests()) is by definition called from the event loop thread, so
-					 * caller_is_self() is true, which means that the execution of the functor has definitely happened after
-					 * do_request() returns and we no longer need the functor for any reason.
-					 */
-
-					if (vec.buf[0]->type == CallSlot) {
-						vec.buf[0]->the_slot = 0;
-					}
-
-					request_buffer_map_lock.lock ();
-					if (vec.buf[0]->invalidation) {
-						DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: removing invalidation record for that request\n", event_loop_name()));
-						vec.buf[0]->invalidation->requests.remove (vec.buf[0]);
-					} else {
-						DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: no invalidation record for that request\n", event_loop_name()));
-					}
-				} else {
-					DEBUG_TRACE (PBD::DEBUG::AbstractUI, "invalid request, ignoring\n");
+			}
+
+			RequestObject* req = vec.buf[0];
+
+			if (req->is_valid ()) {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1: valid request, calling ::do_request()\n", event_loop_name()));
+				do_request (req);
+				note_request_dispatched ();
+
+				/* if the request was CallSlot, then we need to ensure that we reset the functor in the request, in case it
+				 * held a shared_ptr<>. Failure to do so can lead to dangling references to objects passed to PBD::Signals.
+				 *
+				 * Note that this method (::handle_ui_requests()) is by definition called from the event loop thread, so
+				 * caller_is_self() is true, which means that the execution of the functor has definitely happened after
+				 * do_request() returns and we no longer need the functor for any reason.
+				 */
+
+				if (req->type == CallSlot) {
+					req->the_slot = 0;
 				}
-				i->second->increment_read_ptr (1);
+			} else {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, "invalid request, ignoring\n");
+				note_request_invalidated ();
+				req->the_slot = 0;
+			}
+
+			/* the request is done: drop its reference to the invalidation record */
+			if (req->invalidation) {
+				req->invalidation->unref ();
+				req->invalidation = 0;
 			}
+
+			rbuf->increment_read_ptr (1);
 		}
 	}
 
 	/* clean up any dead request buffers (their thread has exited) */
 
-	for (i = request_buffers.begin(); i != request_buffers.end(); ) {
-		if ((*i).second->dead) {
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 deleting dead per-thread request buffer for %3 @ %4\n",
-			                                                     event_loop_name(), pthread_name(), i->second));
-			/* remove it from the EventLoop static map of all request buffers */
-			EventLoop::remove_request_buffer_from_map ((*i).second);
-			/* delete it */
-			delete (*i).second;
-			RequestBufferMapIterator tmp = i;
-			++tmp;
-			/* remove it from this thread's list of request buffers */
-			request_buffers.erase (i);
-			i = tmp;
-		} else {
-			++i;
+	if (outermost) {
+		Glib::Threads::Mutex::Lock lm (request_buffer_map_lock);
+
+		for (i = request_buffers.begin(); i != request_buffers.end(); ) {
+			if ((*i).second->dead) {
+				DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 deleting dead per-thread request buffer for %3 @ %4\n",
+				                                                     event_loop_name(), pthread_name(), i->second));
+				/* remove it from the EventLoop static map of all request buffers */
+				EventLoop::remove_request_buffer_from_map ((*i).second);
+				/* delete it */
+				delete (*i).second;
+				RequestBufferMapIterator tmp = i;
+				++tmp;
+				/* remove it from this thread's list of request buffers */
+				request_buffers.erase (i);
+				i = tmp;
+			} else {
+				++i;
+			}
 		}
 	}
 
-	request_buffer_map_lock.unlock ();
-
-	/* and now, the generic request buffer. same rules as above apply */
+	/* and now, the generic request buffer. same rules as above apply.
+	 * grab all requests queued so far at once, so that the list lock
+	 * is taken only once per batch, not once per request.
+	 */
 
-	Glib::Threads::Mutex::Lock lm (request_list_lock);
+	std::list<RequestObject*> batch;
 
-	while (!request_list.empty()) {
-		RequestObject* req = request_list.front ();
-		request_list.pop_front ();
+	{
+		Glib::Threads::Mutex::Lock lm (request_list_lock);
+		batch.splice (batch.end(), request_list);
+	}
 
-		/* We need to use this lock, because its the one
-		 * returned by slot_invalidation_mutex() and protects
-		 * against request invalidation.
-		 */
+	while (!batch.empty()) {
+		RequestObject* req = batch.front ();
+		batch.pop_front ();
 
-		request_buffer_map_lock.lock ();
-		if (!req->valid) {
+		if (!req->is_valid ()) {
 			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 handling invalid heap request, type %3, deleting\n", event_loop_name(), pthread_name(), req->type));
+			note_request_invalidated ();
+			if (req->invalidation) {
+				req->invalidation->unref ();
+			}
 			delete req;
-			request_buffer_map_lock.unlock ();
 			continue;
 		}
 
-		/* we're about to execute this request, so its
-		 * too late for any invalidation. mark
-		 * the request as "done" before we start.
-		 */
-
-		if (req->invalidation) {
-			DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 remove request from its invalidation list\n", event_loop_name(), pthread_name()));
-
-			/* after this call, if the object referenced by the
-			 * invalidation record is deleted, it will no longer
-			 * try to mark the request as invalid.
-			 */
-
-			req->invalidation->requests.remove (req);
-		}
-
 		/* at this point, an object involved in a functor could be
 		 * deleted before we actually execute the functor. so there is
 		 * a race condition that makes the invalidation architecture
@@ -320,15 +350,6 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 		 * references to objects to enter into the request queue.
 		 */
 
-		request_buffer_map_lock.unlock ();
-
-		/* unlock the request lock while we execute the request, so
-		 * that we don't needlessly block other threads (note: not RT
-		 * threads since they have their own queue) from making requests.
-		 */
-
-		lm.release ();
-
 		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 execute request type %3\n", event_loop_name(), pthread_name(), req->type));
 
 		/* and lets do it ... this is a virtual call so that each
@@ -337,14 +358,24 @@ AbstractUI<RequestObject>::handle_ui_requests ()
 		 */
 
 		do_request (req);
+		note_request_dispatched ();
+
+		if (req->invalidation) {
+			req->invalidation->unref ();
+		}
 
 		DEBUG_TRACE (PBD::DEBUG::AbstractUI, string_compose ("%1/%2 delete heap request type %3\n", event_loop_name(), pthread_name(), req->type));
 		delete req;
+	}
 
-		/* re-acquire the list lock so that we check again */
+	/* finally delete invalidation records that are no longer used by any request */
 
-		lm.acquire();
+	if (outermost) {
+		Glib::Threads::Mutex::Lock lm (request_buffer_map_lock);
+		empty_trash ();
 	}
+
+	--_dispatch_depth;
 }
 
 template <typename RequestObject> void
@@ -434,7 +465,7 @@ AbstractUI<RequestObject>::call_slot (InvalidationRecord* invalidation, const bo
 	req->invalidation = invalidation;
 
 	if (invalidation) {
-		invalidation->requests.push_back (req);
+		invalidation->ref ();
 		invalidation->event_loop = this;
 	}
 
@@ -20,6 +20,7 @@
 #ifndef __pbd_abstract_ui_h__
 #define __pbd_abstract_ui_h__
 
+#include <list>
 #include <map>
 #include <string>
 #include <pthread.h>
@@ -96,6 +97,8 @@ class ABSTRACT_UI_API AbstractUI : public BaseUI
 	Glib::Threads::Mutex               request_list_lock;
 	std::list<RequestObject*> request_list;
 
+	int _dispatch_depth; ///< recursion depth of handle_ui_requests()
+
 	RequestObject* get_request (RequestType);
 	void handle_ui_requests ();
 	void send_request (RequestObject *);
@@ -20,6 +20,7 @@
 #ifndef __pbd_event_loop_h__
 #define __pbd_event_loop_h__
 
+#include <list>
 #include <string>
 #include <vector>
 #include <map>
@@ -27,6 +28,7 @@
 #include <boost/bind.hpp> /* we don't need this here, but anything calling call_slot() probably will, so this is convenient */
 #include <stdint.h>
 #include <pthread.h>
+#include <glib.h>
 #include <glibmm/threads.h>
 
 #include "pbd/libpbd_visibility.h"
@@ -55,13 +57,24 @@ class LIBPBD_API EventLoop
 
         struct BaseRequestObject;
 
+        /* An InvalidationRecord does not keep track of the requests that
+         * use it. Each queued request holds a reference, and the record is
+         * marked invalid when the object it refers to is destroyed. Queueing,
+         * dispatching and invalidating requests are thereby all O(1).
+         */
         struct InvalidationRecord {
-	    std::list<BaseRequestObject*> requests;
 	    PBD::EventLoop* event_loop;
+	    gint _valid;
+	    gint _ref;
 	    const char* file;
 	    int line;
 
-	    InvalidationRecord() : event_loop (0) {}
+	    InvalidationRecord() : event_loop (0), _valid (1), _ref (0) {}
+	    void invalidate () { g_atomic_int_set (&_valid, 0); }
+	    bool valid () { return g_atomic_int_get (&_valid) == 1; }
+	    void ref ()   { g_atomic_int_inc (&_ref); }
+	    void unref () { (void) g_atomic_int_dec_and_test (&_ref); }
+	    bool in_use () { return g_atomic_int_get (&_ref) > 0; }
         };
 
         static void* invalidate_request (void* data);
@@ -73,8 +86,28 @@ class LIBPBD_API EventLoop
 	    boost::function<void()> the_slot;
 
             BaseRequestObject() : valid (true), invalidation (0) {}
+
+	    /** @return true if the request has neither been invalidated
+	     * directly nor via the object its functor refers to
+	     */
+	    bool is_valid () const { return valid && (!invalidation || invalidation->valid ()); }
+	};
+
+	/** Request dispatch statistics, per event loop */
+	struct RequestStats {
+		uint64_t dispatched;           ///< total requests executed
+		uint64_t dropped;              ///< requests lost because a per-thread request buffer was full
+		uint64_t invalidated;          ///< requests skipped because their target was destroyed
+		uint32_t queue_depth;          ///< requests found pending at the start of the last dispatch
+		uint32_t max_queue_depth;      ///< largest queue_depth seen since the last reset
+		double   requests_per_second;  ///< dispatch rate since the previous call to get_request_stats()
+
+		RequestStats () : dispatched (0), dropped (0), invalidated (0), queue_depth (0), max_queue_depth (0), requests_per_second (0) {}
 	};
 
+	RequestStats get_request_stats ();
+	void reset_request_stats ();
+
 	virtual void call_slot (InvalidationRecord*, const boost::function<void()>&) = 0;
         virtual Glib::Threads::Mutex& slot_invalidation_mutex() = 0;
 
@@ -95,7 +128,30 @@ class LIBPBD_API EventLoop
 	static void pre_register (const std::string& emitting_thread_name, uint32_t num_requests);
 	static void remove_request_buffer_from_map (void* ptr);
 
+  protected:
+	/* invalidated records that are still referenced by queued requests.
+	 * protected by slot_invalidation_mutex(), deleted by the event loop
+	 * once the last request using them has been handled.
+	 */
+	std::list<InvalidationRecord*> trash;
+	void empty_trash ();
+
+	void note_request_dispatched () { g_atomic_int_inc (&_stats_dispatched); }
+	void note_request_dropped () { g_atomic_int_inc (&_stats_dropped); }
+	void note_request_invalidated () { g_atomic_int_inc (&_stats_invalidated); }
+	void note_queue_depth (uint32_t);
+
   private:
+	gint     _stats_dispatched;
+	gint     _stats_dropped;
+	gint     _stats_invalidated;
+	gint     _stats_queue_depth;
+	gint     _stats_max_queue_depth;
+	uint64_t _stats_total_dispatched;
+	uint64_t _stats_total_dropped;
+	uint64_t _stats_total_invalidated;
+	gint64   _stats_last_query;
+
         static Glib::Threads::Private<EventLoop> thread_event_loop;
 	std::string _name;
 
@@ -0,0 +1,147 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_mpsc_queue_h__
+#define __pbd_mpsc_queue_h__
+
+#include <glib.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** A bounded, lock-free queue for any number of writer threads and a single
+ * reader (e.g. the process thread).
+ *
+ * A writer claims a slot with write_reserve(), fills in the element in
+ * place (so elements can keep and re-use their own storage) and hands it
+ * to the reader with write_commit(). Writers never wait for each other; a
+ * writer that is pre-empted between reserve and commit only holds up the
+ * reader, for the slots claimed after its own.
+ *
+ * The reader looks at as many consecutive committed elements as it likes
+ * using read_space() and read_peek(), and hands them back to the writers
+ * in one go with read_release().
+ *
+ * After D. Vyukov's bounded MPMC queue, with a single reader.
+ */
+template<class T>
+class /*LIBPBD_API*/ MPSCQueue
+{
+  public:
+	MPSCQueue (guint sz) {
+		for (_size = 1; _size < sz; _size <<= 1) {}
+		_mask = _size - 1;
+		_cells = new Cell[_size];
+		for (guint i = 0; i < _size; ++i) {
+			g_atomic_int_set (&_cells[i].sequence, i);
+		}
+		g_atomic_int_set (&_write_pos, 0);
+		g_atomic_int_set (&_read_pos, 0);
+	}
+
+	~MPSCQueue () {
+		delete [] _cells;
+	}
+
+	guint bufsize () const { return _size; }
+
+	/* writer side, any thread */
+
+	/** claim a slot, to be passed to write_commit() when it is filled in.
+	 * @param id set to the position of the slot
+	 * @return the element in the slot, or 0 if the queue is full
+	 */
+	T* write_reserve (guint& id) {
+		guint pos = g_atomic_int_get (&_write_pos);
+		for (;;) {
+			Cell& c (_cells[pos & _mask]);
+			const gint dif = (gint) ((guint) g_atomic_int_get (&c.sequence) - pos);
+			if (dif == 0) {
+				if (g_atomic_int_compare_and_exchange (&_write_pos, (gint) pos, (gint) (pos + 1))) {
+					id = pos;
+					return &c.data;
+				}
+			} else if (dif < 0) {
+				/* the reader has not yet released this slot */
+				return 0;
+			}
+			/* another writer got there first */
+			pos = g_atomic_int_get (&_write_pos);
+		}
+	}
+
+	/** make the element in slot @param id visible to the reader */
+	void write_commit (guint id) {
+		g_atomic_int_set (&_cells[id & _mask].sequence, (gint) (id + 1));
+	}
+
+	/** @return true if everything written has been released by the reader */
+	bool empty () const {
+		return g_atomic_int_get (&_write_pos) == g_atomic_int_get (&_read_pos);
+	}
+
+	/* reader side, a single thread */
+
+	/** @return the number of consecutive committed elements, at most @param max */
+	guint read_space (guint max = G_MAXUINT) const {
+		const guint rp = g_atomic_int_get (&_read_pos);
+		guint n = 0;
+		while (n < max && n < _size) {
+			if ((guint) g_atomic_int_get (&_cells[(rp + n) & _mask].sequence) != rp + n + 1) {
+				break;
+			}
+			++n;
+		}
+		return n;
+	}
+
+	/** @return the @param n th committed element; n must be less than read_space() */
+	T& read_peek (guint n) {
+		return _cells[(g_atomic_int_get (&_read_pos) + n) & _mask].data;
+	}
+
+	/** hand the first @param cnt committed elements back to the writers */
+	void read_release (guint cnt) {
+		const guint rp = g_atomic_int_get (&_read_pos);
+		for (guint n = 0; n < cnt; ++n) {
+			g_atomic_int_set (&_cells[(rp + n) & _mask].sequence, (gint) (rp + n + _size));
+		}
+		g_atomic_int_set (&_read_pos, (gint) (rp + cnt));
+	}
+
+  private:
+	struct Cell {
+		mutable gint sequence;
+		T data;
+	};
+
+	Cell*        _cells;
+	guint        _size;
+	guint        _mask;
+	mutable gint _write_pos;
+	mutable gint _read_pos;
+
+	MPSCQueue (MPSCQueue const&);
+	MPSCQueue& operator= (MPSCQueue const&);
+};
+
+} /* namespace PBD */
+
+#endif /* __pbd_mpsc_queue_h__ */
@@ -0,0 +1,87 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __pbd_rt_monitor_h__
+#define __pbd_rt_monitor_h__
+
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+#include "pbd/libpbd_visibility.h"
+
+namespace PBD {
+
+/** Runtime monitor for realtime-safety violations.
+ *
+ * Unlike DEBUG_RT_ALLOC (which aborts on the first allocation), this
+ * only counts: realtime threads (engine process and graph threads)
+ * register themselves, and while the monitor is enabled, heap allocations,
+ * contended mutex locks and blocking system calls made by those threads
+ * are counted. For each distinct call site a backtrace is kept, and
+ * reported via report().
+ *
+ * Allocations (malloc, calloc, realloc, posix_memalign), mutex locks and
+ * blocking system calls are intercepted; this is built in by default on
+ * Linux (see available(), configure with --no-rt-monitor to leave it out).
+ * While the monitor is disabled the cost is a single atomic read per
+ * intercepted call. Realtime code also reports events which cannot be
+ * intercepted, e.g. a cycle skipped because a try-lock failed, via note_event().
+ */
+namespace RTMonitor {
+
+enum EventType {
+	HeapAllocation = 0,
+	LockWait,
+	SystemCall,
+	NumEventTypes
+};
+
+/** mark the calling thread as one that must not allocate or block.
+ * Only realtime threads should register; worker threads that are
+ * expected to do I/O (e.g. the butler) must not.
+ * Not realtime-safe, call at thread startup.
+ */
+LIBPBD_API void register_thread (const char* name);
+/** the calling thread will no longer be monitored (counts are kept for the report) */
+LIBPBD_API void unregister_thread ();
+
+LIBPBD_API bool available ();
+LIBPBD_API bool enabled ();
+LIBPBD_API void set_enabled (bool yn);
+
+/** also record backtraces of distinct call sites (default: on) */
+LIBPBD_API void set_record_call_sites (bool yn);
+
+/** count an event for the calling thread, if it is monitored and the monitor is enabled */
+LIBPBD_API void note_event (EventType);
+
+/** @return number of events of the given type observed in all monitored threads */
+LIBPBD_API uint64_t event_count (EventType);
+
+LIBPBD_API void reset ();
+LIBPBD_API void report (std::ostream&);
+LIBPBD_API std::string report ();
+
+LIBPBD_API const char* event_type_name (EventType);
+
+} /* namespace RTMonitor */
+} /* namespace PBD */
+
+#endif /* __pbd_rt_monitor_h__ */
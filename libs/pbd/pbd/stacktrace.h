@@ -40,6 +40,8 @@
 namespace PBD {
 
 	LIBPBD_API void stacktrace (std::ostream& out, int levels = 0);
+	/** print a backtrace that was previously captured with backtrace() */
+	LIBPBD_API void stacktrace (std::ostream& out, void* const* frames, int n_frames);
 	LIBPBD_API void trace_twb();
 
 template<typename T>
@@ -0,0 +1,608 @@
+/*
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "libpbd-config.h"
+
+#ifdef RT_MONITOR
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <dlfcn.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <sstream>
+
+#include <glib.h>
+#include <pthread.h>
+
+#ifdef HAVE_EXECINFO
+#include <execinfo.h>
+#endif
+
+#include "pbd/compose.h"
+#include "pbd/rt_monitor.h"
+#include "pbd/stacktrace.h"
+
+using namespace PBD;
+
+namespace {
+
+static const int max_threads = 64;
+static const int max_call_sites = 32;
+static const int max_frames = 24;
+/* record_event() itself; the next frame names the intercepted function */
+static const int skip_frames = 1;
+
+struct CallSite {
+	RTMonitor::EventType type;
+	int   n_frames;
+	void* frames[max_frames];
+	gint  hits;
+};
+
+struct ThreadStats {
+	gint     in_use;
+	gint     active;
+	char     name[64];
+	gint     counts[RTMonitor::NumEventTypes];
+	gint     n_sites;
+	CallSite sites[max_call_sites];
+	int      busy; /* recursion guard: only touched by the owning thread */
+};
+
+static ThreadStats   thread_stats[max_threads];
+static pthread_key_t stats_key;
+static gint          key_created = 0;
+static gint          monitor_enabled = 0;
+static gint          record_sites = 1;
+
+static void
+make_key ()
+{
+	(void) pthread_key_create (&stats_key, NULL);
+	g_atomic_int_set (&key_created, 1);
+}
+
+static pthread_once_t  key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t registration_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* must not allocate, lock or make system calls */
+static inline ThreadStats*
+monitored_thread ()
+{
+	if (G_LIKELY (!g_atomic_int_get (&monitor_enabled))) {
+		return 0;
+	}
+	if (!g_atomic_int_get (&key_created)) {
+		return 0;
+	}
+	ThreadStats* ts = (ThreadStats*) pthread_getspecific (stats_key);
+	if (!ts || ts->busy || !g_atomic_int_get (&ts->active)) {
+		return 0;
+	}
+	return ts;
+}
+
+static void
+record_event (ThreadStats* ts, RTMonitor::EventType type)
+{
+	/* backtrace() may itself call into intercepted functions */
+	ts->busy = 1;
+
+	g_atomic_int_inc (&ts->counts[type]);
+
+#ifdef HAVE_EXECINFO
+	if (g_atomic_int_get (&record_sites)) {
+		void* frames[max_frames + skip_frames];
+		int n = backtrace (frames, max_frames + skip_frames) - skip_frames;
+
+		if (n > 0) {
+			void** caller = &frames[skip_frames];
+			const int n_sites = g_atomic_int_get (&ts->n_sites);
+			int i;
+
+			for (i = 0; i < n_sites; ++i) {
+				CallSite& cs (ts->sites[i]);
+				if (cs.type == type && cs.n_frames == n && !memcmp (cs.frames, caller, n * sizeof (void*))) {
+					g_atomic_int_inc (&cs.hits);
+					break;
+				}
+			}
+
+			if (i == n_sites && n_sites < max_call_sites) {
+				CallSite& cs (ts->sites[n_sites]);
+				cs.type = type;
+				cs.n_frames = n;
+				memcpy (cs.frames, caller, n * sizeof (void*));
+				g_atomic_int_set (&cs.hits, 1);
+				/* publish */
+				g_atomic_int_set (&ts->n_sites, n_sites + 1);
+			}
+		}
+	}
+#endif
+
+	ts->busy = 0;
+}
+
+} /* anon namespace */
+
+void
+RTMonitor::register_thread (const char* name)
+{
+	(void) pthread_once (&key_once, make_key);
+
+	if (pthread_getspecific (stats_key)) {
+		g_atomic_int_set (&((ThreadStats*) pthread_getspecific (stats_key))->active, 1);
+		return;
+	}
+
+	ThreadStats* ts = 0;
+
+	pthread_mutex_lock (&registration_lock);
+
+	/* re-use the slot of an earlier thread with the same name,
+	 * e.g. process threads restarted with the engine.
+	 */
+	for (int i = 0; i < max_threads; ++i) {
+		if (g_atomic_int_get (&thread_stats[i].in_use) && !g_atomic_int_get (&thread_stats[i].active)
+		    && !strncmp (thread_stats[i].name, name, sizeof (thread_stats[i].name))) {
+			ts = &thread_stats[i];
+			break;
+		}
+	}
+
+	for (int i = 0; !ts && i < max_threads; ++i) {
+		if (!g_atomic_int_get (&thread_stats[i].in_use)) {
+			ts = &thread_stats[i];
+			strncpy (ts->name, name, sizeof (ts->name) - 1);
+			ts->name[sizeof (ts->name) - 1] = '\0';
+			g_atomic_int_set (&ts->in_use, 1);
+		}
+	}
+
+	if (ts) {
+		/* claim it before another thread can re-use it */
+		g_atomic_int_set (&ts->active, 1);
+	}
+
+	pthread_mutex_unlock (&registration_lock);
+
+	if (!ts) {
+		return;
+	}
+
+#ifdef HAVE_EXECINFO
+	/* the first call to backtrace() loads libgcc, do that now rather
+	 * than from the realtime context.
+	 */
+	void* dummy[2];
+	(void) backtrace (dummy, 2);
+#endif
+
+	ts->busy = 0;
+	pthread_setspecific (stats_key, ts);
+}
+
+void
+RTMonitor::unregister_thread ()
+{
+	if (!g_atomic_int_get (&key_created)) {
+		return;
+	}
+	ThreadStats* ts = (ThreadStats*) pthread_getspecific (stats_key);
+	if (ts) {
+		g_atomic_int_set (&ts->active, 0);
+		pthread_setspecific (stats_key, 0);
+	}
+}
+
+bool
+RTMonitor::available ()
+{
+#ifdef RT_MONITOR
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool
+RTMonitor::enabled ()
+{
+	return g_atomic_int_get (&monitor_enabled);
+}
+
+void
+RTMonitor::set_enabled (bool yn)
+{
+	g_atomic_int_set (&monitor_enabled, yn ? 1 : 0);
+}
+
+void
+RTMonitor::set_record_call_sites (bool yn)
+{
+	g_atomic_int_set (&record_sites, yn ? 1 : 0);
+}
+
+void
+RTMonitor::note_event (EventType type)
+{
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, type);
+	}
+}
+
+uint64_t
+RTMonitor::event_count (EventType type)
+{
+	uint64_t n = 0;
+	for (int i = 0; i < max_threads; ++i) {
+		if (g_atomic_int_get (&thread_stats[i].in_use)) {
+			n += g_atomic_int_get (&thread_stats[i].counts[type]);
+		}
+	}
+	return n;
+}
+
+void
+RTMonitor::reset ()
+{
+	/* monitored threads may record concurrently; at worst an event
+	 * counted during the reset survives it.
+	 */
+	for (int i = 0; i < max_threads; ++i) {
+		ThreadStats& ts (thread_stats[i]);
+		g_atomic_int_set (&ts.n_sites, 0);
+		for (int t = 0; t < NumEventTypes; ++t) {
+			g_atomic_int_set (&ts.counts[t], 0);
+		}
+	}
+}
+
+const char*
+RTMonitor::event_type_name (EventType type)
+{
+	switch (type) {
+	case HeapAllocation:
+		return "heap allocation";
+	case LockWait:
+		return "lock contention";
+	case SystemCall:
+		return "system call";
+	default:
+		break;
+	}
+	return "unknown";
+}
+
+void
+RTMonitor::report (std::ostream& out)
+{
+	out << "RT monitor: " << (enabled () ? "enabled" : "disabled")
+	    << (available () ? "" : " (interception not compiled in)") << std::endl;
+
+	for (int i = 0; i < max_threads; ++i) {
+		ThreadStats& ts (thread_stats[i]);
+
+		if (!g_atomic_int_get (&ts.in_use)) {
+			continue;
+		}
+
+		out << string_compose ("Thread '%1'%2:", ts.name, g_atomic_int_get (&ts.active) ? "" : " (exited)");
+		for (int t = 0; t < NumEventTypes; ++t) {
+			out << string_compose (" %1: %2", event_type_name ((EventType) t), g_atomic_int_get (&ts.counts[t]));
+		}
+		out << std::endl;
+
+		const int n_sites = g_atomic_int_get (&ts.n_sites);
+		for (int s = 0; s < n_sites; ++s) {
+			CallSite& cs (ts.sites[s]);
+			out << string_compose ("  -- %1, %2 times from:", event_type_name (cs.type), g_atomic_int_get (&cs.hits)) << std::endl;
+			PBD::stacktrace (out, cs.frames, cs.n_frames);
+		}
+	}
+}
+
+std::string
+RTMonitor::report ()
+{
+	std::stringstream ss;
+	report (ss);
+	return ss.str ();
+}
+
+#ifdef RT_MONITOR
+
+/* Interposers. With ELF symbol interposition these take precedence over
+ * the libc/glib functions for the whole process, so they must be cheap
+ * when the monitor is disabled: one atomic read (see monitored_thread()).
+ *
+ * The real allocators are resolved once at load time. dlsym() itself may
+ * allocate (glibc uses calloc() for its error state), allocations made
+ * while resolving are served from a static bootstrap buffer, which is
+ * never returned to the real free().
+ */
+
+namespace {
+
+static void* (*real_malloc) (size_t) = 0;
+static void* (*real_calloc) (size_t, size_t) = 0;
+static void* (*real_realloc) (void*, size_t) = 0;
+static void  (*real_free) (void*) = 0;
+static int   (*real_posix_memalign) (void**, size_t, size_t) = 0;
+
+static const size_t bootstrap_align = 16;
+static char         bootstrap_buf[16384] __attribute__ ((aligned (16)));
+static gint         bootstrap_used = 0;
+static gint         resolving = 0;
+
+static inline bool
+is_bootstrap (void const* p)
+{
+	return (char const*) p >= bootstrap_buf && (char const*) p < bootstrap_buf + sizeof (bootstrap_buf);
+}
+
+/* each chunk is preceded by its size, for realloc() */
+static void*
+bootstrap_alloc (size_t s, size_t align)
+{
+	if (align < bootstrap_align) {
+		align = bootstrap_align;
+	}
+	const size_t chunk = ((s + bootstrap_align - 1) & ~(bootstrap_align - 1)) + align;
+	const size_t start = g_atomic_int_add (&bootstrap_used, (gint) chunk);
+
+	if (start + chunk > sizeof (bootstrap_buf)) {
+		return 0;
+	}
+
+	char* p = bootstrap_buf + start + align;
+	*((size_t*) (p - sizeof (size_t))) = s;
+	return p; /* static storage is zero-initialized, good for calloc() too */
+}
+
+static inline size_t
+bootstrap_size (void const* p)
+{
+	return *((size_t const*) ((char const*) p - sizeof (size_t)));
+}
+
+static void
+resolve_allocators ()
+{
+	if (!g_atomic_int_compare_and_exchange (&resolving, 0, 1)) {
+		return;
+	}
+	real_malloc = (void* (*) (size_t)) dlsym (RTLD_NEXT, "malloc");
+	real_calloc = (void* (*) (size_t, size_t)) dlsym (RTLD_NEXT, "calloc");
+	real_realloc = (void* (*) (void*, size_t)) dlsym (RTLD_NEXT, "realloc");
+	real_free = (void (*) (void*)) dlsym (RTLD_NEXT, "free");
+	real_posix_memalign = (int (*) (void**, size_t, size_t)) dlsym (RTLD_NEXT, "posix_memalign");
+	g_atomic_int_set (&resolving, 0);
+}
+
+/* Allocations can happen before this runs (other libraries' constructors),
+ * hence the fallback in the interposers below; this only makes sure that
+ * nothing is resolved lazily from a realtime thread.
+ */
+__attribute__ ((constructor)) static void
+rt_monitor_init ()
+{
+	if (!real_free) {
+		resolve_allocators ();
+	}
+}
+
+} /* anon namespace */
+
+/* The remaining functions are not used by dlsym(), a lazy lookup is safe */
+#define RTM_REAL(ret, fn, args) \
+	static ret (*real_ ## fn) args = 0; \
+	if (G_UNLIKELY (!real_ ## fn)) { real_ ## fn = (ret (*) args) dlsym (RTLD_NEXT, #fn); }
+
+extern "C" {
+
+void*
+malloc (size_t s)
+{
+	if (G_UNLIKELY (!real_malloc)) {
+		resolve_allocators ();
+		if (!real_malloc) {
+			return bootstrap_alloc (s, 0);
+		}
+	}
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::HeapAllocation);
+	}
+	return real_malloc (s);
+}
+
+void*
+calloc (size_t n, size_t s)
+{
+	if (G_UNLIKELY (!real_calloc)) {
+		resolve_allocators ();
+		if (!real_calloc) {
+			if (s && n > (size_t) -1 / s) {
+				return 0;
+			}
+			return bootstrap_alloc (n * s, 0);
+		}
+	}
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::HeapAllocation);
+	}
+	return real_calloc (n, s);
+}
+
+void*
+realloc (void* p, size_t s)
+{
+	if (G_UNLIKELY (!real_realloc || is_bootstrap (p))) {
+		if (!real_realloc) {
+			resolve_allocators ();
+		}
+		if (!real_realloc || is_bootstrap (p)) {
+			/* bootstrap chunks are never moved into the real heap
+			 * by the real realloc(), copy them.
+			 */
+			void* n = real_malloc ? real_malloc (s) : bootstrap_alloc (s, 0);
+			if (n && p) {
+				const size_t o = bootstrap_size (p);
+				memcpy (n, p, o < s ? o : s);
+			}
+			return n;
+		}
+	}
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::HeapAllocation);
+	}
+	return real_realloc (p, s);
+}
+
+int
+posix_memalign (void** ptr, size_t align, size_t s)
+{
+	if (G_UNLIKELY (!real_posix_memalign)) {
+		resolve_allocators ();
+		if (!real_posix_memalign) {
+			*ptr = bootstrap_alloc (s, align);
+			return *ptr ? 0 : ENOMEM;
+		}
+	}
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::HeapAllocation);
+	}
+	return real_posix_memalign (ptr, align, s);
+}
+
+void
+free (void* p)
+{
+	if (G_UNLIKELY (!p || is_bootstrap (p))) {
+		return;
+	}
+	if (G_UNLIKELY (!real_free)) {
+		resolve_allocators ();
+		if (!real_free) {
+			/* leak; only possible while resolving */
+			return;
+		}
+	}
+	real_free (p);
+}
+
+int
+pthread_mutex_lock (pthread_mutex_t* m)
+{
+	RTM_REAL (int, pthread_mutex_lock, (pthread_mutex_t*));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		RTM_REAL (int, pthread_mutex_trylock, (pthread_mutex_t*));
+		if (real_pthread_mutex_trylock (m) == 0) {
+			return 0;
+		}
+		record_event (ts, RTMonitor::LockWait);
+	}
+	return real_pthread_mutex_lock (m);
+}
+
+void
+g_mutex_lock (GMutex* m)
+{
+	RTM_REAL (void, g_mutex_lock, (GMutex*));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		if (g_mutex_trylock (m)) {
+			return;
+		}
+		record_event (ts, RTMonitor::LockWait);
+	}
+	real_g_mutex_lock (m);
+}
+
+ssize_t
+read (int fd, void* buf, size_t n)
+{
+	RTM_REAL (ssize_t, read, (int, void*, size_t));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::SystemCall);
+	}
+	return real_read (fd, buf, n);
+}
+
+ssize_t
+write (int fd, const void* buf, size_t n)
+{
+	RTM_REAL (ssize_t, write, (int, const void*, size_t));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::SystemCall);
+	}
+	return real_write (fd, buf, n);
+}
+
+int
+poll (struct pollfd* fds, nfds_t nfds, int timeout)
+{
+	RTM_REAL (int, poll, (struct pollfd*, nfds_t, int));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::SystemCall);
+	}
+	return real_poll (fds, nfds, timeout);
+}
+
+int
+usleep (useconds_t usec)
+{
+	RTM_REAL (int, usleep, (useconds_t));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::SystemCall);
+	}
+	return real_usleep (usec);
+}
+
+int
+nanosleep (const struct timespec* req, struct timespec* rem)
+{
+	RTM_REAL (int, nanosleep, (const struct timespec*, struct timespec*));
+	ThreadStats* ts = monitored_thread ();
+	if (ts) {
+		record_event (ts, RTMonitor::SystemCall);
+	}
+	return real_nanosleep (req, rem);
+}
+
+} /* extern "C" */
+
+#endif /* RT_MONITOR */
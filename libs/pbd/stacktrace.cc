@@ -71,6 +71,26 @@ PBD::stacktrace (std::ostream& out, int levels)
 	}
 }
 
+void
+PBD::stacktrace (std::ostream& out, void* const* frames, int n_frames)
+{
+	char **strings;
+
+	if (n_frames <= 0) {
+		out << "no stacktrace available!" << std::endl;
+		return;
+	}
+
+	strings = backtrace_symbols (frames, n_frames);
+
+	if (strings) {
+		for (int i = 0; i < n_frames; i++) {
+			out << "  " << demangle (strings[i]) << std::endl;
+		}
+		free (strings);
+	}
+}
+
 #elif defined (PLATFORM_WINDOWS)
 
 #if defined DEBUG && !defined CaptureStackBackTrace
@@ -132,6 +152,14 @@ PBD::stacktrace (std::ostream& out, int /*levels*/)
 
 #endif
 
+#ifndef HAVE_EXECINFO
+void
+PBD::stacktrace (std::ostream& out, void* const*, int)
+{
+	out << "stack tracing is not enabled on this platform" << std::endl;
+}
+#endif
+
 void
 c_stacktrace ()
 {
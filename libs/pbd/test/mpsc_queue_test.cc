@@ -0,0 +1,135 @@
+#include <pthread.h>
+#include <vector>
+
+#include <glib.h>
+
+#include "mpsc_queue_test.h"
+#include "pbd/mpsc_queue.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MPSCQueueTest);
+
+using namespace std;
+using namespace PBD;
+
+struct Item {
+	Item () : writer (0), seq (0) {}
+	guint writer;
+	guint seq;
+};
+
+void
+MPSCQueueTest::testBasic ()
+{
+	MPSCQueue<Item> q (5);
+	CPPUNIT_ASSERT_EQUAL ((guint) 8, q.bufsize ());
+	CPPUNIT_ASSERT (q.empty ());
+
+	guint ids[8];
+
+	for (guint i = 0; i < 8; ++i) {
+		Item* it = q.write_reserve (ids[i]);
+		CPPUNIT_ASSERT (it);
+		it->seq = i;
+	}
+
+	guint id;
+	CPPUNIT_ASSERT (q.write_reserve (id) == 0);
+
+	/* nothing is visible to the reader until it is committed, in order */
+	CPPUNIT_ASSERT_EQUAL ((guint) 0, q.read_space ());
+	q.write_commit (ids[1]);
+	CPPUNIT_ASSERT_EQUAL ((guint) 0, q.read_space ());
+	q.write_commit (ids[0]);
+	CPPUNIT_ASSERT_EQUAL ((guint) 2, q.read_space ());
+
+	for (guint i = 2; i < 8; ++i) {
+		q.write_commit (ids[i]);
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((guint) 8, q.read_space ());
+	CPPUNIT_ASSERT_EQUAL ((guint) 3, q.read_space (3));
+
+	for (guint i = 0; i < 3; ++i) {
+		CPPUNIT_ASSERT_EQUAL (i, q.read_peek (i).seq);
+	}
+
+	q.read_release (3);
+	CPPUNIT_ASSERT_EQUAL ((guint) 5, q.read_space ());
+	CPPUNIT_ASSERT_EQUAL ((guint) 3, q.read_peek (0).seq);
+	CPPUNIT_ASSERT (!q.empty ());
+
+	/* released slots can be written again */
+	CPPUNIT_ASSERT (q.write_reserve (id) != 0);
+	q.write_commit (id);
+
+	q.read_release (q.read_space ());
+	CPPUNIT_ASSERT (q.empty ());
+}
+
+static const guint n_writers = 4;
+static const guint n_items = 200000;
+
+static MPSCQueue<Item>* stress_queue;
+
+static void*
+writer_thread (void* arg)
+{
+	const guint writer = (guint) (intptr_t) arg;
+
+	for (guint seq = 0; seq < n_items; ) {
+		guint id;
+		Item* it = stress_queue->write_reserve (id);
+		if (!it) {
+			/* full, let the reader catch up */
+			g_thread_yield ();
+			continue;
+		}
+		it->writer = writer;
+		it->seq = seq++;
+		stress_queue->write_commit (id);
+	}
+
+	return 0;
+}
+
+void
+MPSCQueueTest::testStress ()
+{
+	stress_queue = new MPSCQueue<Item> (256);
+
+	pthread_t threads[n_writers];
+
+	for (guint i = 0; i < n_writers; ++i) {
+		CPPUNIT_ASSERT_EQUAL (0, pthread_create (&threads[i], 0, writer_thread, (void*) (intptr_t) i));
+	}
+
+	/* every item arrives exactly once, in the order of its writer */
+	vector<guint> next (n_writers, 0);
+	guint received = 0;
+
+	while (received < n_writers * n_items) {
+		const guint n = stress_queue->read_space ();
+		if (n == 0) {
+			g_thread_yield ();
+			continue;
+		}
+		for (guint i = 0; i < n; ++i) {
+			Item const & it (stress_queue->read_peek (i));
+			CPPUNIT_ASSERT (it.writer < n_writers);
+			CPPUNIT_ASSERT_EQUAL (next[it.writer], it.seq);
+			++next[it.writer];
+		}
+		stress_queue->read_release (n);
+		received += n;
+	}
+
+	for (guint i = 0; i < n_writers; ++i) {
+		pthread_join (threads[i], 0);
+		CPPUNIT_ASSERT_EQUAL (n_items, next[i]);
+	}
+
+	CPPUNIT_ASSERT (stress_queue->empty ());
+	CPPUNIT_ASSERT_EQUAL ((guint) 0, stress_queue->read_space ());
+
+	delete stress_queue;
+}
@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MPSCQueueTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (MPSCQueueTest);
+	CPPUNIT_TEST (testBasic);
+	CPPUNIT_TEST (testStress);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testBasic ();
+	void testStress ();
+};
@@ -0,0 +1,174 @@
+#include <cstdlib>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "rt_monitor_test.h"
+#include "pbd/rt_monitor.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (RTMonitorTest);
+
+using namespace std;
+using namespace PBD;
+
+void
+RTMonitorTest::tearDown ()
+{
+	RTMonitor::unregister_thread ();
+	RTMonitor::set_enabled (false);
+	RTMonitor::reset ();
+}
+
+void
+RTMonitorTest::testCounting ()
+{
+	RTMonitor::reset ();
+	RTMonitor::register_thread ("test");
+
+	/* nothing is counted while disabled */
+	RTMonitor::note_event (RTMonitor::LockWait);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, RTMonitor::event_count (RTMonitor::LockWait));
+
+	RTMonitor::set_enabled (true);
+	RTMonitor::note_event (RTMonitor::LockWait);
+	RTMonitor::note_event (RTMonitor::LockWait);
+	RTMonitor::note_event (RTMonitor::SystemCall);
+	RTMonitor::set_enabled (false);
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, RTMonitor::event_count (RTMonitor::LockWait));
+	CPPUNIT_ASSERT (RTMonitor::event_count (RTMonitor::SystemCall) >= 1);
+
+	RTMonitor::reset ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, RTMonitor::event_count (RTMonitor::LockWait));
+}
+
+static void*
+unmonitored_thread (void*)
+{
+	RTMonitor::note_event (RTMonitor::HeapAllocation);
+	return 0;
+}
+
+void
+RTMonitorTest::testUnmonitoredThread ()
+{
+	RTMonitor::reset ();
+	RTMonitor::register_thread ("test");
+	RTMonitor::set_enabled (true);
+
+	pthread_t t;
+	CPPUNIT_ASSERT (pthread_create (&t, 0, unmonitored_thread, 0) == 0);
+	pthread_join (t, 0);
+
+	RTMonitor::set_enabled (false);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, RTMonitor::event_count (RTMonitor::HeapAllocation));
+}
+
+void
+RTMonitorTest::testReport ()
+{
+	RTMonitor::reset ();
+	RTMonitor::register_thread ("report-test");
+	RTMonitor::set_enabled (true);
+	RTMonitor::note_event (RTMonitor::LockWait);
+	RTMonitor::set_enabled (false);
+
+	const string r = RTMonitor::report ();
+	CPPUNIT_ASSERT (r.find ("report-test") != string::npos);
+	CPPUNIT_ASSERT (r.find (RTMonitor::event_type_name (RTMonitor::LockWait)) != string::npos);
+}
+
+void
+RTMonitorTest::testInterposedMalloc ()
+{
+	if (!RTMonitor::available ()) {
+		return;
+	}
+
+	RTMonitor::reset ();
+	RTMonitor::register_thread ("malloc-test");
+	RTMonitor::set_enabled (true);
+	void* volatile p = malloc (64);
+	RTMonitor::set_enabled (false);
+	free (p);
+
+	CPPUNIT_ASSERT (RTMonitor::event_count (RTMonitor::HeapAllocation) >= 1);
+
+	/* every allocator entry point is covered */
+	RTMonitor::reset ();
+	RTMonitor::set_enabled (true);
+	p = calloc (4, 16);
+	RTMonitor::set_enabled (false);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, RTMonitor::event_count (RTMonitor::HeapAllocation));
+
+	RTMonitor::set_enabled (true);
+	p = realloc (p, 4096);
+	RTMonitor::set_enabled (false);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, RTMonitor::event_count (RTMonitor::HeapAllocation));
+	free (p);
+
+	void* a = 0;
+	RTMonitor::set_enabled (true);
+	CPPUNIT_ASSERT (posix_memalign (&a, 64, 256) == 0);
+	RTMonitor::set_enabled (false);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 3, RTMonitor::event_count (RTMonitor::HeapAllocation));
+	CPPUNIT_ASSERT (((uintptr_t) a & 63) == 0);
+	free (a);
+
+	/* the same allocation from an unregistered thread is not counted */
+	RTMonitor::unregister_thread ();
+	RTMonitor::reset ();
+	RTMonitor::set_enabled (true);
+	p = malloc (64);
+	RTMonitor::set_enabled (false);
+	free (p);
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, RTMonitor::event_count (RTMonitor::HeapAllocation));
+}
+
+static pthread_mutex_t contended = PTHREAD_MUTEX_INITIALIZER;
+static gint            contended_held = 0;
+
+static void*
+lock_holder (void*)
+{
+	pthread_mutex_lock (&contended);
+	g_atomic_int_set (&contended_held, 1);
+	g_usleep (20000);
+	pthread_mutex_unlock (&contended);
+	return 0;
+}
+
+void
+RTMonitorTest::testInterposedLock ()
+{
+	if (!RTMonitor::available ()) {
+		return;
+	}
+
+	RTMonitor::reset ();
+	RTMonitor::register_thread ("lock-test");
+
+	/* uncontended: the trylock succeeds, nothing is counted */
+	RTMonitor::set_enabled (true);
+	pthread_mutex_lock (&contended);
+	pthread_mutex_unlock (&contended);
+	RTMonitor::set_enabled (false);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, RTMonitor::event_count (RTMonitor::LockWait));
+
+	g_atomic_int_set (&contended_held, 0);
+	pthread_t t;
+	CPPUNIT_ASSERT (pthread_create (&t, 0, lock_holder, 0) == 0);
+	while (!g_atomic_int_get (&contended_held)) {
+		g_usleep (100);
+	}
+
+	RTMonitor::set_enabled (true);
+	pthread_mutex_lock (&contended);
+	RTMonitor::set_enabled (false);
+	pthread_mutex_unlock (&contended);
+	pthread_join (t, 0);
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, RTMonitor::event_count (RTMonitor::LockWait));
+}
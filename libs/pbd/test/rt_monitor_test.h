@@ -0,0 +1,22 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RTMonitorTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (RTMonitorTest);
+	CPPUNIT_TEST (testCounting);
+	CPPUNIT_TEST (testUnmonitoredThread);
+	CPPUNIT_TEST (testReport);
+	CPPUNIT_TEST (testInterposedMalloc);
+	CPPUNIT_TEST (testInterposedLock);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void tearDown ();
+
+	void testCounting ();
+	void testUnmonitoredThread ();
+	void testReport ();
+	void testInterposedMalloc ();
+	void testInterposedLock ();
+};